@@ -23,6 +23,12 @@ public partial struct ConnectionAcceptedPacket
 
     [ContractField("byte[]", 16)]
     public byte[] Salt;
+
+    [ContractField("uint")]
+    public uint DictionaryId;
+
+    [ContractField("byte")]
+    public byte Options;
 }
 
 [Contract("ConnectionDenied", PacketLayerType.Server, ContractPacketFlags.ToEntity, PacketType.ConnectionDenied)]
@@ -245,7 +245,7 @@ namespace Core.Config
             Console.WriteLine("[CONFIG] === SERVER CONFIGURATION SUMMARY ===");
             Console.WriteLine($"[CONFIG] 🌐 Network: Port {config.Network.Port}, MTU {config.Network.MaxPacketSize} bytes");
             Console.WriteLine($"[CONFIG] 🔐 Security: Encryption={config.Security.EnableEndToEndEncryption}, Password={!string.IsNullOrEmpty(config.Server.Password)}");
-            Console.WriteLine($"[CONFIG] 📦 Compression: LZ4={config.Network.EnableLZ4Compression}");
+            Console.WriteLine($"[CONFIG] 📦 Compression: LZ4={config.Network.EnableLZ4Compression}, Dictionary={(string.IsNullOrEmpty(config.Network.CompressionDictionaryPath) ? "none" : config.Network.CompressionDictionaryPath)}, Stream={config.Network.EnableStreamCompression}");
             Console.WriteLine($"[CONFIG] 💓 Heartbeat: Enabled={config.Security.EnableHeartbeat}, Interval={config.Security.HeartbeatIntervalMs}ms");
             Console.WriteLine($"[CONFIG] ⚡ Performance: TickRate={config.Performance.TickRate}Hz, BundleTimeout={config.Performance.BundleTimeoutMs}ms");
             Console.WriteLine($"[CONFIG] 👥 Server: MaxPlayers={config.Server.MaxPlayers}, Name='{config.Server.Name}'");
@@ -274,6 +274,33 @@ namespace Core.Config
         [JsonPropertyName("compressionThreshold")]
         public int CompressionThreshold { get; set; } = 512;
 
+        [JsonPropertyName("compressionAcceleration")]
+        public int CompressionAcceleration { get; set; } = 1;
+
+        [JsonPropertyName("highCompressionThreshold")]
+        public int HighCompressionThreshold { get; set; } = 1024;
+
+        [JsonPropertyName("compressionDictionaryPath")]
+        public string CompressionDictionaryPath { get; set; } = "";
+
+        [JsonPropertyName("enableStreamCompression")]
+        public bool EnableStreamCompression { get; set; } = true;
+
+        [JsonPropertyName("omitAeadChecksum")]
+        public bool OmitAeadChecksum { get; set; } = false;
+
+        [JsonPropertyName("enableAesGcm")]
+        public bool EnableAesGcm { get; set; } = true; // Granted only when the CPU has AES instructions
+
+        [JsonPropertyName("sessionTicketLifetime")]
+        public int SessionTicketLifetime { get; set; } = 3600; // Seconds, 0 disables resumption
+
+        [JsonPropertyName("enableConnectionMigration")]
+        public bool EnableConnectionMigration { get; set; } = true;
+
+        [JsonPropertyName("captureTrafficPath")]
+        public string CaptureTrafficPath { get; set; } = "";
+
         [JsonPropertyName("receiveBufferSize")]
         public int ReceiveBufferSize { get; set; } = 524288; // 512KB
 
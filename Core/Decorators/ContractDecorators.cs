@@ -58,6 +58,7 @@ public class ContractAttribute : Attribute
     public PacketLayerType LayerType { get; set; } = PacketLayerType.Server;
     public ContractPacketFlags Flags { get; set; } = ContractPacketFlags.None;
     public PacketType PacketType { get; set; } = PacketType.None;
+    public ReliableStream Stream { get; set; } = ReliableStream.Default;
 
     public ContractAttribute(
         string name,
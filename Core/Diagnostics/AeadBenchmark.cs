@@ -0,0 +1,268 @@
+/*
+ * AEAD Benchmark
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using System.Security.Cryptography;
+
+/// <summary>
+/// Per-packet seal and open cost of each AEAD suite at the sizes game traffic runs at. The server's
+/// suites are timed through SecureSession, the calls its send and receive paths make; the client's
+/// libsodium suites, AEGIS included, through the native library when it can be loaded. Where both
+/// sides implement a suite their packets have to agree byte for byte before anything is timed.
+/// </summary>
+public static unsafe class AeadBenchmark
+{
+    private static readonly string[] SodiumLibraryNames =
+    {
+        "libsodium.so.26", "libsodium.so.23", "libsodium.so", "libsodium.26.dylib", "libsodium.23.dylib", "libsodium.dylib", "libsodium.dll"
+    };
+
+    private static readonly int[] PayloadSizes = { 30, 64, 128, 200 };
+
+    private sealed class Suite
+    {
+        public string Name;
+        public bool IsAesGcm;
+        public int KeySize = 32;
+        public int NonceSize = 12;
+        public int TagSize = SecureSession.TagSize;
+        public IntPtr Encrypt; // crypto_aead_*_encrypt, zero for the SecureSession suites
+        public IntPtr Decrypt;
+        public Suite Reference; // Server suite whose packets these must match
+    }
+
+    public static void Run(double secondsPerRun = 0.25)
+    {
+        var suites = new List<Suite> { new Suite { Name = "ChaCha20-Poly1305" } };
+
+        if (AesGcm.IsSupported)
+            suites.Add(new Suite { Name = "AES-256-GCM", IsAesGcm = true });
+
+        Console.WriteLine(SecureSession.AesGcmAccelerated
+            ? "[AEAD] AES instructions present, AES-256-GCM is granted to clients that offer it"
+            : "[AEAD] No AES instructions, sessions stay on ChaCha20-Poly1305");
+
+        if (!LoadSodium(suites))
+            Console.WriteLine("[AEAD] libsodium not found, timing the server suites only");
+
+        // A suite that cannot open its own packets, or disagrees with its counterpart, is not worth timing
+        foreach (var suite in suites.ToList())
+        {
+            if (!Verify(suite))
+            {
+                Console.WriteLine($"[AEAD] {suite.Name} round trip mismatch, skipped");
+                suites.Remove(suite);
+            }
+        }
+
+        foreach (int size in PayloadSizes)
+        {
+            foreach (var suite in suites)
+                Report(suite, size, secondsPerRun);
+        }
+    }
+
+    private static bool LoadSodium(List<Suite> suites)
+    {
+        foreach (var name in SodiumLibraryNames)
+        {
+            if (!NativeLibrary.TryLoad(name, out var handle))
+                continue;
+
+            if (!NativeLibrary.TryGetExport(handle, "sodium_init", out var init) || ((delegate* unmanaged<int>)init)() < 0)
+                continue;
+
+            var chacha = suites[0];
+            var aesGcm = suites.Find(s => s.IsAesGcm);
+
+            AddSodiumSuite(suites, handle, "chacha20poly1305_ietf", "libsodium ChaCha20-Poly1305", chacha);
+
+            // Only usable on CPUs with AES-NI and PCLMUL, the same test the client makes before offering it
+            if (NativeLibrary.TryGetExport(handle, "crypto_aead_aes256gcm_is_available", out var available) &&
+                ((delegate* unmanaged<int>)available)() != 0)
+                AddSodiumSuite(suites, handle, "aes256gcm", "libsodium AES-256-GCM", aesGcm);
+
+            AddSodiumSuite(suites, handle, "aegis128l", "libsodium AEGIS-128L", null);
+            AddSodiumSuite(suites, handle, "aegis256", "libsodium AEGIS-256", null);
+            return true;
+        }
+
+        return false;
+    }
+
+    private static void AddSodiumSuite(List<Suite> suites, IntPtr handle, string suiteName, string name, Suite reference)
+    {
+        string prefix = "crypto_aead_" + suiteName;
+
+        if (!NativeLibrary.TryGetExport(handle, prefix + "_encrypt", out var encrypt) ||
+            !NativeLibrary.TryGetExport(handle, prefix + "_decrypt", out var decrypt) ||
+            !NativeLibrary.TryGetExport(handle, prefix + "_keybytes", out var keyBytes) ||
+            !NativeLibrary.TryGetExport(handle, prefix + "_npubbytes", out var nonceBytes) ||
+            !NativeLibrary.TryGetExport(handle, prefix + "_abytes", out var tagBytes))
+        {
+            Console.WriteLine($"[AEAD] {name} not in this libsodium");
+            return;
+        }
+
+        suites.Add(new Suite
+        {
+            Name = name,
+            KeySize = (int)((delegate* unmanaged<nuint>)keyBytes)(),
+            NonceSize = (int)((delegate* unmanaged<nuint>)nonceBytes)(),
+            TagSize = (int)((delegate* unmanaged<nuint>)tagBytes)(),
+            Encrypt = encrypt,
+            Decrypt = decrypt,
+            Reference = reference
+        });
+    }
+
+    // Keyed once up front, the way a session keeps its own
+    private static AesGcm CreateAesGcm(Suite suite, byte[] key)
+    {
+        return suite.IsAesGcm ? new AesGcm(key, SecureSession.TagSize) : null;
+    }
+
+    private static int Seal(Suite suite, AesGcm aesGcm, byte[] key, byte[] nonce, byte[] plaintext, int length, byte[] aad, byte[] ciphertext)
+    {
+        if (suite.Encrypt == IntPtr.Zero)
+            return SecureSession.Seal(aesGcm, key, nonce, plaintext.AsSpan(0, length), aad, ciphertext);
+
+        ulong ciphertextLength = 0;
+
+        fixed (byte* c = ciphertext, m = plaintext, ad = aad, npub = nonce, k = key)
+        {
+            var encrypt = (delegate* unmanaged<byte*, ulong*, byte*, ulong, byte*, ulong, byte*, byte*, byte*, int>)suite.Encrypt;
+            return encrypt(c, &ciphertextLength, m, (ulong)length, ad, (ulong)aad.Length, null, npub, k) == 0 ? (int)ciphertextLength : -1;
+        }
+    }
+
+    private static int Open(Suite suite, AesGcm aesGcm, byte[] key, byte[] nonce, byte[] ciphertext, int length, byte[] aad, byte[] plaintext)
+    {
+        if (suite.Decrypt == IntPtr.Zero)
+        {
+            try
+            {
+                return SecureSession.Open(aesGcm, key, nonce, ciphertext.AsSpan(0, length), aad, plaintext);
+            }
+            catch
+            {
+                return -1;
+            }
+        }
+
+        ulong plaintextLength = 0;
+
+        fixed (byte* m = plaintext, c = ciphertext, ad = aad, npub = nonce, k = key)
+        {
+            var decrypt = (delegate* unmanaged<byte*, ulong*, byte*, byte*, ulong, byte*, ulong, byte*, byte*, int>)suite.Decrypt;
+            return decrypt(m, &plaintextLength, null, c, (ulong)length, ad, (ulong)aad.Length, npub, k) == 0 ? (int)plaintextLength : -1;
+        }
+    }
+
+    private static bool Verify(Suite suite)
+    {
+        byte[] aad = RandomNumberGenerator.GetBytes(PacketHeader.Size);
+        byte[] key = RandomNumberGenerator.GetBytes(suite.KeySize);
+        byte[] nonce = RandomNumberGenerator.GetBytes(suite.NonceSize);
+        var aesGcm = CreateAesGcm(suite, key);
+        var referenceAesGcm = suite.Reference != null ? CreateAesGcm(suite.Reference, key) : null;
+
+        foreach (int size in PayloadSizes)
+        {
+            byte[] plaintext = RandomNumberGenerator.GetBytes(size);
+            byte[] ciphertext = new byte[size + suite.TagSize];
+            byte[] opened = new byte[size];
+
+            int sealedLength = Seal(suite, aesGcm, key, nonce, plaintext, size, aad, ciphertext);
+
+            if (sealedLength != size + suite.TagSize || Open(suite, aesGcm, key, nonce, ciphertext, sealedLength, aad, opened) != size ||
+                !opened.AsSpan().SequenceEqual(plaintext))
+                return false;
+
+            // A flipped bit has to be caught by the tag
+            ciphertext[size / 2] ^= 0x01;
+
+            if (Open(suite, aesGcm, key, nonce, ciphertext, sealedLength, aad, opened) >= 0)
+                return false;
+
+            ciphertext[size / 2] ^= 0x01;
+
+            if (suite.Reference != null)
+            {
+                byte[] reference = new byte[size + SecureSession.TagSize];
+
+                if (Seal(suite.Reference, referenceAesGcm, key, nonce, plaintext, size, aad, reference) != sealedLength ||
+                    !reference.AsSpan().SequenceEqual(ciphertext.AsSpan(0, sealedLength)))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    private static void Report(Suite suite, int size, double seconds)
+    {
+        byte[] aad = RandomNumberGenerator.GetBytes(PacketHeader.Size);
+        byte[] key = RandomNumberGenerator.GetBytes(suite.KeySize);
+        byte[] nonce = RandomNumberGenerator.GetBytes(suite.NonceSize);
+        byte[] plaintext = RandomNumberGenerator.GetBytes(size);
+        byte[] ciphertext = new byte[size + suite.TagSize];
+        byte[] opened = new byte[size];
+        var aesGcm = CreateAesGcm(suite, key);
+
+        int sealedLength = Seal(suite, aesGcm, key, nonce, plaintext, size, aad, ciphertext);
+
+        double seal = Time(() => Seal(suite, aesGcm, key, nonce, plaintext, size, aad, ciphertext), seconds);
+        double open = Time(() => Open(suite, aesGcm, key, nonce, ciphertext, sealedLength, aad, opened), seconds);
+
+        Console.WriteLine($"[AEAD] {suite.Name,-28} {size,4} B  seal {seal,7:F0} ns  open {open,7:F0} ns  (+{suite.TagSize} B tag)");
+    }
+
+    // Nanoseconds per call; an untimed run of the same length first, so tiered compilation has settled
+    private static double Time(Func<int> packet, double seconds)
+    {
+        const int Batch = 256;
+        var stopwatch = Stopwatch.StartNew();
+
+        while (stopwatch.Elapsed.TotalSeconds < seconds)
+        {
+            for (int i = 0; i < Batch; i++)
+                packet();
+        }
+
+        long packets = 0;
+        stopwatch.Restart();
+
+        while (stopwatch.Elapsed.TotalSeconds < seconds)
+        {
+            for (int i = 0; i < Batch; i++)
+                packet();
+
+            packets += Batch;
+        }
+
+        stopwatch.Stop();
+        return stopwatch.Elapsed.TotalMilliseconds * 1e6 / packets;
+    }
+}
@@ -0,0 +1,250 @@
+/*
+ * LZ4 Benchmark
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+
+/// <summary>
+/// Codec throughput on recorded traffic (a PacketCapture file), against the reference liblz4
+/// when the native library can be loaded. Packets are coded one by one, or concatenated into
+/// blocks of the given size to see the codec on larger reliable payloads. Compression is timed
+/// at each level with a reused state, the way the sessions run it.
+/// </summary>
+public static unsafe class LZ4Benchmark
+{
+    private static readonly string[] ReferenceLibraryNames =
+    {
+        "liblz4.so.1", "liblz4.so", "liblz4.1.dylib", "liblz4.dylib", "liblz4.dll", "lz4.dll"
+    };
+
+    private static readonly (string Name, LZ4Level Level)[] Levels =
+    {
+        ("LZ4 Fast", LZ4Level.Fast()),
+        ("LZ4 Fast(4)", LZ4Level.Fast(4)),
+        ("LZ4 High", LZ4Level.High())
+    };
+
+    private static delegate* unmanaged<byte*, byte*, int, int, int> _referenceCompress;
+    private static delegate* unmanaged<byte*, byte*, int, int, int> _referenceDecompress;
+
+    public static void Run(string capturePath, int blockSize, double secondsPerRun = 1.0)
+    {
+        var blocks = BuildBlocks(PacketCapture.Load(capturePath), blockSize);
+
+        if (blocks.Count == 0)
+        {
+            Console.WriteLine($"[LZ4] No packets in {capturePath}");
+            return;
+        }
+
+        bool hasReference = LoadReference();
+        var ours = blocks.Select(Compress).ToList();
+        var reference = hasReference ? blocks.Select(CompressReference).ToList() : null;
+        long raw = blocks.Sum(b => (long)b.Length);
+
+        Console.WriteLine($"[LZ4] {blocks.Count} blocks, {raw} bytes raw, {ours.Sum(c => (long)c.Length)} compressed" +
+            (hasReference ? $", {reference.Sum(c => (long)c.Length)} with liblz4" : ", liblz4 not found"));
+
+        // Every decoder has to agree with every encoder before any timing means anything
+        if (!Verify(blocks, ours, false) ||
+            (hasReference && (!Verify(blocks, ours, true) || !Verify(blocks, reference, false) || !Verify(blocks, reference, true))))
+        {
+            Console.WriteLine("[LZ4] Round trip mismatch, aborting");
+            return;
+        }
+
+        Report("LZ4", blocks, ours, false, secondsPerRun);
+
+        if (hasReference)
+        {
+            Report("LZ4 on liblz4 blocks", blocks, reference, false, secondsPerRun);
+            Report("liblz4 on liblz4 blocks", blocks, reference, true, secondsPerRun);
+        }
+
+        var state = new LZ4CompressState();
+
+        foreach (var (name, level) in Levels)
+            ReportCompression(name, blocks, level, state, false, secondsPerRun);
+
+        if (hasReference)
+            ReportCompression("liblz4", blocks, default, null, true, secondsPerRun);
+    }
+
+    private static List<byte[]> BuildBlocks(List<byte[]> packets, int blockSize)
+    {
+        if (blockSize <= 0)
+            return packets.Where(p => p.Length > 0).ToList();
+
+        var blocks = new List<byte[]>();
+        var current = new List<byte>(blockSize);
+
+        foreach (var packet in packets)
+        {
+            current.AddRange(packet);
+
+            if (current.Count >= blockSize)
+            {
+                blocks.Add(current.ToArray());
+                current.Clear();
+            }
+        }
+
+        if (current.Count > 0)
+            blocks.Add(current.ToArray());
+
+        return blocks;
+    }
+
+    private static bool LoadReference()
+    {
+        if (_referenceDecompress != null)
+            return true;
+
+        foreach (var name in ReferenceLibraryNames)
+        {
+            if (!NativeLibrary.TryLoad(name, out var handle))
+                continue;
+
+            if (NativeLibrary.TryGetExport(handle, "LZ4_compress_default", out var compress) &&
+                NativeLibrary.TryGetExport(handle, "LZ4_decompress_safe", out var decompress))
+            {
+                _referenceCompress = (delegate* unmanaged<byte*, byte*, int, int, int>)compress;
+                _referenceDecompress = (delegate* unmanaged<byte*, byte*, int, int, int>)decompress;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    private static byte[] Compress(byte[] block)
+    {
+        byte[] output = new byte[block.Length + block.Length / 255 + 16];
+
+        fixed (byte* src = block, dst = output)
+            return output.AsSpan(0, LZ4.Compress(src, block.Length, dst, output.Length)).ToArray();
+    }
+
+    private static byte[] CompressReference(byte[] block)
+    {
+        byte[] output = new byte[block.Length + block.Length / 255 + 16];
+
+        fixed (byte* src = block, dst = output)
+            return output.AsSpan(0, _referenceCompress(src, dst, block.Length, output.Length)).ToArray();
+    }
+
+    private static int CompressInto(byte[] block, byte[] output, LZ4Level level, LZ4CompressState state, bool useReference)
+    {
+        fixed (byte* src = block, dst = output)
+        {
+            return useReference
+                ? _referenceCompress(src, dst, block.Length, output.Length)
+                : LZ4.Compress(src, block.Length, dst, output.Length, state, level);
+        }
+    }
+
+    private static int Decompress(byte[] compressed, byte[] output, int length, bool useReference)
+    {
+        fixed (byte* src = compressed, dst = output)
+        {
+            return useReference
+                ? _referenceDecompress(src, dst, compressed.Length, length)
+                : LZ4.Decompress(src, compressed.Length, dst, length);
+        }
+    }
+
+    private static bool Verify(List<byte[]> blocks, List<byte[]> compressed, bool useReference)
+    {
+        byte[] output = new byte[blocks.Max(b => b.Length)];
+
+        for (int i = 0; i < blocks.Count; i++)
+        {
+            int length = Decompress(compressed[i], output, blocks[i].Length, useReference);
+
+            if (length != blocks[i].Length || !output.AsSpan(0, length).SequenceEqual(blocks[i]))
+                return false;
+        }
+
+        return true;
+    }
+
+    private static void Report(string name, List<byte[]> blocks, List<byte[]> compressed, bool useReference, double seconds)
+    {
+        byte[] output = new byte[blocks.Max(b => b.Length)];
+
+        // Untimed warm-up, long enough for tiered compilation to promote the decoder
+        var stopwatch = Stopwatch.StartNew();
+
+        while (stopwatch.Elapsed.TotalSeconds < seconds)
+        {
+            for (int i = 0; i < blocks.Count; i++)
+                Decompress(compressed[i], output, blocks[i].Length, useReference);
+        }
+
+        long bytes = 0;
+        stopwatch.Restart();
+
+        while (stopwatch.Elapsed.TotalSeconds < seconds)
+        {
+            for (int i = 0; i < blocks.Count; i++)
+                bytes += Decompress(compressed[i], output, blocks[i].Length, useReference);
+        }
+
+        stopwatch.Stop();
+        Console.WriteLine($"[LZ4] {name,-24} {bytes / stopwatch.Elapsed.TotalSeconds / 1e9:F2} GB/s decoded");
+    }
+    private static void ReportCompression(string name, List<byte[]> blocks, LZ4Level level, LZ4CompressState state, bool useReference, double seconds)
+    {
+        int largest = blocks.Max(b => b.Length);
+        byte[] output = new byte[largest + largest / 255 + 16];
+        long compressed = 0;
+
+        // The untimed pass doubles as warm-up and gives the ratio
+        var stopwatch = Stopwatch.StartNew();
+
+        while (stopwatch.Elapsed.TotalSeconds < seconds)
+        {
+            compressed = 0;
+
+            for (int i = 0; i < blocks.Count; i++)
+                compressed += CompressInto(blocks[i], output, level, state, useReference);
+        }
+
+        long bytes = 0;
+        stopwatch.Restart();
+
+        while (stopwatch.Elapsed.TotalSeconds < seconds)
+        {
+            for (int i = 0; i < blocks.Count; i++)
+            {
+                CompressInto(blocks[i], output, level, state, useReference);
+                bytes += blocks[i].Length;
+            }
+        }
+
+        stopwatch.Stop();
+
+        double ratio = (double)compressed / blocks.Sum(b => (long)b.Length);
+        Console.WriteLine($"[LZ4] {name,-24} {bytes / stopwatch.Elapsed.TotalSeconds / 1e9:F2} GB/s compressed, ratio {ratio:F3}");
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * PacketCapture
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+using System.Buffers.Binary;
+
+/// <summary>
+/// Records decrypted plaintexts, exactly what the compressor sees, as length prefixed
+/// records ([u16 length][bytes]) for offline dictionary training.
+/// </summary>
+public static class PacketCapture
+{
+    private static readonly object _lock = new object();
+    private static FileStream _stream;
+
+    public static bool IsEnabled => _stream != null;
+
+    public static void Start(string path)
+    {
+        lock (_lock)
+        {
+            _stream?.Dispose();
+            _stream = new FileStream(path, FileMode.Create, FileAccess.Write, FileShare.Read);
+        }
+    }
+
+    public static void Stop()
+    {
+        lock (_lock)
+        {
+            _stream?.Dispose();
+            _stream = null;
+        }
+    }
+
+    public static void Record(ReadOnlySpan<byte> plaintext)
+    {
+        if (_stream == null || plaintext.Length > ushort.MaxValue)
+            return;
+
+        Span<byte> length = stackalloc byte[sizeof(ushort)];
+        BinaryPrimitives.WriteUInt16LittleEndian(length, (ushort)plaintext.Length);
+
+        lock (_lock)
+        {
+            if (_stream == null)
+                return;
+
+            _stream.Write(length);
+            _stream.Write(plaintext);
+        }
+    }
+
+    public static List<byte[]> Load(string path)
+    {
+        var samples = new List<byte[]>();
+        byte[] data = File.ReadAllBytes(path);
+        int offset = 0;
+
+        while (offset + sizeof(ushort) <= data.Length)
+        {
+            int length = BinaryPrimitives.ReadUInt16LittleEndian(data.AsSpan(offset));
+            offset += sizeof(ushort);
+
+            if (offset + length > data.Length)
+                break;
+
+            samples.Add(data.AsSpan(offset, length).ToArray());
+            offset += length;
+        }
+
+        return samples;
+    }
+}
@@ -117,6 +117,8 @@ public static class ServerMonitor
         table.AddRow("Packets Tx/Rx", $"{packetsSent} / {packetsReceived}");
         table.AddRow("Traffic Tx/Rx", $"{bytesSent / 1024} KB / {bytesReceived / 1024} KB");
         table.AddRow("Tick Rate", tickRate.ToString());
+        table.AddRow("Rejects Size/CRC/Replay/AEAD",
+            $"{UDPServer.MalformedRejects} / {UDPServer.ChecksumRejects} / {UDPServer.ReplayRejects} / {UDPServer.DecryptRejects}");
         table.AddRow("Memory (Managed/Private)", $"{managed / (1024 * 1024)} MB / {privateBytes / (1024 * 1024)} MB");
         table.AddRow("GC Collections", $"{GC.CollectionCount(0)} / {GC.CollectionCount(1)} / {GC.CollectionCount(2)}");
     }
@@ -14,11 +14,33 @@ public enum PacketHeaderFlags : byte
     None = 0,
     Encrypted = 1 << 0,
     AEAD_ChaCha20Poly1305 = 1 << 1,
-    Rekey = 1 << 2,
+    AEAD_AES256GCM = 1 << 2,
     Fragment = 1 << 3,
     Compressed = 1 << 4,
     Acknowledgment = 1 << 5,
-    ReliableHandshake = 1 << 6
+    ReliableHandshake = 1 << 6,
+    StreamCompressed = 1 << 7
+}
+
+// Negotiated in the handshake: the client offers them on Connect, ConnectionAccepted echoes the ones granted
+[Flags]
+public enum SessionOptions : byte
+{
+    None = 0,
+    NoChecksum = 1 << 0, // AEAD packets drop their CRC32C trailer, the tag already authenticates them
+    Resumed = 1 << 1, // Offered on Resume; granted when the ticket redeemed and the keys come from it
+    AES256GCM = 1 << 2 // Packets are sealed with AES-256-GCM, offered and granted only where both ends run AES in hardware
+}
+
+public static class PacketHeaderFlagsUtils
+{
+    // The AEAD bits name the suite the payload is sealed with, the one the session negotiated
+    public const PacketHeaderFlags AeadMask = PacketHeaderFlags.AEAD_ChaCha20Poly1305 | PacketHeaderFlags.AEAD_AES256GCM;
+
+    public static PacketHeaderFlags GetAead(this PacketHeaderFlags flags)
+    {
+        return flags & AeadMask;
+    }
 }
 
 public enum PacketChannel : byte
@@ -28,6 +50,29 @@ public enum PacketChannel : byte
     ReliableUnordered = 2
 }
 
+public static class PacketChannelUtils
+{
+    // The channel byte carries the channel kind in its low nibble and, on the reliable
+    // channels, the reliable stream the message is ordered on in its high nibble
+    public const byte KindMask = 0x0F;
+    public const int StreamShift = 4;
+
+    public static PacketChannel GetKind(this PacketChannel channel)
+    {
+        return (PacketChannel)((byte)channel & KindMask);
+    }
+
+    public static ReliableStream GetStream(this PacketChannel channel)
+    {
+        return (ReliableStream)((byte)channel >> StreamShift);
+    }
+
+    public static PacketChannel WithStream(this PacketChannel channel, ReliableStream stream)
+    {
+        return (PacketChannel)((byte)channel | ((byte)stream << StreamShift));
+    }
+}
+
 [StructLayout(LayoutKind.Sequential, Pack = 1)]
 public unsafe struct PacketHeader
 {
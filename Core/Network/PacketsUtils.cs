@@ -3,6 +3,7 @@ public static partial class PacketRegistration { }
 public interface INetworkPacket
 {
     int Size { get; }
+    ReliableStream Stream => ReliableStream.Default;
     void Serialize(ref FlatBuffer buffer);
     //void Deserialize(ref FlatBuffer buffer);
 }
@@ -19,6 +20,16 @@ public enum PacketLayerType
     Client
 }
 
+// Independently ordered reliable streams, a message lost on one never holds back delivery on another.
+// Values must match EReliableStream on the client.
+public enum ReliableStream : byte
+{
+    Default,
+    World,
+    Chat,
+    Inventory
+}
+
 public enum PacketType : byte
 {
     Connect,
@@ -38,6 +49,11 @@ public enum PacketType : byte
     CryptoTest,
     CryptoTestAck,
     ReliableHandshake,
+    Batch,
+    SessionTicket,
+    Resume,
+    PathChallenge,
+    PathResponse,
     None = 255
 }
 
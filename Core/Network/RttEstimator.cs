@@ -0,0 +1,106 @@
+/*
+* RttEstimator
+*
+* Author: Andre Ferreira
+*
+* Copyright (c) Uzmi Games. Licensed under the MIT License.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+/// <summary>
+/// Smoothed round-trip estimate for one connection (RFC 6298). Samples come from reliable
+/// ACK timing and the Ping/Pong exchange; retransmitted packets are never sampled (Karn).
+/// </summary>
+public sealed class RttEstimator
+{
+    public const double Alpha = 0.125;
+    public const double Beta = 0.25;
+    public const double ClockGranularityMs = 1.0;
+    public const double MinTimeoutMs = 30.0;
+    public const double MaxTimeoutMs = 5000.0;
+
+    private readonly object _lock = new object();
+    private double _smoothedRtt;
+    private double _rttVariance;
+    private double _latestRtt;
+    private double _timeout;
+    private bool _hasSample;
+
+    public RttEstimator(double initialTimeoutMs)
+    {
+        Reset(initialTimeoutMs);
+    }
+
+    public double SmoothedRttMs { get { lock (_lock) return _smoothedRtt; } }
+
+    public double RttVarianceMs { get { lock (_lock) return _rttVariance; } }
+
+    public double LatestRttMs { get { lock (_lock) return _latestRtt; } }
+
+    public double TimeoutMs { get { lock (_lock) return _timeout; } }
+
+    public bool HasSample { get { lock (_lock) return _hasSample; } }
+
+    public void Reset(double initialTimeoutMs)
+    {
+        lock (_lock)
+        {
+            _smoothedRtt = 0;
+            _rttVariance = 0;
+            _latestRtt = 0;
+            _timeout = Math.Clamp(initialTimeoutMs, MinTimeoutMs, MaxTimeoutMs);
+            _hasSample = false;
+        }
+    }
+
+    public void AddSample(double rttMs)
+    {
+        if (rttMs < 0)
+            return;
+
+        lock (_lock)
+        {
+            _latestRtt = rttMs;
+
+            if (!_hasSample)
+            {
+                _smoothedRtt = rttMs;
+                _rttVariance = rttMs / 2;
+                _hasSample = true;
+            }
+            else
+            {
+                _rttVariance = (1 - Beta) * _rttVariance + Beta * Math.Abs(_smoothedRtt - rttMs);
+                _smoothedRtt = (1 - Alpha) * _smoothedRtt + Alpha * rttMs;
+            }
+
+            double timeout = _smoothedRtt + Math.Max(ClockGranularityMs, 4 * _rttVariance);
+            _timeout = Math.Clamp(timeout, MinTimeoutMs, MaxTimeoutMs);
+        }
+    }
+
+    /// <summary>
+    /// Timeout for a packet already resent retryCount times, doubled per retry.
+    /// </summary>
+    public double GetRetransmitTimeoutMs(int retryCount)
+    {
+        double timeout = TimeoutMs;
+        int shift = Math.Clamp(retryCount, 0, 16);
+
+        return Math.Min(timeout * (1 << shift), MaxTimeoutMs);
+    }
+}
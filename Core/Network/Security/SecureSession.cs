@@ -7,10 +7,16 @@ using Org.BouncyCastle.Crypto.Digests;
 using Org.BouncyCastle.Security;
 using Org.BouncyCastle.Crypto.Modes;
 using Org.BouncyCastle.Crypto.Macs;
+using AesGcm = System.Security.Cryptography.AesGcm;
 
 public unsafe struct SecureSession
 {
     private static readonly byte[] Info = System.Text.Encoding.ASCII.GetBytes("ToS-UE5 v1");
+    private static readonly byte[] ResumptionInfo = System.Text.Encoding.ASCII.GetBytes("ToS-UE5 v1 resumption");
+    private static readonly byte[] ResumeInfo = System.Text.Encoding.ASCII.GetBytes("ToS-UE5 v1 resume");
+
+    public const int ResumptionSecretSize = 32;
+    public const int ResumeNonceSize = 32;
 
     public fixed byte TxKey[32];
     public fixed byte RxKey[32];
@@ -48,6 +54,45 @@ public unsafe struct SecureSession
     public DateTime SessionStartTime;
 
     private const int ReplayWindowSize = 64;
+
+    // Compress-then-encrypt: plaintexts at or above the threshold are LZ4'd before sealing. A running
+    // ratio of compressed to original size stops the attempts once traffic proves incompressible,
+    // with an occasional probe so compressible traffic is picked up again.
+    public const int MaxDecompressedSize = 64 * 1024;
+    private const float IncompressibleRatio = 0.9f;
+    private const float CompressionRatioGain = 0.125f;
+    private const int CompressionProbeInterval = 32;
+
+    // A negotiated dictionary lets even small packets shrink, so the threshold drops with it
+    public const int DictionaryCompressionThreshold = 16;
+
+    public bool CompressionEnabled;
+    public int CompressionThreshold;
+    public float CompressionRatio;
+
+    // Packets run the fast LZ4 level at this acceleration; reliable payloads at or above the high
+    // compression threshold, rare and sent once, take the slower high level instead (0 turns it off)
+    public int CompressionAcceleration;
+    public int HighCompressionThreshold;
+    private int _compressionSkipped;
+    public uint DictionaryId; // Registered LZ4Dictionary agreed on in the handshake, 0 when none
+    public SessionOptions Options; // Granted in the handshake
+    public bool ChecksumEnabled => (Options & SessionOptions.NoChecksum) == 0;
+
+    // AES-256-GCM where both ends run AES in hardware, ChaCha20-Poly1305 everywhere else. Both take a 96-bit
+    // nonce and leave a 16-byte tag, so the wire layout is the same whichever suite the handshake settled on.
+    public const int TagSize = 16;
+    public bool AesGcmEnabled => (Options & SessionOptions.AES256GCM) != 0;
+    public PacketHeaderFlags AeadFlag => AesGcmEnabled ? PacketHeaderFlags.AEAD_AES256GCM : PacketHeaderFlags.AEAD_ChaCha20Poly1305;
+
+    // Keyed on first use and kept, setting up the GCM key costs about as much as sealing a small packet
+    private AesGcm _txAesGcm;
+    private AesGcm _rxAesGcm;
+
+    // Without AES instructions GCM runs table based, slower than ChaCha20 and not constant time
+    public static bool AesGcmAccelerated => AesGcm.IsSupported &&
+        (System.Runtime.Intrinsics.X86.Aes.IsSupported || System.Runtime.Intrinsics.Arm.Aes.IsSupported);
+
     private const ulong RekeyBytesThreshold = 1UL << 30; // 1 GB
     private static readonly TimeSpan RekeyTimeThreshold = TimeSpan.FromMinutes(60); // 1 hour
 
@@ -84,6 +129,7 @@ public unsafe struct SecureSession
         sess._highestSeqReceived = 0;
         sess.BytesTransmitted = 0;
         sess.SessionStartTime = DateTime.UtcNow;
+        sess.ConfigureCompression(true, 512);
 
         return (serverPub, salt, sess);
     }
@@ -113,9 +159,55 @@ public unsafe struct SecureSession
         sess._highestSeqReceived = 0;
         sess.BytesTransmitted = 0;
         sess.SessionStartTime = DateTime.UtcNow;
+        sess.ConfigureCompression(true, 512);
         return sess;
     }
 
+    // Resumption: both ends derive the same secret from the session keys, the server seals its copy into a
+    // ticket. Presenting the ticket with a fresh nonce keys a new session without another X25519 exchange.
+    // Derived from the server's side of the session, where RxKey is the client to server key.
+    public readonly void DeriveResumptionSecret(Span<byte> secret)
+    {
+        Span<byte> ikm = stackalloc byte[64];
+
+        fixed (byte* rxKeyPtr = RxKey)
+        fixed (byte* txKeyPtr = TxKey)
+        fixed (byte* saltPtr = SessionSalt)
+        {
+            new ReadOnlySpan<byte>(rxKeyPtr, 32).CopyTo(ikm);              // Client->Server
+            new ReadOnlySpan<byte>(txKeyPtr, 32).CopyTo(ikm.Slice(32));    // Server->Client
+
+            var hkdf = new HkdfBytesGenerator(new Sha256Digest());
+            hkdf.Init(new HkdfParameters(ikm.ToArray(), new ReadOnlySpan<byte>(saltPtr, 16).ToArray(), ResumptionInfo));
+            hkdf.GenerateBytes(secret.Slice(0, ResumptionSecretSize));
+        }
+    }
+
+    public static (byte[] salt, SecureSession session) CreateFromResumption(ReadOnlySpan<byte> resumptionSecret, ReadOnlySpan<byte> clientNonce, uint connectionId)
+    {
+        var salt = new byte[16];
+        new SecureRandom().NextBytes(salt);
+
+        var info = new byte[ResumeInfo.Length + ResumeNonceSize];
+        ResumeInfo.CopyTo(info, 0);
+        clientNonce.Slice(0, ResumeNonceSize).CopyTo(info.AsSpan(ResumeInfo.Length));
+
+        Span<byte> okm = stackalloc byte[64];
+        var hkdf = new HkdfBytesGenerator(new Sha256Digest());
+        hkdf.Init(new HkdfParameters(resumptionSecret.Slice(0, ResumptionSecretSize).ToArray(), salt, info));
+        hkdf.GenerateBytes(okm);
+
+        SecureSession sess = default;
+        okm.Slice(0, 32).CopyTo(new Span<byte>(sess.TxKey, 32));
+        okm.Slice(32, 32).CopyTo(new Span<byte>(sess.RxKey, 32));
+        salt.CopyTo(new Span<byte>(sess.SessionSalt, 16));
+        sess.ConnectionId = connectionId;
+        sess.SessionStartTime = DateTime.UtcNow;
+        sess.ConfigureCompression(true, 512);
+
+        return (salt, sess);
+    }
+
     public void GenerateNonce(ulong sequence, Span<byte> nonce)
     {
         if (nonce.Length < 12)
@@ -132,22 +224,7 @@ public unsafe struct SecureSession
             Span<byte> nonce = stackalloc byte[12];
             GenerateNonce(SeqTx, nonce);
 
-            var cipher = new ChaCha20Poly1305();
-
-            unsafe
-            {
-                fixed (byte* txKeyPtr = TxKey)
-                {
-                    var keyParam = new KeyParameter(new ReadOnlySpan<byte>(txKeyPtr, 32).ToArray());
-                    var parameters = new AeadParameters(keyParam, 128, nonce.ToArray(), aad.ToArray());
-
-                    cipher.Init(true, parameters);
-                    ciphertextLength = cipher.ProcessBytes(plaintext.ToArray(), 0, plaintext.Length, ciphertext.ToArray(), 0);
-                    ciphertextLength += cipher.DoFinal(ciphertext.Slice(ciphertextLength).ToArray(), 0);
-                }
-            }
-
-
+            ciphertextLength = Seal(nonce, plaintext, aad, ciphertext);
 
             SeqTx++;
             BytesTransmitted += (ulong)ciphertextLength;
@@ -163,47 +240,147 @@ public unsafe struct SecureSession
         }
     }
 
-    public bool EncryptPayloadWithCompression(ReadOnlySpan<byte> plaintext, ReadOnlySpan<byte> aad, Span<byte> result, out int resultLength, out bool wasCompressed)
+    private int Seal(ReadOnlySpan<byte> nonce, ReadOnlySpan<byte> plaintext, ReadOnlySpan<byte> aad, Span<byte> ciphertext)
     {
-        try
+        fixed (byte* txKeyPtr = TxKey)
         {
-            wasCompressed = false;
-            resultLength = 0;
+            var key = new ReadOnlySpan<byte>(txKeyPtr, 32);
+            return Seal(AesGcmEnabled ? _txAesGcm ??= new AesGcm(key, TagSize) : null, key, nonce, plaintext, aad, ciphertext);
+        }
+    }
 
-            Span<byte> encrypted = stackalloc byte[plaintext.Length + 16];
-            if (!EncryptPayload(plaintext, aad, encrypted, out int encryptedLength))
-                return false;
+    // One packet under either suite, AES-256-GCM through the given instance or ChaCha20-Poly1305 under key when
+    // there is none. Seal writes [ciphertext][tag] and returns its length, Open returns the plaintext length
+    // and throws when the tag does not verify.
+    public static int Seal(AesGcm aesGcm, ReadOnlySpan<byte> key, ReadOnlySpan<byte> nonce, ReadOnlySpan<byte> plaintext, ReadOnlySpan<byte> aad, Span<byte> ciphertext)
+    {
+        if (aesGcm != null)
+        {
+            // Send threads share sessions, and an instance only runs one operation at a time
+            lock (aesGcm)
+                aesGcm.Encrypt(nonce, plaintext, ciphertext.Slice(0, plaintext.Length), ciphertext.Slice(plaintext.Length, TagSize), aad);
+
+            return plaintext.Length + TagSize;
+        }
+
+        var cipher = new ChaCha20Poly1305();
+        cipher.Init(true, new AeadParameters(new KeyParameter(key.ToArray()), 128, nonce.ToArray(), aad.ToArray()));
 
-            if (encryptedLength > 512)
+        // Written through an array and copied back, ToArray on the span would hand the cipher a copy
+        byte[] ciphertextArray = new byte[plaintext.Length + TagSize];
+        int ciphertextLength = cipher.ProcessBytes(plaintext.ToArray(), 0, plaintext.Length, ciphertextArray, 0);
+        ciphertextLength += cipher.DoFinal(ciphertextArray, ciphertextLength);
+        new ReadOnlySpan<byte>(ciphertextArray, 0, ciphertextLength).CopyTo(ciphertext);
+        return ciphertextLength;
+    }
+
+    public static int Open(AesGcm aesGcm, ReadOnlySpan<byte> key, ReadOnlySpan<byte> nonce, ReadOnlySpan<byte> ciphertext, ReadOnlySpan<byte> aad, Span<byte> plaintext)
+    {
+        int plaintextLength = ciphertext.Length - TagSize;
+
+        if (aesGcm != null)
+        {
+            lock (aesGcm)
+                aesGcm.Decrypt(nonce, ciphertext.Slice(0, plaintextLength), ciphertext.Slice(plaintextLength), plaintext.Slice(0, plaintextLength), aad);
+
+            return plaintextLength;
+        }
+
+        var cipher = new ChaCha20Poly1305();
+        cipher.Init(false, new AeadParameters(new KeyParameter(key.ToArray()), 128, nonce.ToArray(), aad.ToArray()));
+
+        byte[] plaintextArray = new byte[plaintextLength];
+        plaintextLength = cipher.ProcessBytes(ciphertext.ToArray(), 0, ciphertext.Length, plaintextArray, 0);
+        plaintextLength += cipher.DoFinal(plaintextArray, plaintextLength);
+        new ReadOnlySpan<byte>(plaintextArray, 0, plaintextLength).CopyTo(plaintext);
+        return plaintextLength;
+    }
+
+    public void ConfigureCompression(bool enabled, int threshold)
+    {
+        CompressionEnabled = enabled;
+        CompressionThreshold = Math.Max(1, threshold);
+        CompressionRatio = 0;
+        _compressionSkipped = 0;
+    }
+
+    public void ConfigureCompressionLevel(int acceleration, int highThreshold)
+    {
+        CompressionAcceleration = Math.Clamp(acceleration, 1, LZ4Level.MaxAcceleration);
+        HighCompressionThreshold = Math.Max(0, highThreshold);
+    }
+
+    public bool ShouldCompress(int length)
+    {
+        int threshold = DictionaryId != 0 ? Math.Min(CompressionThreshold, DictionaryCompressionThreshold) : CompressionThreshold;
+
+        if (!CompressionEnabled || length < threshold)
+            return false;
+
+        // Traffic has been incompressible so far, only probe every so often
+        if (CompressionRatio >= IncompressibleRatio && ++_compressionSkipped < CompressionProbeInterval)
+            return false;
+
+        _compressionSkipped = 0;
+        return true;
+    }
+
+    // Returns the compressed length, or 0 when the result would not be smaller than the input
+    public int Compress(ReadOnlySpan<byte> source, Span<byte> destination, bool reliable = false)
+    {
+        int compressedLength;
+
+        // Send threads share sessions, so the LZ4 state used is the calling thread's
+        var level = reliable && HighCompressionThreshold > 0 && source.Length >= HighCompressionThreshold
+            ? LZ4Level.High()
+            : LZ4Level.Fast(CompressionAcceleration);
+
+        unsafe
+        {
+            fixed (byte* sourcePtr = source)
+            fixed (byte* destinationPtr = destination)
             {
-                unsafe
-                {
-                    fixed (byte* encryptedPtr = encrypted)
-                    fixed (byte* resultPtr = result)
-                    {
-                        int compressedLength = LZ4.Compress(encryptedPtr, encryptedLength, resultPtr, result.Length);
-                        if (compressedLength > 0 && compressedLength < encryptedLength)
-                        {
-                            wasCompressed = true;
-                            resultLength = compressedLength;
-                            return true;
-                        }
-                    }
-                }
+                // Capped below the input so LZ4 gives up as soon as the result cannot be smaller
+                int capacity = Math.Min(destination.Length, source.Length - 1);
+
+                compressedLength = LZ4Dictionary.TryGet(DictionaryId, out var dictionary)
+                    ? LZ4.CompressWithDictionary(sourcePtr, source.Length, destinationPtr, capacity, dictionary, level)
+                    : LZ4.Compress(sourcePtr, source.Length, destinationPtr, capacity, level);
             }
+        }
+
+        if (compressedLength <= 0 || compressedLength >= source.Length)
+            compressedLength = 0;
 
-            if (encryptedLength <= result.Length)
+        float sample = compressedLength > 0 ? (float)compressedLength / source.Length : 1f;
+        CompressionRatio = CompressionRatio > 0 ? CompressionRatio + (sample - CompressionRatio) * CompressionRatioGain : sample;
+
+        return compressedLength;
+    }
+
+    // Compresses ahead of encryption and sets the Compressed flag on the header before the AAD is
+    // taken from it, so the flag is authenticated along with the rest of the header
+    public bool EncryptPayloadWithCompression(ReadOnlySpan<byte> plaintext, ref PacketHeader header, Span<byte> result, out int resultLength)
+    {
+        try
+        {
+            // A stream-compressed body has nothing left for a second pass
+            if ((header.Flags & PacketHeaderFlags.StreamCompressed) == 0 && ShouldCompress(plaintext.Length))
             {
-                encrypted.Slice(0, encryptedLength).CopyTo(result);
-                resultLength = encryptedLength;
-                return true;
+                Span<byte> compressed = stackalloc byte[plaintext.Length];
+                int compressedLength = Compress(plaintext, compressed, header.Channel.GetKind() != PacketChannel.Unreliable);
+
+                if (compressedLength > 0)
+                {
+                    header.Flags |= PacketHeaderFlags.Compressed;
+                    return EncryptPayload(compressed.Slice(0, compressedLength), header.GetAAD(), result, out resultLength);
+                }
             }
 
-            return false;
+            return EncryptPayload(plaintext, header.GetAAD(), result, out resultLength);
         }
         catch
         {
-            wasCompressed = false;
             resultLength = 0;
             return false;
         }
@@ -218,20 +395,7 @@ public unsafe struct SecureSession
             BinaryPrimitives.WriteUInt32LittleEndian(nonce, ConnectionId);
             BinaryPrimitives.WriteUInt64LittleEndian(nonce.Slice(4), sequence);
 
-            var cipher = new ChaCha20Poly1305();
-
-            unsafe
-            {
-                fixed (byte* txKeyPtr = TxKey)
-                {
-                    var keyParam = new KeyParameter(new ReadOnlySpan<byte>(txKeyPtr, 32).ToArray());
-                    var parameters = new AeadParameters(keyParam, 128, nonce.ToArray(), aad.ToArray());
-
-                    cipher.Init(true, parameters);
-                    ciphertextLength = cipher.ProcessBytes(plaintext.ToArray(), 0, plaintext.Length, ciphertext.ToArray(), 0);
-                    ciphertextLength += cipher.DoFinal(ciphertext.Slice(ciphertextLength).ToArray(), 0);
-                }
-            }
+            ciphertextLength = Seal(nonce, plaintext, aad, ciphertext);
 
             // Increment SeqTx to keep crypto sequence in sync
             SeqTx++;
@@ -248,67 +412,27 @@ public unsafe struct SecureSession
         }
     }
 
-    public bool EncryptPayloadWithSequence(ReadOnlySpan<byte> plaintext, ReadOnlySpan<byte> aad, ulong sequence, Span<byte> result, out int resultLength, out bool wasCompressed)
+    public bool EncryptPayloadWithSequence(ReadOnlySpan<byte> plaintext, ref PacketHeader header, ulong sequence, Span<byte> result, out int resultLength)
     {
         try
         {
-            wasCompressed = false;
-            resultLength = 0;
-
-            // Use specific sequence for nonce generation
-            Span<byte> nonce = stackalloc byte[12];
-            BinaryPrimitives.WriteUInt32LittleEndian(nonce, ConnectionId);
-            BinaryPrimitives.WriteUInt64LittleEndian(nonce.Slice(4), sequence);
-
-            var cipher = new ChaCha20Poly1305();
-            Span<byte> encrypted = stackalloc byte[plaintext.Length + 16];
-
-            unsafe
+            // A stream-compressed body has nothing left for a second pass
+            if ((header.Flags & PacketHeaderFlags.StreamCompressed) == 0 && ShouldCompress(plaintext.Length))
             {
-                fixed (byte* txKeyPtr = TxKey)
-                {
-                    var keyParam = new KeyParameter(new ReadOnlySpan<byte>(txKeyPtr, 32).ToArray());
-                    var parameters = new AeadParameters(keyParam, 128, nonce.ToArray(), aad.ToArray());
-
-                    cipher.Init(true, parameters);
-                    int encryptedLength = cipher.ProcessBytes(plaintext.ToArray(), 0, plaintext.Length, encrypted.ToArray(), 0);
-                    encryptedLength += cipher.DoFinal(encrypted.Slice(encryptedLength).ToArray(), 0);
-
-                    // Increment SeqTx to keep crypto sequence in sync
-                    SeqTx++;
-
-                    if (encryptedLength > 512)
-                    {
-                        unsafe
-                        {
-                            fixed (byte* encryptedPtr = encrypted)
-                            fixed (byte* resultPtr = result)
-                            {
-                                int compressedLength = LZ4.Compress(encryptedPtr, encryptedLength, resultPtr, result.Length);
-                                if (compressedLength > 0 && compressedLength < encryptedLength)
-                                {
-                                    wasCompressed = true;
-                                    resultLength = compressedLength;
-                                    return true;
-                                }
-                            }
-                        }
-                    }
+                Span<byte> compressed = stackalloc byte[plaintext.Length];
+                int compressedLength = Compress(plaintext, compressed, header.Channel.GetKind() != PacketChannel.Unreliable);
 
-                    if (encryptedLength <= result.Length)
-                    {
-                        encrypted.Slice(0, encryptedLength).CopyTo(result);
-                        resultLength = encryptedLength;
-                        return true;
-                    }
+                if (compressedLength > 0)
+                {
+                    header.Flags |= PacketHeaderFlags.Compressed;
+                    return EncryptPayloadWithSpecificSequence(compressed.Slice(0, compressedLength), header.GetAAD(), sequence, result, out resultLength);
                 }
             }
 
-            return false;
+            return EncryptPayloadWithSpecificSequence(plaintext, header.GetAAD(), sequence, result, out resultLength);
         }
         catch
         {
-            wasCompressed = false;
             resultLength = 0;
             return false;
         }
@@ -352,45 +476,17 @@ public unsafe struct SecureSession
                 FileLogger.Log($"[SERVER] Ciphertext Length: {ciphertext.Length} bytes");
             }
 
-            var cipher = new ChaCha20Poly1305();
-
-            unsafe
+            fixed (byte* rxKeyPtr = RxKey)
             {
-                fixed (byte* rxKeyPtr = RxKey)
-                {
-                    var keyParam = new KeyParameter(new ReadOnlySpan<byte>(rxKeyPtr, 32).ToArray());
-                    var parameters = new AeadParameters(keyParam, 128, nonce.ToArray(), aad.ToArray());
-
-                    cipher.Init(false, parameters);
-
-                    // Create arrays for crypto operations
-                    byte[] ciphertextArray = ciphertext.ToArray();
-                    byte[] plaintextArray = new byte[plaintext.Length];
-
-                    // Log detailed crypto operation for first packet
-                    if (sequence == 0)
-                    {
-                        FileLogger.Log($"[SERVER] Starting decryption...");
-                        FileLogger.Log($"[SERVER] Input ciphertext array length: {ciphertextArray.Length}");
-                        FileLogger.Log($"[SERVER] Output plaintext array length: {plaintextArray.Length}");
-                    }
-
-                    plaintextLength = cipher.ProcessBytes(ciphertextArray, 0, ciphertextArray.Length, plaintextArray, 0);
-                    int finalLength = cipher.DoFinal(plaintextArray, plaintextLength);
-                    plaintextLength += finalLength;
-
-                    // Log the results for first packet
-                    if (sequence == 0)
-                    {
-                        FileLogger.Log($"[SERVER] ProcessBytes returned: {plaintextLength - finalLength} bytes");
-                        FileLogger.Log($"[SERVER] DoFinal returned: {finalLength} bytes");
-                        FileLogger.Log($"[SERVER] Total plaintext length: {plaintextLength} bytes");
-                        FileLogger.LogHex("[SERVER] Raw decrypted data", new ReadOnlySpan<byte>(plaintextArray, 0, plaintextLength));
-                    }
+                var key = new ReadOnlySpan<byte>(rxKeyPtr, 32);
+                plaintextLength = Open(AesGcmEnabled ? _rxAesGcm ??= new AesGcm(key, TagSize) : null, key, nonce, ciphertext, aad, plaintext);
+            }
 
-                    // Copy result back to span
-                    new ReadOnlySpan<byte>(plaintextArray, 0, plaintextLength).CopyTo(plaintext);
-                }
+            // Log the results for first packet
+            if (sequence == 0)
+            {
+                FileLogger.Log($"[SERVER] Total plaintext length: {plaintextLength} bytes");
+                FileLogger.LogHex("[SERVER] Raw decrypted data", plaintext.Slice(0, plaintextLength));
             }
 
             UpdateReplayWindow(sequence);
@@ -428,18 +524,25 @@ public unsafe struct SecureSession
 
             if (isCompressed)
             {
-                Span<byte> decompressed = stackalloc byte[data.Length * 4];
+                // The compressed plaintext is authenticated first, only then handed to the decompressor
+                Span<byte> decrypted = stackalloc byte[data.Length];
+
+                if (!DecryptPayload(data, aad, sequence, decrypted, out int decryptedLength))
+                    return false;
 
                 unsafe
                 {
-                    fixed (byte* dataPtr = data)
-                    fixed (byte* decompressedPtr = decompressed)
+                    fixed (byte* decryptedPtr = decrypted)
+                    fixed (byte* plaintextPtr = plaintext)
                     {
-                        int decompressedLength = LZ4.Decompress(dataPtr, data.Length, decompressedPtr, decompressed.Length);
+                        int decompressedLength = LZ4Dictionary.TryGet(DictionaryId, out var dictionary)
+                            ? LZ4.DecompressWithDictionary(decryptedPtr, decryptedLength, plaintextPtr, plaintext.Length, dictionary)
+                            : LZ4.Decompress(decryptedPtr, decryptedLength, plaintextPtr, plaintext.Length);
                         if (decompressedLength <= 0)
                             return false;
 
-                        return DecryptPayload(decompressed.Slice(0, decompressedLength), aad, sequence, plaintext, out plaintextLength);
+                        plaintextLength = decompressedLength;
+                        return true;
                     }
                 }
             }
@@ -455,7 +558,9 @@ public unsafe struct SecureSession
         }
     }
 
-    private bool IsSequenceValid(ulong sequence)
+    // Replay check alone, so the receive path can turn a stale sequence away before paying for the AEAD.
+    // The window itself only moves once a packet authenticates.
+    public bool IsSequenceValid(ulong sequence)
     {
         if (sequence > _highestSeqReceived)
             return true;
@@ -535,6 +640,10 @@ public unsafe struct SecureSession
             BytesTransmitted = 0;
             SessionStartTime = DateTime.UtcNow;
 
+            // Keyed with the old keys, the next packet each way sets up new ones
+            _txAesGcm = null;
+            _rxAesGcm = null;
+
             SeqTx = 0;
             SeqRx = 0;
             _replayWindow = 0;
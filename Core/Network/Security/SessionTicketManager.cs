@@ -0,0 +1,102 @@
+/*
+* SessionTicketManager - Session resumption tickets
+*
+* Author: Andre Ferreira
+*
+* Copyright (c) Uzmi Games. Licensed under the MIT License.
+*/
+
+using System.Buffers.Binary;
+using System.Collections.Concurrent;
+using Org.BouncyCastle.Crypto;
+using Org.BouncyCastle.Crypto.Modes;
+using Org.BouncyCastle.Crypto.Parameters;
+
+// A ticket is [nonce][issued at, resumption secret][tag], sealed under a key only the server holds. The nonce
+// doubles as the ticket id: a ticket redeems once, and only within its lifetime. The key lives as long as the
+// process, so a restart sends everyone back through the full handshake.
+public static class SessionTicketManager
+{
+    private const int NonceSize = 12;
+    private const int TagSize = 16;
+    private const int PlaintextSize = sizeof(long) + SecureSession.ResumptionSecretSize;
+    public const int TicketSize = NonceSize + PlaintextSize + TagSize;
+
+    private static readonly byte[] TicketKey = new byte[32];
+    private static readonly ConcurrentDictionary<ulong, long> Redeemed = new(); // Ticket id -> unix second it expires
+
+    public static TimeSpan Lifetime = TimeSpan.FromHours(1);
+    public static bool Enabled => Lifetime > TimeSpan.Zero;
+
+    static SessionTicketManager()
+    {
+        System.Security.Cryptography.RandomNumberGenerator.Fill(TicketKey);
+    }
+
+    public static byte[] Issue(ReadOnlySpan<byte> resumptionSecret)
+    {
+        var ticket = new byte[TicketSize];
+        System.Security.Cryptography.RandomNumberGenerator.Fill(ticket.AsSpan(0, NonceSize));
+
+        var plaintext = new byte[PlaintextSize];
+        BinaryPrimitives.WriteInt64LittleEndian(plaintext, DateTimeOffset.UtcNow.ToUnixTimeSeconds());
+        resumptionSecret.Slice(0, SecureSession.ResumptionSecretSize).CopyTo(plaintext.AsSpan(sizeof(long)));
+
+        var cipher = CreateCipher(true, ticket);
+        int length = cipher.ProcessBytes(plaintext, 0, plaintext.Length, ticket, NonceSize);
+        cipher.DoFinal(ticket, NonceSize + length);
+
+        return ticket;
+    }
+
+    public static bool TryRedeem(ReadOnlySpan<byte> ticket, Span<byte> resumptionSecret)
+    {
+        if (!Enabled || ticket.Length != TicketSize)
+            return false;
+
+        var ticketArray = ticket.ToArray();
+        var plaintext = new byte[PlaintextSize];
+
+        try
+        {
+            var cipher = CreateCipher(false, ticketArray);
+            int length = cipher.ProcessBytes(ticketArray, NonceSize, TicketSize - NonceSize, plaintext, 0);
+            cipher.DoFinal(plaintext, length);
+        }
+        catch (InvalidCipherTextException)
+        {
+            return false;
+        }
+
+        long expiresAt = BinaryPrimitives.ReadInt64LittleEndian(plaintext) + (long)Lifetime.TotalSeconds;
+
+        if (DateTimeOffset.UtcNow.ToUnixTimeSeconds() >= expiresAt)
+            return false;
+
+        // Only the first presentation counts, a replayed ticket is as good as a forged one
+        if (!Redeemed.TryAdd(BinaryPrimitives.ReadUInt64LittleEndian(ticket), expiresAt))
+            return false;
+
+        plaintext.AsSpan(sizeof(long)).CopyTo(resumptionSecret);
+        return true;
+    }
+
+    // A redeemed id only has to be remembered until its ticket would have expired anyway
+    public static void Sweep()
+    {
+        long now = DateTimeOffset.UtcNow.ToUnixTimeSeconds();
+
+        foreach (var kv in Redeemed)
+        {
+            if (kv.Value <= now)
+                Redeemed.TryRemove(kv.Key, out _);
+        }
+    }
+
+    private static ChaCha20Poly1305 CreateCipher(bool forEncryption, byte[] ticket)
+    {
+        var cipher = new ChaCha20Poly1305();
+        cipher.Init(forEncryption, new AeadParameters(new KeyParameter(TicketKey), 128, ticket.AsSpan(0, NonceSize).ToArray()));
+        return cipher;
+    }
+}
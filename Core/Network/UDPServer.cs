@@ -23,6 +23,7 @@
 
 using NanoSockets;
 using Org.BouncyCastle.Bcpg;
+using System.Buffers.Binary;
 using System.Collections.Concurrent;
 using System.Diagnostics;
 using System.Runtime.InteropServices;
@@ -66,6 +67,16 @@ public class UDPServerOptions
     public int SendBufferSize { get; set; } = 512 * 1024;
     public int SendThreadCount { get; set; } = 1;
     public int MTU = 1200;
+    public bool EnableLZ4Compression { get; set; } = true;
+    public int CompressionThreshold { get; set; } = 512;
+    public int CompressionAcceleration { get; set; } = 1;
+    public int HighCompressionThreshold { get; set; } = 1024;
+    public string CompressionDictionaryPath { get; set; } = "";
+    public bool EnableStreamCompression { get; set; } = true;
+    public bool OmitAeadChecksum { get; set; } = false;
+    public bool EnableAesGcm { get; set; } = true;
+    public int SessionTicketLifetime { get; set; } = 3600;
+    public bool EnableConnectionMigration { get; set; } = true;
 }
 
 public sealed class UDPServer
@@ -83,6 +94,10 @@ public sealed class UDPServer
     public static ConcurrentDictionary<Address, UDPSocket> Clients =
         new ConcurrentDictionary<Address, UDPSocket>();
 
+    // Same connections by ConnectionId, which is how a client that changed address is recognised
+    public static ConcurrentDictionary<uint, UDPSocket> ClientsById =
+        new ConcurrentDictionary<uint, UDPSocket>();
+
     private static Channel<SendPacket> GlobalSendChannel;
 
     [ThreadStatic]
@@ -102,6 +117,12 @@ public sealed class UDPServer
     public static int _tickRate = 0;
     public static int _sendQueueCount = 0;
 
+    // Encrypted datagrams are validated cheapest first: length, CRC32C trailer, replay window, then the AEAD
+    public static long _malformedRejects = 0;
+    public static long _checksumRejects = 0;
+    public static long _replayRejects = 0;
+    public static long _decryptRejects = 0;
+
     private static Thread SendThread;
 
     private static Thread ReceiveThread;
@@ -110,6 +131,8 @@ public sealed class UDPServer
 
     public static TimeSpan ReliableTimeout { get; private set; } = TimeSpan.FromMilliseconds(250f);
 
+    public static int MaxRetries { get; private set; } = 10;
+
     public delegate bool ConnectionHandler(UDPSocket socket, string token);
 
     private static ConnectionHandler _connectionHandler;
@@ -121,6 +144,10 @@ public sealed class UDPServer
     public static long BytesSent => Interlocked.Read(ref _bytesSent);
     public static long BytesReceived => Interlocked.Read(ref _bytesReceived);
     public static int TickRate => _tickRate;
+    public static long MalformedRejects => Interlocked.Read(ref _malformedRejects);
+    public static long ChecksumRejects => Interlocked.Read(ref _checksumRejects);
+    public static long ReplayRejects => Interlocked.Read(ref _replayRejects);
+    public static long DecryptRejects => Interlocked.Read(ref _decryptRejects);
 
     public static uint GetRandomId() =>
         (uint)BitConverter.ToInt32(Guid.NewGuid().ToByteArray(), 0) & 0x7FFFFFFF;
@@ -145,10 +172,34 @@ public sealed class UDPServer
             ReceiveBufferSize = config.Network.ReceiveBufferSize,
             SendBufferSize = config.Network.SendBufferSize,
             SendThreadCount = config.Network.SendThreadCount,
-            MTU = config.Network.MaxPacketSize
+            MTU = config.Network.MaxPacketSize,
+            EnableLZ4Compression = config.Network.EnableLZ4Compression,
+            CompressionThreshold = config.Network.CompressionThreshold,
+            CompressionAcceleration = config.Network.CompressionAcceleration,
+            HighCompressionThreshold = config.Network.HighCompressionThreshold,
+            CompressionDictionaryPath = config.Network.CompressionDictionaryPath,
+            EnableStreamCompression = config.Network.EnableStreamCompression,
+            OmitAeadChecksum = config.Network.OmitAeadChecksum,
+            EnableAesGcm = config.Network.EnableAesGcm,
+            SessionTicketLifetime = config.Network.SessionTicketLifetime,
+            EnableConnectionMigration = config.Network.EnableConnectionMigration
         };
     }
 
+    private static void LoadCompressionDictionary(string path)
+    {
+        try
+        {
+            var dictionary = LZ4Dictionary.LoadFromFile(path);
+            LZ4Dictionary.Register(dictionary);
+            Console.WriteLine($"[NET] LZ4 dictionary {path} loaded ({dictionary.Size} bytes, id {dictionary.Id:X8})");
+        }
+        catch (Exception ex)
+        {
+            Console.WriteLine($"[NET] Failed to load LZ4 dictionary {path}: {ex.Message}");
+        }
+    }
+
     public static int Mtu
     {
         get
@@ -178,6 +229,15 @@ public sealed class UDPServer
         // Apply configuration values
         port = config.Network.Port;
         ReliableTimeout = TimeSpan.FromMilliseconds(config.Performance.ReliableTimeoutMs);
+        MaxRetries = Math.Max(1, config.Performance.MaxRetries);
+
+        if (!string.IsNullOrEmpty(_options.CompressionDictionaryPath))
+            LoadCompressionDictionary(_options.CompressionDictionaryPath);
+
+        SessionTicketManager.Lifetime = TimeSpan.FromSeconds(Math.Max(0, _options.SessionTicketLifetime));
+
+        if (!string.IsNullOrEmpty(config.Network.CaptureTrafficPath))
+            PacketCapture.Start(config.Network.CaptureTrafficPath);
 
         if (_options.UseXOREncode)
             _baseFlags = PacketFlagsUtils.AddFlag(_baseFlags, PacketFlags.XOR);
@@ -352,6 +412,7 @@ public sealed class UDPServer
                                 {
                                     if (Clients.TryRemove(kv.Key, out var client))
                                     {
+                                        ClientsById.TryRemove(client.Id, out _);
 #if DEBUG
                                         ServerMonitor.Log($"Client timeout disconnected: {kv.Key}, handshake complete: {client.CryptoHandshakeComplete}");
 #endif
@@ -363,6 +424,8 @@ public sealed class UDPServer
                             }
                         }
 
+                        SessionTicketManager.Sweep();
+
                         cleanupTimer.Restart();
                     }
 
@@ -473,16 +536,9 @@ public sealed class UDPServer
                         {
                             if (data.Position + 32 == len)
                             {
-                                var cookie = CookieManager.GenerateCookie(address);
-                                var helloBuffer = new FlatBuffer(49);
-                                helloBuffer.Write(PacketType.Cookie);
-                                helloBuffer.WriteBytes(cookie);
-
-                                var helloLen = helloBuffer.Position;
-                                UDP.Unsafe.Send(ServerSocket, &address, helloBuffer.Data, helloLen);
-                                helloBuffer.Free();
+                                SendCookie(address);
                             }
-                            else if (data.Position + 32 + 48 == len)
+                            else if (data.Position + 32 + 48 == len || data.Position + 32 + 48 + 4 == len || data.Position + 32 + 48 + 4 + 1 == len)
                             {
                                 byte[] clientPub = new byte[32];
                                 for (int i = 0; i < 32; i++)
@@ -498,35 +554,84 @@ public sealed class UDPServer
                                     break;
                                 }
 
+                                // Optional trailer: [LZ4 dictionary the client holds][session options it offers],
+                                // each kept only when the server agrees
+                                uint dictionaryId = data.Position + 4 <= len ? data.Read<uint>() : 0;
+                                var options = data.Position + 1 == len ? (SessionOptions)data.Read<byte>() : SessionOptions.None;
+
                                 uint connectionId = GetRandomId();
                                 var (serverPub, salt, session) = SecureSession.CreateAsServer(clientPub, connectionId);
 
-                                var newSocket = new UDPSocket(ServerSocket)
-                                {
-                                    Id = connectionId,
-                                    RemoteAddress = address,
-                                    TimeoutLeft = 30f,
-                                    State = ConnectionState.Connecting,
-                                    Flags = _baseFlags,
-                                    EnableIntegrityCheck = _options.EnableIntegrityCheck,
-                                    Session = session
-                                };
-
-                                bool valid = _connectionHandler?.Invoke(newSocket, null) ?? true;
-                                //valid &&
-
-                                if (Clients.TryAdd(address, newSocket))
-                                {
-                                    newSocket.Send(new ConnectionAcceptedPacket
-                                    {
-                                        Id = connectionId,
-                                        ServerPublicKey = serverPub,
-                                        Salt = salt
-                                    });
+                                AcceptConnection(address, session, serverPub, salt, dictionaryId, options & ~SessionOptions.Resumed);
+                            }
+                        }
+
+                        data.Free();
+                    }
+                    break;
+                case PacketType.Resume:
+                    {
+                        // [client nonce][ticket][LZ4 dictionary id][session options]: keys come from the ticket, so the
+                        // session is usable as soon as ConnectionAccepted lands. A ticket that does not redeem is
+                        // answered with a cookie, which puts the client back on the full handshake.
+                        if (!Clients.ContainsKey(address) && data.Position + SecureSession.ResumeNonceSize + SessionTicketManager.TicketSize + 5 == len)
+                        {
+                            byte[] clientNonce = new byte[SecureSession.ResumeNonceSize];
+                            for (int i = 0; i < clientNonce.Length; i++)
+                                clientNonce[i] = data.Read<byte>();
+
+                            byte[] ticket = new byte[SessionTicketManager.TicketSize];
+                            for (int i = 0; i < ticket.Length; i++)
+                                ticket[i] = data.Read<byte>();
+
+                            uint dictionaryId = data.Read<uint>();
+                            var options = (SessionOptions)data.Read<byte>();
+                            byte[] resumptionSecret = new byte[SecureSession.ResumptionSecretSize];
+
+                            if (SessionTicketManager.TryRedeem(ticket, resumptionSecret))
+                            {
+                                uint connectionId = GetRandomId();
+                                var (salt, session) = SecureSession.CreateFromResumption(resumptionSecret, clientNonce, connectionId);
+                                var resumed = AcceptConnection(address, session, new byte[32], salt, dictionaryId, options | SessionOptions.Resumed);
 
-                                    newSocket.State = ConnectionState.Connected;
+                                if (resumed != null)
+                                {
+                                    // Possession of the keys is proven by the first packet that authenticates, there is
+                                    // no CryptoTest round. ConnectionAccepted goes out ahead of the replacement ticket.
+                                    resumed.ClientCryptoConfirmed = true;
+                                    resumed.ServerCryptoConfirmed = true;
+                                    resumed.Send(ref resumed.UnreliableBuffer);
+                                    IssueSessionTicket(resumed);
                                 }
                             }
+                            else
+                            {
+                                SendCookie(address);
+                            }
+                        }
+
+                        data.Free();
+                    }
+                    break;
+                case PacketType.PathResponse:
+                    {
+                        // [connection id][challenge], echoed from the address the client moved to
+                        if (!Clients.ContainsKey(address) && data.Position + sizeof(uint) + sizeof(ulong) == len)
+                        {
+                            uint connectionId = data.Read<uint>();
+                            ulong response = data.Read<ulong>();
+
+                            if (ClientsById.TryGetValue(connectionId, out conn) &&
+                                conn.TryCompletePathChallenge(address, response) &&
+                                Clients.TryAdd(address, conn))
+                            {
+                                var previous = conn.RemoteAddress;
+                                Clients.TryRemove(new KeyValuePair<Address, UDPSocket>(previous, conn));
+                                conn.MigrateTo(address);
+#if DEBUG
+                                ServerMonitor.Log($"Connection {connectionId} migrated from {previous} to {address}");
+#endif
+                            }
                         }
 
                         data.Free();
@@ -540,6 +645,7 @@ public sealed class UDPServer
                             ushort nowMs = (ushort)(Stopwatch.GetTimestamp() / (Stopwatch.Frequency / 1000) % 65536);
                             ushort rttMs = (ushort)((nowMs - sentTimestampMs) & 0xFFFF);
                             conn.Ping = rttMs;
+                            conn.Rtt.AddSample(rttMs);
                             conn.TimeoutLeft = 30f;
                         }
 
@@ -550,6 +656,7 @@ public sealed class UDPServer
                     {
                         if (Clients.TryRemove(address, out conn))
                         {
+                            ClientsById.TryRemove(conn.Id, out _);
                             conn.OnDisconnect();
 #if DEBUG
                             ServerMonitor.Log($"Client disconnected: {address}");
@@ -647,6 +754,7 @@ public sealed class UDPServer
 #if DEBUG
                                 ServerMonitor.Log($"Crypto handshake complete for {address}");
 #endif
+                                IssueSessionTicket(conn);
                             }
                         }
 
@@ -675,6 +783,7 @@ public sealed class UDPServer
 #if DEBUG
                                 ServerMonitor.Log($"Crypto handshake complete for {address}");
 #endif
+                                IssueSessionTicket(conn);
                             }
                         }
 
@@ -724,6 +833,20 @@ public sealed class UDPServer
         }
     }
 
+    // Handlers read from the start of the plaintext on both channels
+    internal static FlatBuffer CreatePlaintextBuffer(ReadOnlySpan<byte> plaintext)
+    {
+        var buffer = new FlatBuffer(plaintext.Length + 1);
+        buffer.WriteBytes(plaintext.ToArray());
+
+        // Fragments are reassembled and batches walked after ordering, both need their exact length
+        if (plaintext.Length > 0 && (plaintext[0] == (byte)PacketType.Fragment || plaintext[0] == (byte)PacketType.Batch))
+            buffer.Resize(plaintext.Length);
+
+        buffer.RestorePosition(0);
+        return buffer;
+    }
+
     private static unsafe void HandleFragment(FlatBuffer data, int len, Address address)
     {
         if (!Clients.TryGetValue(address, out var conn))
@@ -732,49 +855,144 @@ public sealed class UDPServer
             return;
         }
 
-        ushort fragmentId = data.Read<ushort>();
-        ushort offset = data.Read<ushort>();
-        uint totalSize = data.Read<uint>();
-        int payloadLen = len - data.Position;
-
-        var fragment = conn.Fragments.GetOrAdd(fragmentId, _ => new UDPSocket.FragmentInfo
+        if (conn.AppendFragment(data, len, out var message))
         {
-            Buffer = new FlatBuffer((int)totalSize),
-            TotalSize = totalSize,
-            Received = 0,
-            LastUpdate = DateTime.UtcNow
-        });
+            PacketType original = (PacketType)message.Read<byte>();
+            HandlePacket(original, message, message.Capacity, address);
+            message.Free();
+        }
 
-        unsafe
+        data.Free();
+    }
+
+    private static unsafe void SendCookie(Address address)
+    {
+        var cookie = CookieManager.GenerateCookie(address);
+        var helloBuffer = new FlatBuffer(49);
+        helloBuffer.Write(PacketType.Cookie);
+        helloBuffer.WriteBytes(cookie);
+
+        var helloLen = helloBuffer.Position;
+        UDP.Unsafe.Send(ServerSocket, &address, helloBuffer.Data, helloLen);
+        helloBuffer.Free();
+    }
+
+    // Settles what the client offered against what this server allows, registers the connection and answers
+    // with ConnectionAccepted. Returns null when the address already has a connection.
+    private static UDPSocket AcceptConnection(Address address, SecureSession session, byte[] serverPub, byte[] salt, uint dictionaryId, SessionOptions options)
+    {
+        if (dictionaryId != 0 && !LZ4Dictionary.TryGet(dictionaryId, out _))
+            dictionaryId = 0;
+
+        // ChaCha20-Poly1305 unless the client offered AES-256-GCM and this machine runs it in hardware too
+        options &= (_options.OmitAeadChecksum ? SessionOptions.NoChecksum : SessionOptions.None) |
+            (_options.EnableAesGcm && SecureSession.AesGcmAccelerated ? SessionOptions.AES256GCM : SessionOptions.None) |
+            SessionOptions.Resumed;
+
+        session.ConfigureCompression(_options.EnableLZ4Compression, _options.CompressionThreshold);
+        session.ConfigureCompressionLevel(_options.CompressionAcceleration, _options.HighCompressionThreshold);
+        session.DictionaryId = dictionaryId;
+        session.Options = options;
+
+        var newSocket = new UDPSocket(ServerSocket)
         {
-            Buffer.MemoryCopy(data.Data + data.Position, fragment.Buffer.Data + offset, fragment.Buffer.Capacity - offset, payloadLen);
-        }
+            Id = session.ConnectionId,
+            RemoteAddress = address,
+            TimeoutLeft = 30f,
+            State = ConnectionState.Connecting,
+            Flags = _baseFlags,
+            EnableIntegrityCheck = _options.EnableIntegrityCheck,
+            EnableStreamCompression = _options.EnableStreamCompression,
+            Session = session
+        };
+
+        bool valid = _connectionHandler?.Invoke(newSocket, null) ?? true;
+        //valid &&
 
-        fragment.Received += payloadLen;
-        fragment.LastUpdate = DateTime.UtcNow;
+        if (!Clients.TryAdd(address, newSocket))
+            return null;
 
-        if (fragment.Received >= fragment.TotalSize)
+        ClientsById[session.ConnectionId] = newSocket;
+
+        newSocket.Send(new ConnectionAcceptedPacket
         {
-            fragment.Buffer.RestorePosition(0);
-            PacketType original = (PacketType)fragment.Buffer.Read<byte>();
-            HandlePacket(original, fragment.Buffer, (int)fragment.TotalSize, address);
-            fragment.Buffer.Free();
-            conn.Fragments.TryRemove(fragmentId, out _);
-        }
+            Id = session.ConnectionId,
+            ServerPublicKey = serverPub,
+            Salt = salt,
+            DictionaryId = dictionaryId,
+            Options = (byte)options
+        });
 
-        data.Free();
+        newSocket.State = ConnectionState.Connected;
+        return newSocket;
+    }
+
+    // A connection id this server knows arriving from an address it does not: the client's NAT binding or
+    // network changed. Only connections past the crypto handshake move, and only on a packet that authenticates.
+    private static unsafe bool TryGetMigratingConnection(FlatBuffer data, Address address, out UDPSocket conn)
+    {
+        uint connectionId = *(uint*)data.Data;
+
+        return ClientsById.TryGetValue(connectionId, out conn) && conn.CryptoHandshakeComplete &&
+            !conn.RemoteAddress.Equals(address);
+    }
+
+    // [PathChallenge][connection id][challenge]. Plaintext like the cookie: it only goes to the new address, so
+    // only a client actually reachable there can echo it. It is smaller than the packet that triggered it.
+    private static unsafe void SendPathChallenge(UDPSocket conn, Address address)
+    {
+        if (!conn.BeginPathChallenge(address, out ulong challenge))
+            return;
+
+        var challengeBuffer = new FlatBuffer(1 + sizeof(uint) + sizeof(ulong));
+        challengeBuffer.Write(PacketType.PathChallenge);
+        challengeBuffer.Write(conn.Id);
+        challengeBuffer.Write(challenge);
+
+        var challengeLen = challengeBuffer.Position;
+        UDP.Unsafe.Send(ServerSocket, &address, challengeBuffer.Data, challengeLen);
+        challengeBuffer.Free();
+    }
+
+    // [SessionTicket][lifetime in seconds][ticket], sent once per connection when its keys are confirmed
+    private static void IssueSessionTicket(UDPSocket conn)
+    {
+        if (!SessionTicketManager.Enabled || conn.SessionTicketIssued)
+            return;
+
+        conn.SessionTicketIssued = true;
+
+        Span<byte> resumptionSecret = stackalloc byte[SecureSession.ResumptionSecretSize];
+        conn.Session.DeriveResumptionSecret(resumptionSecret);
+        var ticket = SessionTicketManager.Issue(resumptionSecret);
+
+        var ticketBuffer = new FlatBuffer(1 + sizeof(uint) + ticket.Length);
+        ticketBuffer.Write(PacketType.SessionTicket);
+        ticketBuffer.Write((uint)SessionTicketManager.Lifetime.TotalSeconds);
+        ticketBuffer.WriteBytes(ticket);
+        conn.Send(ref ticketBuffer, false);
+        ticketBuffer.Free();
     }
 
     internal static void ProcessPacket(FlatBuffer buffer, int len, Address address)
     {
         // Check if packet is encrypted (has encryption header)
-        if (len > 12 && Clients.TryGetValue(address, out var conn) && conn.Session.ConnectionId != 0)
+        if (len >= PacketHeader.Size && Clients.TryGetValue(address, out var conn) && conn.Session.ConnectionId != 0)
         {
-            FileLogger.Log($"[SERVER] 🔄 Processing encrypted packet ({len} bytes) using LEGACY header-based method");
             // Try to process as encrypted packet first
             if (ProcessEncryptedPacket_Legacy(buffer, conn, len))
                 return;
         }
+        else if (len >= PacketHeader.Size && _options.EnableConnectionMigration && TryGetMigratingConnection(buffer, address, out conn))
+        {
+            // Delivered like any other packet, its keys and replay window vouch for it. Replies keep going to the
+            // old address until the new one answers the challenge.
+            if (ProcessEncryptedPacket_Legacy(buffer, conn, len))
+            {
+                SendPathChallenge(conn, address);
+                return;
+            }
+        }
 
         // Fallback to unencrypted processing (for handshake packets)
         PacketType packetType = (PacketType)buffer.Read<byte>();
@@ -810,7 +1028,8 @@ public sealed class UDPServer
         return data;
     }
 
-    public static unsafe bool Send(ref FlatBuffer buffer, int length, UDPSocket socket, bool flush = true)
+    // Encrypted datagrams carry their own trailer, or none when the session negotiated it away, and pass sign: false
+    public static unsafe bool Send(ref FlatBuffer buffer, int length, UDPSocket socket, bool flush = true, bool sign = true)
     {
         if (length > 0 && socket != null && GlobalSendChannel != null)
         {
@@ -863,7 +1082,7 @@ public sealed class UDPServer
             else
             {
                 var len = length;
-                var data = AddSignature(buffer.Data, length, out len);
+                var data = sign ? AddSignature(buffer.Data, length, out len) : buffer.Data;
 
                 var packet = new SendPacket
                 {
@@ -1001,7 +1220,7 @@ public sealed class UDPServer
             {
                 // Route to reliable queue for processing
                 if (conn.Session.ConnectionId != 0)
-                    conn.ProcessReliablePacket(conn.Session.SeqRx, decryptedBuffer);
+                    conn.ProcessReliablePacket(conn.Session.SeqRx, ReliableStream.Default, conn.Session.SeqRx, decryptedBuffer);
                 return true;
             }
             else
@@ -1022,36 +1241,80 @@ public sealed class UDPServer
     {
         try
         {
-            FileLogger.Log($"[SERVER] 🔓 LEGACY: Starting header-based decryption for {totalLen} bytes");
             var header = PacketHeader.Deserialize(data.Data);
-            FileLogger.Log($"[SERVER] 🔓 LEGACY: Header parsed - ConnectionId: {header.ConnectionId}, Sequence: {header.Sequence}");
 
             if (conn.Session.ConnectionId == 0 || header.ConnectionId != conn.Session.ConnectionId)
                 return false;
 
-            if (!header.Flags.HasFlag(PacketHeaderFlags.Encrypted) ||
-                !header.Flags.HasFlag(PacketHeaderFlags.AEAD_ChaCha20Poly1305))
+            if (!header.Flags.HasFlag(PacketHeaderFlags.Encrypted) || header.Flags.GetAead() != conn.Session.AeadFlag)
                 return false;
 
-            // Subtract both header and CRC32 signature (4 bytes) from total length
-            int payloadLen = totalLen - PacketHeader.Size - 4;
+            // Cheapest checks first, so garbage and spoofed datagrams are gone before they cost an AEAD attempt
+            int trailerLen = conn.Session.ChecksumEnabled ? sizeof(uint) : 0;
+            int payloadLen = totalLen - PacketHeader.Size - trailerLen;
 
-            if (payloadLen <= 16)
+            if (payloadLen <= SecureSession.TagSize)
+            {
+                Interlocked.Increment(ref _malformedRejects);
                 return false;
+            }
+
+            if (trailerLen > 0 && data.ReadSign(totalLen) != CRC32C.Compute(data.Data, totalLen - trailerLen))
+            {
+                Interlocked.Increment(ref _checksumRejects);
+                return false;
+            }
+
+            if (!conn.Session.IsSequenceValid(header.Sequence))
+            {
+                Interlocked.Increment(ref _replayRejects);
+                return false;
+            }
 
             var payload = new ReadOnlySpan<byte>(data.Data + PacketHeader.Size, payloadLen);
             var aad = header.GetAAD();
             bool isCompressed = header.Flags.HasFlag(PacketHeaderFlags.Compressed);
             bool isAcknowledgment = header.Flags.HasFlag(PacketHeaderFlags.Acknowledgment);
 
-            Span<byte> plaintext = stackalloc byte[payloadLen * 4]; // Extra space for decompression
+            Span<byte> plaintext = stackalloc byte[isCompressed ? SecureSession.MaxDecompressedSize : payloadLen];
 
-            if (conn.Session.ConnectionId == 0 || !conn.Session.DecryptPayloadWithDecompression(payload, aad, header.Sequence, isCompressed, plaintext, out int plaintextLen))
+            if (!conn.Session.DecryptPayloadWithDecompression(payload, aad, header.Sequence, isCompressed, plaintext, out int plaintextLen))
             {
+                Interlocked.Increment(ref _decryptRejects);
                 ServerMonitor.Log($"Failed to decrypt packet from {conn.RemoteAddress}");
                 return false;
             }
 
+            if (PacketCapture.IsEnabled)
+                PacketCapture.Record(plaintext.Slice(0, plaintextLen));
+
+            // Peel the transport prefix, [ack block][reliable sequence][stream sequence], off the message
+            bool isReliable = header.Channel.GetKind() == PacketChannel.ReliableOrdered;
+            int prefixLen = (isAcknowledgment ? UDPSocket.AckBlockSize : 0) + (isReliable ? UDPSocket.ReliableSequenceSize : 0);
+
+            if (plaintextLen < prefixLen)
+                return false;
+
+            if (isAcknowledgment)
+            {
+                conn.ProcessAcknowledgment(
+                    BinaryPrimitives.ReadUInt32LittleEndian(plaintext),
+                    BinaryPrimitives.ReadUInt64LittleEndian(plaintext.Slice(sizeof(uint))));
+            }
+
+            ulong reliableSequence = 0;
+            ulong streamSequence = 0;
+
+            if (isReliable)
+            {
+                var sequences = plaintext.Slice(prefixLen - UDPSocket.ReliableSequenceSize);
+                reliableSequence = BinaryPrimitives.ReadUInt32LittleEndian(sequences);
+                streamSequence = BinaryPrimitives.ReadUInt32LittleEndian(sequences.Slice(sizeof(uint)));
+            }
+
+            plaintext = plaintext.Slice(prefixLen);
+            plaintextLen -= prefixLen;
+
             // Log packet processing details for ALL unreliable packets (first 10)
             if (header.Channel == PacketChannel.Unreliable && header.Sequence > 0 && header.Sequence <= 10)
             {
@@ -1110,24 +1373,23 @@ public sealed class UDPServer
                 }
             }
 
-            // Handle acknowledgment packets
-            if (isAcknowledgment)
+            // Standalone ACK, nothing left to route
+            if (plaintextLen == 0 && !isReliable)
             {
-                FileLogger.Log($"[SERVER] 🔓 Processing ACK packet (sequence: {header.Sequence})");
-                conn.AcknowledgeReliablePacket(header.Sequence);
+                conn.TimeoutLeft = 30f;
                 return true;
             }
 
-            var decryptedBuffer = new FlatBuffer(plaintextLen + 1);
-            decryptedBuffer.WriteBytes(plaintext.Slice(0, plaintextLen).ToArray());
+            var decryptedBuffer = CreatePlaintextBuffer(plaintext.Slice(0, plaintextLen));
 
             FileLogger.Log($"[SERVER] 🔓 Decrypted packet: {plaintextLen} bytes, Channel: {header.Channel}");
 
             // Route to appropriate queue based on channel
-            if (header.Channel == PacketChannel.ReliableOrdered)
+            if (isReliable)
             {
-                ServerMonitor.Log($"[RELIABLE] Processing reliable packet sequence {header.Sequence} from client {conn.Id}");
-                conn.ProcessReliablePacket(header.Sequence, decryptedBuffer);
+                ServerMonitor.Log($"[RELIABLE] Processing reliable packet sequence {reliableSequence} on stream {header.Channel.GetStream()} from client {conn.Id}");
+                conn.ProcessReliablePacket(reliableSequence, header.Channel.GetStream(), streamSequence, decryptedBuffer,
+                    plaintextLen, (header.Flags & PacketHeaderFlags.StreamCompressed) != 0);
                 return true;
             }
             else
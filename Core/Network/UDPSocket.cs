@@ -22,7 +22,9 @@
 */
 
 using NanoSockets;
+using System.Buffers.Binary;
 using System.Collections.Concurrent;
+using System.Numerics;
 using System.Threading.Channels;
 
 public enum ConnectionState
@@ -39,6 +41,7 @@ public enum DisconnectReason
     NegativeSequence,
     RemoteBufferTooBig,
     InvalidIntegrity,
+    ReliableDeliveryFailed,
     Other
 }
 
@@ -66,6 +69,9 @@ public class UDPSocket
 
     public bool EnableIntegrityCheck = true;
 
+    // Reliable messages are LZ4'd against the history of their stream, see ReliableStreamState
+    public bool EnableStreamCompression = true;
+
     public ushort IntegrityCheck;
 
     public DateTime IntegrityCheckSentAt;
@@ -79,6 +85,15 @@ public class UDPSocket
     public uint ClientTestValue;
     public uint ServerTestValue;
     public bool CryptoHandshakeComplete => ClientCryptoConfirmed && ServerCryptoConfirmed;
+    public bool SessionTicketIssued = false;
+
+    // Connection migration: an authenticated packet from a new address earns that address a path challenge,
+    // the connection only moves once the challenge comes back from there
+    public static readonly TimeSpan PathChallengeInterval = TimeSpan.FromMilliseconds(500);
+    public Address PathChallengeAddress;
+    public ulong PathChallengeData;
+    public DateTime PathChallengeSentAt;
+    public bool PathChallengePending => PathChallengeData != 0;
 
     internal class ReliablePacketInfo
     {
@@ -86,8 +101,14 @@ public class UDPSocket
         public DateTime SentAt;
         public int RetryCount = 0;
         public ulong Sequence;
+        public int SackSkips = 0;
+        public bool Retransmitted = false;
+        public bool Encrypted = false;
     }
 
+    // Retransmission timeout follows the measured round trip, ReliableTimeout only seeds it
+    internal RttEstimator Rtt = new RttEstimator(UDPServer.ReliableTimeout.TotalMilliseconds);
+
     internal ConcurrentDictionary<ulong, ReliablePacketInfo> ReliablePackets =
         new ConcurrentDictionary<ulong, ReliablePacketInfo>();
 
@@ -103,13 +124,51 @@ public class UDPSocket
     private ulong ReliableSequenceReceive = 0;
     private ulong UnreliableSequenceSend = 1;
 
-    // Received packet ordering buffer for reliable packets
-    private ConcurrentDictionary<ulong, FlatBuffer> ReliablePacketBuffer =
-        new ConcurrentDictionary<ulong, FlatBuffer>();
+    // Set under AckLock when an acknowledged message cannot be delivered. Disconnecting sends, which must not
+    // happen under AckLock, so Update acts on it.
+    private volatile bool ReliableDeliveryFailed;
+
+    // Reliable sequences received past ReliableSequenceReceive, on any stream
+    private readonly HashSet<ulong> ReliableReceivedAhead = new HashSet<ulong>();
+
+    // The client's FReliableReceiveWindow reach: a sequence further past the last delivered one, shared or per
+    // stream, is dropped unacknowledged, so nothing a client claims grows the reorder state beyond it
+    internal const int ReliableReceiveWindow = 256;
+
+    // Per-stream ordering: each stream numbers its messages and buffers its own out-of-order arrivals.
+    // The LZ4 histories follow the stream order: the encoder runs as sequences are handed out, the decoder
+    // as messages are delivered. Both are created on first use, the decoder by the first compressed message.
+    internal class ReliableStreamState
+    {
+        public ulong SequenceSend = 1;
+        public ulong SequenceReceive = 0;
+        public readonly Dictionary<ulong, (FlatBuffer Buffer, int Length, bool StreamCompressed)> Buffer =
+            new Dictionary<ulong, (FlatBuffer, int, bool)>();
+        public LZ4Stream Encoder;
+        public LZ4Stream Decoder;
+    }
+
+    internal static readonly int ReliableStreamCount = Enum.GetValues<ReliableStream>().Length;
+    private readonly ReliableStreamState[] ReliableStreams = CreateReliableStreams();
 
-    // Acknowledgment management
-    private ConcurrentDictionary<ulong, DateTime> PendingAcks =
-        new ConcurrentDictionary<ulong, DateTime>();
+    // Selective acknowledgment: reliable plaintexts start with their own [uint sequence], independent of
+    // the crypto sequence, and a packet flagged Acknowledgment starts with [uint cumulative][ulong sack]
+    // where bit i acknowledges cumulative + 2 + i. ACKs are delayed to cover bursts and ride on outgoing data.
+    // The reliable sequence is followed by a [uint stream sequence] that orders delivery within the stream
+    // named in the channel byte, so retransmission is shared while each stream only waits on its own gaps.
+    internal const int AckBlockSize = 12;
+    internal const int ReliableSequenceSize = 8;
+    internal const int FastRetransmitThreshold = 3;
+    internal static readonly TimeSpan AckDelay = TimeSpan.FromMilliseconds(10);
+
+    private readonly object AckLock = new object();
+
+    // Held from reading SeqTx for the header until the datagram is queued: the main loop flushes ACKs while the
+    // receive thread answers packets, and a nonce must never seal twice. Taken before AckLock, never inside it.
+    private readonly object SealLock = new object();
+    private ulong AckSack;
+    private bool AckPending;
+    private DateTime AckDueAt;
 
     private short Sequence = 1;  // Legacy sequence for old reliable system
 
@@ -119,11 +178,19 @@ public class UDPSocket
 
     private ushort NextFragmentId = 1;
 
+    // Client fragments address their offset in 16 bits, nothing a client sends can be larger than this
+    internal const int MaxFragmentedMessageSize = 64 * 1024;
+    internal const int MaxFragments = 128;
+    internal const int MaxPendingFragments = 8;
+
     internal class FragmentInfo
     {
         public FlatBuffer Buffer;
         public uint TotalSize;
-        public int Received;
+        public int ChunkSize;
+        public int FinalOffset = -1;
+        public int ChunksReceived;
+        public ulong[] Received = new ulong[MaxFragments / 64];
         public DateTime LastUpdate;
     }
 
@@ -138,14 +205,141 @@ public class UDPSocket
         return id;
     }
 
+    // Copies one [id][offset][total][chunk] fragment (type byte already consumed) into its message.
+    // Returns true with the rebuilt message positioned at 0 once every chunk has arrived. All chunks but
+    // the last carry the same size, so each one has a bit in the message's bitmap and duplicates are ignored.
+    internal unsafe bool AppendFragment(FlatBuffer data, int len, out FlatBuffer message)
+    {
+        message = default;
+
+        if (len - data.Position < 8)
+            return false;
+
+        ushort fragmentId = data.Read<ushort>();
+        ushort offset = data.Read<ushort>();
+        uint totalSize = data.Read<uint>();
+        int payloadLen = len - data.Position;
+
+        if (payloadLen <= 0 || totalSize == 0 || totalSize > MaxFragmentedMessageSize || offset + payloadLen > totalSize)
+            return false;
+
+        var fragment = Fragments.GetOrAdd(fragmentId, _ => BeginFragment(totalSize));
+
+        lock (fragment)
+        {
+            // Completed or discarded while this fragment waited for the lock
+            if (fragment.Buffer.Data == null)
+                return false;
+
+            if (fragment.TotalSize != totalSize)
+            {
+                DiscardFragment(fragmentId, fragment);
+                return false;
+            }
+
+            bool final = offset + payloadLen == totalSize;
+
+            if (final)
+            {
+                if (fragment.FinalOffset >= 0)
+                    return false;
+
+                fragment.FinalOffset = offset;
+            }
+            else
+            {
+                if (fragment.ChunkSize == 0)
+                    fragment.ChunkSize = payloadLen;
+
+                int index = offset / fragment.ChunkSize;
+
+                if (payloadLen != fragment.ChunkSize || offset % fragment.ChunkSize != 0 || index >= MaxFragments)
+                {
+                    DiscardFragment(fragmentId, fragment);
+                    return false;
+                }
+
+                ulong bit = 1UL << (index & 63);
+
+                if ((fragment.Received[index >> 6] & bit) != 0)
+                    return false;
+
+                fragment.Received[index >> 6] |= bit;
+                fragment.ChunksReceived++;
+            }
+
+            Buffer.MemoryCopy(data.Data + data.Position, fragment.Buffer.Data + offset, fragment.Buffer.Capacity - offset, payloadLen);
+            fragment.LastUpdate = DateTime.UtcNow;
+
+            if (fragment.FinalOffset < 0)
+                return false;
+
+            if (fragment.FinalOffset > 0)
+            {
+                if (fragment.ChunkSize == 0)
+                    return false;
+
+                if (fragment.FinalOffset % fragment.ChunkSize != 0)
+                {
+                    DiscardFragment(fragmentId, fragment);
+                    return false;
+                }
+
+                if (fragment.ChunksReceived < fragment.FinalOffset / fragment.ChunkSize)
+                    return false;
+            }
+
+            Fragments.TryRemove(new KeyValuePair<ushort, FragmentInfo>(fragmentId, fragment));
+            message = fragment.Buffer;
+            fragment.Buffer = default;
+            message.RestorePosition(0);
+
+            return true;
+        }
+    }
+
+    private FragmentInfo BeginFragment(uint totalSize)
+    {
+        // A peer opening message after message never completes any, the stalest partial one makes room
+        while (Fragments.Count >= MaxPendingFragments)
+        {
+            var oldest = Fragments.OrderBy(kv => kv.Value.LastUpdate).FirstOrDefault();
+
+            if (oldest.Value == null)
+                break;
+
+            lock (oldest.Value)
+                DiscardFragment(oldest.Key, oldest.Value);
+        }
+
+        return new FragmentInfo
+        {
+            Buffer = new FlatBuffer((int)totalSize),
+            TotalSize = totalSize,
+            LastUpdate = DateTime.UtcNow
+        };
+    }
+
+    // Caller holds the fragment's lock
+    private unsafe void DiscardFragment(ushort fragmentId, FragmentInfo fragment)
+    {
+        Fragments.TryRemove(new KeyValuePair<ushort, FragmentInfo>(fragmentId, fragment));
+
+        if (fragment.Buffer.Data != null)
+        {
+            fragment.Buffer.Free();
+            fragment.Buffer = default;
+        }
+    }
+
     internal void CleanupFragments(TimeSpan timeout)
     {
         foreach (var kv in Fragments)
         {
-            if (DateTime.UtcNow - kv.Value.LastUpdate > timeout)
+            lock (kv.Value)
             {
-                kv.Value.Buffer.Free();
-                Fragments.TryRemove(kv.Key, out _);
+                if (DateTime.UtcNow - kv.Value.LastUpdate > timeout)
+                    DiscardFragment(kv.Key, kv.Value);
             }
         }
     }
@@ -211,28 +405,108 @@ public class UDPSocket
         var payload = new FlatBuffer(networkPacket.Size);
         networkPacket.Serialize(ref payload);
 
+        unsafe
+        {
+            SendEncrypted(new ReadOnlySpan<byte>(payload.Data, payload.Position), reliable, networkPacket.Stream);
+        }
+
+        payload.Free();
+    }
+
+    private static ReliableStreamState[] CreateReliableStreams()
+    {
+        var streams = new ReliableStreamState[ReliableStreamCount];
+
+        for (int i = 0; i < streams.Length; i++)
+            streams[i] = new ReliableStreamState();
+
+        return streams;
+    }
+
+    private void SendEncrypted(ReadOnlySpan<byte> message, bool reliable, ReliableStream stream = ReliableStream.Default)
+    {
+        lock (SealLock)
+            SealAndSend(message, reliable, stream);
+    }
+
+    // Caller holds SealLock
+    private void SealAndSend(ReadOnlySpan<byte> message, bool reliable, ReliableStream stream)
+    {
         var header = new PacketHeader
         {
             ConnectionId = Session.ConnectionId,
-            Channel = reliable ? PacketChannel.ReliableOrdered : PacketChannel.Unreliable,
-            Flags = PacketHeaderFlags.Encrypted | PacketHeaderFlags.AEAD_ChaCha20Poly1305,
+            Channel = reliable ? PacketChannel.ReliableOrdered.WithStream(stream) : PacketChannel.Unreliable,
+            Flags = PacketHeaderFlags.Encrypted | Session.AeadFlag,
             Sequence = Session.SeqTx // This will be the sequence used for encryption
         };
 
-        var aad = header.GetAAD();
-        Span<byte> result = stackalloc byte[payload.Position + 1024]; // Extra space for compression overhead
+        // Plaintext: [ack block if one is pending][reliable and stream sequences on the reliable channel][message],
+        // with room for a message the stream encoder could not shrink
+        Span<byte> plaintext = stackalloc byte[AckBlockSize + ReliableSequenceSize + message.Length + message.Length / 255 + 16];
+        int prefixLen;
+        int bodyLen = message.Length;
+        ulong reliableSequence = 0;
 
-        unsafe
+        lock (AckLock)
         {
-            if (Session.EncryptPayloadWithCompression(new ReadOnlySpan<byte>(payload.Data, payload.Position), aad, result, out int resultLen, out bool wasCompressed))
+            prefixLen = WriteAckBlock(plaintext);
+
+            if (prefixLen > 0)
+                header.Flags |= PacketHeaderFlags.Acknowledgment;
+
+            if (reliable)
             {
-                if (wasCompressed)
-                    header.Flags |= PacketHeaderFlags.Compressed;
+                var target = ReliableStreams[(int)stream];
+                reliableSequence = ReliableSequenceSend++;
+                BinaryPrimitives.WriteUInt32LittleEndian(plaintext.Slice(prefixLen), (uint)reliableSequence);
+                BinaryPrimitives.WriteUInt32LittleEndian(plaintext.Slice(prefixLen + sizeof(uint)), (uint)target.SequenceSend++);
+                prefixLen += ReliableSequenceSize;
+
+                // Encoded under the lock, the history has to see messages in the order their stream sequences were handed out
+                if (!EnableStreamCompression)
+                {
+                    // The client keeps appending what we send raw, a later restart has to begin from an empty history
+                    target.Encoder?.Reset();
+                }
+                else if (message.Length > 0)
+                {
+                    int encodedLen = EncodeStreamMessage(target, message, plaintext.Slice(prefixLen));
+
+                    if (encodedLen > 0)
+                    {
+                        bodyLen = encodedLen;
+                        header.Flags |= PacketHeaderFlags.StreamCompressed;
+                    }
+                }
+            }
+        }
 
-                int totalSize = PacketHeader.Size + resultLen;
+        // A standalone ACK whose block was already picked up by another packet
+        if (prefixLen == 0 && message.Length == 0)
+            return;
+
+        bool streamCompressed = (header.Flags & PacketHeaderFlags.StreamCompressed) != 0;
+
+        if (!streamCompressed)
+            message.CopyTo(plaintext.Slice(prefixLen));
+
+        plaintext = plaintext.Slice(0, prefixLen + bodyLen);
+
+        Span<byte> result = stackalloc byte[plaintext.Length + SecureSession.TagSize];
+
+        // Stream-compressed plaintexts are opaque to a dictionary and never packet-compressed, so they stay out of captures
+        if (PacketCapture.IsEnabled && !streamCompressed)
+            PacketCapture.Record(plaintext);
+
+        unsafe
+        {
+            // Compression happens ahead of encryption and may set the Compressed flag on the header
+            if (Session.EncryptPayloadWithCompression(plaintext, ref header, result, out int resultLen))
+            {
+                int trailerLen = Session.ChecksumEnabled ? sizeof(uint) : 0;
+                int totalSize = PacketHeader.Size + resultLen + trailerLen;
                 var packet = new FlatBuffer(totalSize);
 
-                // Serialize updated header with compression flag
                 byte[] headerBytes = new byte[PacketHeader.Size];
                 fixed (byte* headerPtr = headerBytes)
                 {
@@ -241,21 +515,51 @@ public class UDPSocket
                 packet.WriteBytes(headerBytes);
                 packet.WriteBytes(result.Slice(0, resultLen).ToArray());
 
-                if (reliable)
-                {
-                    short seq = Sequence++;
-                    if (Sequence == short.MaxValue)
-                        Sequence = 1;
+                // The client checks the CRC32C trailer before it tries the AEAD, unless both sides agreed to rely on the tag
+                if (trailerLen > 0)
+                    packet.Write(CRC32C.Compute(packet.Data, packet.Position));
 
-                    AddReliablePacket(seq, packet);
-                }
+                if (reliable)
+                    AddReliablePacketNew(reliableSequence, packet);
 
-                UDPServer.Send(ref packet, packet.Position, this, !reliable);
+                UDPServer.Send(ref packet, packet.Position, this, !reliable, sign: false);
                 if (!reliable) packet.Free();
             }
         }
+    }
 
-        payload.Free();
+    // Caller holds AckLock. Returns the encoded length, or 0 to send the message as is.
+    private static int EncodeStreamMessage(ReliableStreamState stream, ReadOnlySpan<byte> message, Span<byte> destination)
+    {
+        stream.Encoder ??= new LZ4Stream();
+
+        // The client creates its decoder on the first compressed message, so an empty history always opens with one
+        bool fresh = stream.Encoder.HistoryLength == 0;
+        int capacity = fresh ? destination.Length : Math.Min(destination.Length, message.Length - 1);
+        int encodedLen = stream.Encoder.Compress(message, destination.Slice(0, capacity));
+
+        if (encodedLen <= 0 && fresh)
+            stream.Encoder.Reset();
+
+        return encodedLen;
+    }
+
+    /// <summary>
+    /// Rotates the session keys. The stream encoders restart along with them, which the client's
+    /// decoders follow without being told: they still hold everything a fresh encoder can refer to.
+    /// </summary>
+    public bool Rekey()
+    {
+        lock (SealLock)
+        {
+            lock (AckLock)
+            {
+                foreach (var stream in ReliableStreams)
+                    stream.Encoder?.Reset();
+            }
+
+            return Session.PerformRekey();
+        }
     }
 
     private void SendLegacy(INetworkPacket networkPacket, bool reliable)
@@ -340,13 +644,19 @@ public class UDPSocket
             }
         }
 
-        float resendMs = Math.Max(Ping, (uint)UDPServer.ReliableTimeout.TotalMilliseconds);
+        if (ReliableDeliveryFailed)
+        {
+            Disconnect(DisconnectReason.ReliableDeliveryFailed);
+
+            return false;
+        }
 
         // Handle retransmission for new reliable system
+        var now = DateTime.UtcNow;
         var reliablePacketsToRetry = new List<KeyValuePair<ulong, ReliablePacketInfo>>();
         foreach (var kv in ReliablePackets)
         {
-            if ((DateTime.UtcNow - kv.Value.SentAt).TotalMilliseconds >= resendMs)
+            if ((now - kv.Value.SentAt).TotalMilliseconds >= Rtt.GetRetransmitTimeoutMs(kv.Value.RetryCount))
             {
                 reliablePacketsToRetry.Add(kv);
             }
@@ -356,18 +666,21 @@ public class UDPSocket
         {
             kv.Value.RetryCount++;
 
-            // Max retry attempts before giving up
-            if (kv.Value.RetryCount >= 10)
+            // Max retry attempts before giving up: the stream cannot go on with a hole, so neither can the connection
+            if (kv.Value.RetryCount >= UDPServer.MaxRetries)
             {
                 ReliablePackets.TryRemove(kv.Key, out var removedInfo);
                 removedInfo?.Buffer.Free();
-                ServerMonitor.Log($"Reliable packet {kv.Key} dropped after 10 retries");
-                continue;
+                ServerMonitor.Log($"Reliable packet {kv.Key} abandoned after {UDPServer.MaxRetries} retries, disconnecting client {Id}");
+                Disconnect(DisconnectReason.ReliableDeliveryFailed);
+
+                return false;
             }
 
-            // Resend the packet
-            UDPServer.Send(ref kv.Value.Buffer, kv.Value.Buffer.Position, this, false);
+            // Resend the packet, its ACK can no longer be timed (Karn)
+            UDPServer.Send(ref kv.Value.Buffer, kv.Value.Buffer.Position, this, false, !kv.Value.Encrypted);
             kv.Value.SentAt = DateTime.UtcNow;
+            kv.Value.Retransmitted = true;
 
             if (kv.Value.RetryCount > 3)
             {
@@ -375,6 +688,8 @@ public class UDPSocket
             }
         }
 
+        FlushAcknowledgment();
+
         if (UnreliableBuffer.Position > 0)
             Send(ref UnreliableBuffer);
 
@@ -396,6 +711,56 @@ public class UDPSocket
         }
     }
 
+    // Starts (or repeats, at most once per PathChallengeInterval) the challenge for a new address.
+    // A different address supersedes the one in flight, the client may have moved again.
+    public bool BeginPathChallenge(Address address, out ulong challenge)
+    {
+        var now = DateTime.UtcNow;
+        challenge = 0;
+
+        if (PathChallengePending && PathChallengeAddress.Equals(address))
+        {
+            if (now - PathChallengeSentAt < PathChallengeInterval)
+                return false;
+        }
+        else
+        {
+            Span<byte> random = stackalloc byte[sizeof(ulong)];
+
+            do
+            {
+                System.Security.Cryptography.RandomNumberGenerator.Fill(random);
+                PathChallengeData = BinaryPrimitives.ReadUInt64LittleEndian(random);
+            }
+            while (PathChallengeData == 0);
+
+            PathChallengeAddress = address;
+        }
+
+        PathChallengeSentAt = now;
+        challenge = PathChallengeData;
+        return true;
+    }
+
+    public bool TryCompletePathChallenge(Address address, ulong response)
+    {
+        if (!PathChallengePending || !PathChallengeAddress.Equals(address) || response != PathChallengeData)
+            return false;
+
+        PathChallengeData = 0;
+        PathChallengeAddress = default;
+        return true;
+    }
+
+    // The session, its keys and every sequence carry over, only the path changes. Its round trip is unknown,
+    // so the retransmission timer starts over from the configured seed.
+    internal void MigrateTo(Address address)
+    {
+        RemoteAddress = address;
+        TimeoutLeft = 30f;
+        Rtt = new RttEstimator(UDPServer.ReliableTimeout.TotalMilliseconds);
+    }
+
     internal void OnDisconnect()
     {
         if (State != ConnectionState.Disconnected)
@@ -443,7 +808,8 @@ public class UDPSocket
             Buffer = buffer,
             SentAt = DateTime.UtcNow,
             Sequence = sequenceId,
-            RetryCount = 0
+            RetryCount = 0,
+            Encrypted = true
         };
 
         return ReliablePackets.TryAdd(sequenceId, info);
@@ -457,52 +823,203 @@ public class UDPSocket
         }
     }
 
-        public void SendAcknowledgment(ulong sequence)
+    // Receive thread. Gaps, duplicates and the packet that fills a gap are acknowledged right away so the
+    // client recovers quickly, in-order traffic waits for the delayed ACK to cover the whole burst.
+    // Acknowledgment follows the shared reliable sequence, delivery only waits on the packet's own stream.
+    // Length is the message size within the buffer, its capacity by default; stream-compressed messages are decoded on delivery.
+    public void ProcessReliablePacket(ulong sequence, ReliableStream stream, ulong streamSequence, FlatBuffer buffer,
+        int length = -1, bool streamCompressed = false)
     {
-        // Use original legacy ACK system that worked - break ulong into two uint
-        var buffer = new FlatBuffer(9);
-        buffer.Write(PacketType.Ack);
-        buffer.Write((uint)(sequence & 0xFFFFFFFF));        // Low 32 bits
-        buffer.Write((uint)((sequence >> 32) & 0xFFFFFFFF)); // High 32 bits
+        lock (AckLock)
+        {
+            bool inOrder = sequence == ReliableSequenceReceive + 1;
+            bool immediate = !inOrder || ReliableReceivedAhead.Count > 0;
 
-        UDPServer.Send(ref buffer, buffer.Position, this, false);
+            if (sequence <= ReliableSequenceReceive || (int)stream >= ReliableStreamCount || ReliableReceivedAhead.Contains(sequence))
+            {
+                // Duplicate or old packet, discard
+                buffer.Free();
+            }
+            else if (sequence - ReliableSequenceReceive > ReliableReceiveWindow ||
+                !DeliverReliablePacket(ReliableStreams[(int)stream], streamSequence, buffer, length < 0 ? buffer.Capacity : length, streamCompressed))
+            {
+                // Dropped unacknowledged, the client resends it once the window has moved on
+                buffer.Free();
+            }
+            else
+            {
+                ReliableReceivedAhead.Add(sequence);
+
+                while (ReliableReceivedAhead.Remove(ReliableSequenceReceive + 1))
+                    ReliableSequenceReceive++;
+            }
+
+            ScheduleAcknowledgment(immediate);
+        }
     }
 
-    public void ProcessReliablePacket(ulong sequence, FlatBuffer buffer)
+    // Caller holds AckLock. Returns false, leaving the buffer to the caller, when the stream's reorder window
+    // cannot hold it yet; any other outcome takes the buffer over.
+    private bool DeliverReliablePacket(ReliableStreamState stream, ulong sequence, FlatBuffer buffer, int length, bool streamCompressed)
     {
-        // Send acknowledgment immediately
-        SendAcknowledgment(sequence);
-
-        // Check if this is the next expected sequence
-        if (sequence == ReliableSequenceReceive + 1)
+        if (sequence == stream.SequenceReceive + 1)
         {
             // Process this packet and any buffered consecutive ones
-            ReliableSequenceReceive = sequence;
-            if (!ReliableEventQueue.Writer.TryWrite(buffer))
-            {
-                buffer.Free();
-            }
+            stream.SequenceReceive = sequence;
+            EnqueueReliableMessage(stream, buffer, length, streamCompressed);
 
-            // Check for buffered packets
-            while (ReliablePacketBuffer.TryRemove(ReliableSequenceReceive + 1, out var nextBuffer))
+            while (stream.Buffer.Remove(stream.SequenceReceive + 1, out var next))
             {
-                ReliableSequenceReceive++;
-                if (!ReliableEventQueue.Writer.TryWrite(nextBuffer))
-                {
-                    nextBuffer.Free();
-                }
+                stream.SequenceReceive++;
+                EnqueueReliableMessage(stream, next.Buffer, next.Length, next.StreamCompressed);
             }
         }
-        else if (sequence > ReliableSequenceReceive + 1)
+        else if (sequence > stream.SequenceReceive + 1)
         {
-            // Buffer out-of-order packet
-            ReliablePacketBuffer.TryAdd(sequence, buffer);
+            if (sequence - stream.SequenceReceive > ReliableReceiveWindow)
+                return false;
+
+            // Buffer out-of-order packet, it only holds back later messages on the same stream
+            if (!stream.Buffer.TryAdd(sequence, (buffer, length, streamCompressed)))
+                buffer.Free();
         }
         else
         {
-            // Duplicate or old packet, discard
             buffer.Free();
         }
+
+        return true;
+    }
+
+    // Caller holds AckLock. Delivery order is the stream order, the only point where the decoder can run.
+    // Once the client has started compressing, raw messages go through the decoder too, to join its history.
+    private unsafe void EnqueueReliableMessage(ReliableStreamState stream, FlatBuffer buffer, int length, bool streamCompressed)
+    {
+        if (streamCompressed)
+        {
+            stream.Decoder ??= new LZ4Stream();
+            bool decoded = stream.Decoder.TryDecompress(new ReadOnlySpan<byte>(buffer.Data, length), out var message);
+            buffer.Free();
+
+            // The sequence is already acknowledged, the message is lost for good and the connection has to go
+            if (!decoded)
+            {
+                ServerMonitor.Log($"[RELIABLE] Failed to decode a stream-compressed message from client {Id}");
+                ReliableDeliveryFailed = true;
+                return;
+            }
+
+            buffer = UDPServer.CreatePlaintextBuffer(message);
+        }
+        else
+        {
+            stream.Decoder?.Append(new ReadOnlySpan<byte>(buffer.Data, length));
+        }
+
+        if (!ReliableEventQueue.Writer.TryWrite(buffer))
+            buffer.Free();
+    }
+
+    // Caller holds AckLock. The SACK mask covers the 64 sequences past the first hole.
+    private void ScheduleAcknowledgment(bool immediate)
+    {
+        AckSack = 0;
+
+        foreach (var sequence in ReliableReceivedAhead)
+        {
+            if (sequence < ReliableSequenceReceive + 2)
+                continue;
+
+            ulong distance = sequence - ReliableSequenceReceive - 2;
+
+            if (distance < 64)
+                AckSack |= 1UL << (int)distance;
+        }
+
+        var now = DateTime.UtcNow;
+
+        if (!AckPending)
+        {
+            AckPending = true;
+            AckDueAt = now + AckDelay;
+        }
+
+        if (immediate)
+            AckDueAt = now;
+    }
+
+    // Caller holds AckLock
+    private int WriteAckBlock(Span<byte> output)
+    {
+        if (!AckPending)
+            return 0;
+
+        BinaryPrimitives.WriteUInt32LittleEndian(output, (uint)ReliableSequenceReceive);
+        BinaryPrimitives.WriteUInt64LittleEndian(output.Slice(4), AckSack);
+        AckPending = false;
+
+        return AckBlockSize;
+    }
+
+    internal void FlushAcknowledgment(bool force = false)
+    {
+        lock (AckLock)
+        {
+            if (!AckPending || (!force && DateTime.UtcNow < AckDueAt))
+                return;
+        }
+
+        if (!CryptoHandshakeComplete)
+            return;
+
+        // Nothing outgoing picked the ACK up in time, it goes out on its own
+        SendEncrypted(ReadOnlySpan<byte>.Empty, false);
+    }
+
+    internal void ProcessAcknowledgment(uint cumulative, ulong sack)
+    {
+        ulong acked = cumulative;
+        ulong highestAcked = sack != 0 ? acked + 2 + (ulong)(63 - BitOperations.LeadingZeroCount(sack)) : acked;
+        var now = DateTime.UtcNow;
+
+        // The newest packet this ACK releases is the one its timing reflects
+        ulong sampleSequence = 0;
+        DateTime sampleSentAt = default;
+        bool sampleValid = false;
+
+        foreach (var kv in ReliablePackets)
+        {
+            ulong sequence = kv.Key;
+            ulong distance = sequence - acked - 2;
+
+            if (sequence <= acked || (sequence >= acked + 2 && distance < 64 && ((sack >> (int)distance) & 1) != 0))
+            {
+                if (ReliablePackets.TryRemove(sequence, out var info))
+                {
+                    if (sequence > sampleSequence)
+                    {
+                        sampleSequence = sequence;
+                        sampleSentAt = info.SentAt;
+                        sampleValid = !info.Retransmitted;
+                    }
+
+                    info.Buffer.Free();
+                }
+
+                continue;
+            }
+
+            // Later packets got through, this one is most likely lost: resend without waiting for the timeout
+            if (sequence < highestAcked && ++kv.Value.SackSkips == FastRetransmitThreshold)
+            {
+                UDPServer.Send(ref kv.Value.Buffer, kv.Value.Buffer.Position, this, false, !kv.Value.Encrypted);
+                kv.Value.SentAt = now;
+                kv.Value.Retransmitted = true;
+            }
+        }
+
+        if (sampleValid)
+            Rtt.AddSample((now - sampleSentAt).TotalMilliseconds);
     }
 
     public void ProcessPacket()
@@ -536,6 +1053,7 @@ public class UDPSocket
 
     private void ProcessGamePacket(FlatBuffer buffer, bool isReliable)
     {
+        int messageStart = buffer.Position;
         PacketType packetType = (PacketType)buffer.Read<byte>();
 
         // Log game packet processing for first few packets
@@ -591,6 +1109,40 @@ public class UDPSocket
                 }
                 break;
 
+            case PacketType.Fragment:
+                {
+                    // Client fragments are encrypted one by one, reassemble once ordering/decryption is done
+                    if (AppendFragment(buffer, buffer.Capacity, out var message))
+                    {
+                        try
+                        {
+                            ProcessGamePacket(message, isReliable);
+                        }
+                        finally
+                        {
+                            message.Free();
+                        }
+                    }
+                }
+                break;
+
+            case PacketType.Batch:
+                {
+                    // Coalesced client messages: [Batch]([ushort length][message])*, each routed as if it arrived alone
+                    while (buffer.Position + sizeof(ushort) <= buffer.Capacity)
+                    {
+                        int length = buffer.Read<ushort>();
+                        int start = buffer.Position;
+
+                        if (length == 0 || start + length > buffer.Capacity)
+                            break;
+
+                        ProcessGamePacket(buffer, isReliable);
+                        buffer.RestorePosition(start + length);
+                    }
+                }
+                break;
+
             case PacketType.ReliableHandshake:
                 {
                     // Handle reliable handshake packet
@@ -624,8 +1176,8 @@ public class UDPSocket
 
                     if (PlayerController.TryGet(Id, out var controller))
                     {
-                        // Reset buffer position to start (PacketHandler expects to read from position 0)
-                        buffer.RestorePosition(0);
+                        // PacketHandler expects to read from the start of the message
+                        buffer.RestorePosition(messageStart);
 
                         PacketHandler.HandlePacket(controller, ref buffer, clientPacket);
                         FileLogger.Log($"[SERVER] ✅ Routed {clientPacket} to PacketHandler");
@@ -4,7 +4,7 @@ using System.Runtime.CompilerServices;
 
 public partial struct ConnectionAcceptedPacket: INetworkPacket
 {
-    public int Size => 53;
+    public int Size => 58;
 
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
     public void Serialize(ref FlatBuffer buffer)
@@ -13,6 +13,8 @@ public partial struct ConnectionAcceptedPacket: INetworkPacket
         buffer.Write(Id);
         buffer.WriteBytes(ServerPublicKey);
         buffer.WriteBytes(Salt);
+        buffer.Write(DictionaryId);
+        buffer.Write(Options);
     }
 
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
@@ -21,5 +23,7 @@ public partial struct ConnectionAcceptedPacket: INetworkPacket
         Id = buffer.Read<uint>();
         ServerPublicKey = buffer.ReadBytes(32);
         Salt = buffer.ReadBytes(16);
+        DictionaryId = buffer.Read<uint>();
+        Options = buffer.Read<byte>();
     }
 }
@@ -5,6 +5,7 @@ using System.Runtime.CompilerServices;
 public partial struct RemoveEntityPacket: INetworkPacket
 {
     public int Size => 7;
+    public ReliableStream Stream => ReliableStream.World;
 
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
     public void Serialize(ref FlatBuffer buffer)
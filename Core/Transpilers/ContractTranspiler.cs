@@ -134,6 +134,13 @@ public class ContractTranspiler : AbstractTranspiler
         }
     }
 
+    // Packets on the default reliable stream rely on the INetworkPacket default
+    private static void GenerateStream(StreamWriter writer, ContractAttribute contractAttribute)
+    {
+        if (contractAttribute.LayerType == PacketLayerType.Server && contractAttribute.Stream != ReliableStream.Default)
+            writer.WriteLine($"    public ReliableStream Stream => ReliableStream.{contractAttribute.Stream};");
+    }
+
     private static void GenerateSerialize(StreamWriter writer, Type contract, FieldInfo[] fields, ContractAttribute contractAttribute)
     {
         var rawName = contract.Name.Replace("Packet", "");
@@ -184,6 +191,7 @@ public class ContractTranspiler : AbstractTranspiler
             }
 
             writer.WriteLine($"    public int Size => {totalBytes};");
+            GenerateStream(writer, contractAttribute);
             writer.WriteLine();
 
             // Serialize
@@ -304,6 +312,7 @@ public class ContractTranspiler : AbstractTranspiler
         {
             writer.WriteLine(contractAttribute.PacketType != PacketType.None
                 ? "    public int Size => 1;" : "    public int Size => 3;");
+            GenerateStream(writer, contractAttribute);
             writer.WriteLine();
             writer.WriteLine($"    [MethodImpl(MethodImplOptions.AggressiveInlining)]");
             writer.WriteLine($"    public void Serialize(ref FlatBuffer buffer)");
@@ -78,6 +78,7 @@ public class UnrealTranspiler : AbstractTranspiler
             cppContent = cppContent.Replace("//%INCLUDES%", GenerateIncludes());
             cppContent = cppContent.Replace("//%FUNCTIONS%", GenerateSendFunctions());
             cppContent = cppContent.Replace("//%DATASWITCH%", GenerateParsedDataSwitch());
+            cppContent = cppContent.Replace("//%EVENTSWITCH%", GenerateEventSwitch());
             File.WriteAllText(cppFilePathClient, cppContent);
         }
     }
@@ -119,7 +120,7 @@ public class UnrealTranspiler : AbstractTranspiler
         writer.WriteLine();
         writer.WriteLine("#include \"CoreMinimal.h\"");
         writer.WriteLine("#include \"Network/UDPClient.h\"");
-        writer.WriteLine("#include \"Network/UFlatBuffer.h\"");
+        writer.WriteLine("#include \"Network/FlatBuffer.h\"");
 
         if (attribute.LayerType == PacketLayerType.Server)
             writer.WriteLine("#include \"Network/ServerPackets.h\"");
@@ -158,24 +159,31 @@ public class UnrealTranspiler : AbstractTranspiler
         writer.WriteLine($"    int32 GetSize() const {{ return {totalBytes}; }}");
         writer.WriteLine();
 
+        // Reliable client packets carry the stream they are ordered on, callers hand it to UDPClient::Send
+        if (attribute.LayerType == PacketLayerType.Client && attribute.Flags.HasFlag(ContractPacketFlags.Reliable))
+        {
+            writer.WriteLine($"    static constexpr EReliableStream Stream = EReliableStream::{attribute.Stream};");
+            writer.WriteLine();
+        }
+
         if(attribute.LayerType == PacketLayerType.Client)
         {
-            writer.WriteLine($"    void Serialize(UFlatBuffer* Buffer)");
+            writer.WriteLine($"    void Serialize(FFlatBufferView& Buffer)");
             writer.WriteLine("    {");
 
             if (attribute.PacketType != PacketType.None)
-                writer.WriteLine($"        Buffer->Write<uint8>(static_cast<uint8>(EPacketType::{attribute.PacketType}));");
+                writer.WriteLine($"        Buffer.Write<uint8>(static_cast<uint8>(EPacketType::{attribute.PacketType}));");
             else
             {
                 if (attribute.Flags.HasFlag(ContractPacketFlags.Reliable))
-                    writer.WriteLine("        Buffer->Write<uint8>(static_cast<uint8>(EPacketType::Reliable));");
+                    writer.WriteLine("        Buffer.Write<uint8>(static_cast<uint8>(EPacketType::Reliable));");
                 else
-                    writer.WriteLine("        Buffer->Write<uint8>(static_cast<uint8>(EPacketType::Unreliable));");
+                    writer.WriteLine("        Buffer.Write<uint8>(static_cast<uint8>(EPacketType::Unreliable));");
 
                 if(attribute.LayerType == PacketLayerType.Server)
-                    writer.WriteLine($"        Buffer->Write<uint8>(static_cast<uint8>(EServerPackets::{rawName}));");
+                    writer.WriteLine($"        Buffer.Write<uint8>(static_cast<uint8>(EServerPackets::{rawName}));");
                 else
-                    writer.WriteLine($"        Buffer->Write<uint16>(static_cast<uint16>(EClientPackets::{rawName}));");
+                    writer.WriteLine($"        Buffer.Write<uint16>(static_cast<uint16>(EClientPackets::{rawName}));");
             }
 
             foreach (var field in fields)
@@ -191,7 +199,7 @@ public class UnrealTranspiler : AbstractTranspiler
 
         if (attribute.LayerType == PacketLayerType.Server && fields.Length > 0)
         {
-            writer.WriteLine($"    void Deserialize(UFlatBuffer* Buffer)");
+            writer.WriteLine($"    void Deserialize(FFlatBufferView& Buffer)");
             writer.WriteLine("    {");
             //writer.WriteLine("        try{");
 
@@ -246,41 +254,41 @@ public class UnrealTranspiler : AbstractTranspiler
 
     private static string GetSerializeLine(string type, string name, int byteCount) => type.ToLower() switch
     {
-        "integer" or "int" or "int32" => $"        Buffer->Write<int32>({name});",
-        "uint" => $"        Buffer->Write<uint32>(static_cast<uint32>({name}));",
-        "ushort" => $"        Buffer->Write<uint16>(static_cast<uint16>({name}));",
-        "short" => $"        Buffer->Write<int16>(static_cast<int16>({name}));",
-        "byte" => $"        Buffer->Write<uint8>({name});",
-        "float" => $"        Buffer->Write<float>({name});",
-        "long" => $"        Buffer->Write<int64>({name});",
-        "ulong" => $"        Buffer->Write<int64>(static_cast<int64>({name}));",
-        "bool" or "boolean" => $"        Buffer->Write<bool>({name});",
-        "decimal" => $"        Buffer->Write<float>({name});",
-        "fvector" => $"        Buffer->Write<FVector>({name});", // Convert to lowercase for case-insensitive matching
-        "frotator" => $"        Buffer->Write<FRotator>({name});", // Convert to lowercase for case-insensitive matching
-        "id" => $"        Buffer->WriteInt32(UBase36::Base36ToInt({name}));",
-        "str" or "string" => $"        Buffer->WriteString({name});",
-        "byte[]" => $"        Buffer->WriteBytes({name}.GetData(), {byteCount});",
+        "integer" or "int" or "int32" => $"        Buffer.Write<int32>({name});",
+        "uint" => $"        Buffer.Write<uint32>(static_cast<uint32>({name}));",
+        "ushort" => $"        Buffer.Write<uint16>(static_cast<uint16>({name}));",
+        "short" => $"        Buffer.Write<int16>(static_cast<int16>({name}));",
+        "byte" => $"        Buffer.Write<uint8>({name});",
+        "float" => $"        Buffer.Write<float>({name});",
+        "long" => $"        Buffer.Write<int64>({name});",
+        "ulong" => $"        Buffer.Write<int64>(static_cast<int64>({name}));",
+        "bool" or "boolean" => $"        Buffer.Write<bool>({name});",
+        "decimal" => $"        Buffer.Write<float>({name});",
+        "fvector" => $"        Buffer.Write<FVector>({name});", // Convert to lowercase for case-insensitive matching
+        "frotator" => $"        Buffer.Write<FRotator>({name});", // Convert to lowercase for case-insensitive matching
+        "id" => $"        Buffer.WriteInt32(UBase36::Base36ToInt({name}));",
+        "str" or "string" => $"        Buffer.WriteString({name});",
+        "byte[]" => $"        Buffer.WriteBytes({name}.GetData(), {byteCount});",
         _ => $"    // Unsupported type: {type}",
     };
 
     private static string GetDeserializeLine(string type, string name, int byteCount) => type.ToLower() switch
     {
-        "integer" or "int" or "int32" => $"        {name} = Buffer->Read<int32>();",
-        "uint" => $"        {name} = static_cast<int32>(Buffer->Read<uint32>());",
-        "ushort" => $"        {name} = static_cast<int32>(Buffer->Read<uint16>());",
-        "short" => $"        {name} = static_cast<int32>(Buffer->Read<int16>());",
-        "byte" => $"        {name} = Buffer->Read<uint8>();",
-        "float" => $"        {name} = Buffer->Read<float>();",
-        "long" => $"        {name} = Buffer->Read<int64>();",
-        "ulong" => $"        {name} = Buffer->Read<int64>();",
-        "bool" or "boolean" => $"        {name} = Buffer->Read<bool>();",
-        "decimal" => $"        {name} = Buffer->Read<float>();",
-        "fvector" => $"        {name} = Buffer->Read<FVector>();", // Convert to lowercase for case-insensitive matching
-        "frotator" => $"        {name} = Buffer->Read<FRotator>();", // Convert to lowercase for case-insensitive matching
-        "id" => $"        {name} = UBase36::IntToBase36(Buffer->ReadInt32());",
-        "str" or "string" => $"        {name} = Buffer->ReadString();",
-        "byte[]" => $"        {name}.SetNumUninitialized({byteCount});\n        Buffer->ReadBytes({name}.GetData(), {byteCount});",
+        "integer" or "int" or "int32" => $"        {name} = Buffer.Read<int32>();",
+        "uint" => $"        {name} = static_cast<int32>(Buffer.Read<uint32>());",
+        "ushort" => $"        {name} = static_cast<int32>(Buffer.Read<uint16>());",
+        "short" => $"        {name} = static_cast<int32>(Buffer.Read<int16>());",
+        "byte" => $"        {name} = Buffer.Read<uint8>();",
+        "float" => $"        {name} = Buffer.Read<float>();",
+        "long" => $"        {name} = Buffer.Read<int64>();",
+        "ulong" => $"        {name} = Buffer.Read<int64>();",
+        "bool" or "boolean" => $"        {name} = Buffer.Read<bool>();",
+        "decimal" => $"        {name} = Buffer.Read<float>();",
+        "fvector" => $"        {name} = Buffer.Read<FVector>();", // Convert to lowercase for case-insensitive matching
+        "frotator" => $"        {name} = Buffer.Read<FRotator>();", // Convert to lowercase for case-insensitive matching
+        "id" => $"        {name} = UBase36::IntToBase36(Buffer.ReadInt32());",
+        "str" or "string" => $"        {name} = Buffer.ReadString();",
+        "byte[]" => $"        {name}.SetNumUninitialized({byteCount});\n        Buffer.ReadBytes({name}.GetData(), {byteCount});",
         _ => $"    // Unsupported type: {type}",
     };
 
@@ -473,12 +481,24 @@ public class UnrealTranspiler : AbstractTranspiler
         return result.ToString();
     }
 
-    private static string GenerateParsedDataSwitch()
+    // Packets whose fields are all fixed-size travel to the game thread as decoded structs,
+    // anything with strings or arrays is handed over as its serialized body
+    private static bool IsInlineEvent(FieldInfo[] fields)
     {
-        StringBuilder switchBuilder = new StringBuilder();
-        var serverPackets = GetServerPackets();
+        foreach (var field in fields)
+        {
+            var unrealType = ConvertToUnrealType(field.FieldType.Name);
 
-        foreach (var packet in serverPackets)
+            if (unrealType.StartsWith("FString") || unrealType.StartsWith("TArray"))
+                return false;
+        }
+
+        return true;
+    }
+
+    private static IEnumerable<(string Packet, FieldInfo[] Fields)> GetDispatchedServerPackets()
+    {
+        foreach (var packet in GetServerPackets())
         {
             var contract = GetContractByName(packet + "Packet");
             var attribute = contract.GetCustomAttribute<ContractAttribute>();
@@ -489,81 +509,109 @@ public class UnrealTranspiler : AbstractTranspiler
                 attribute.Flags != ContractPacketFlags.None
             )
             {
-                var fields = contract.GetFields(BindingFlags.Public | BindingFlags.Instance);
-                var ident = "                        ";
+                yield return (packet, contract.GetFields(BindingFlags.Public | BindingFlags.Instance));
+            }
+        }
+    }
 
-                switchBuilder.AppendLine($"{ident}case EServerPackets::{packet}:");
-                switchBuilder.AppendLine(ident + "{");
+    private static string GenerateParsedDataSwitch()
+    {
+        StringBuilder switchBuilder = new StringBuilder();
 
-                if (fields.Length == 1)
-                {
-                    var fieldType = ConvertToUnrealType(fields[0].FieldType.Name);
-                    var fieldName = fields[0].Name;
+        foreach (var (packet, fields) in GetDispatchedServerPackets())
+        {
+            var ident = "                ";
 
-                    switchBuilder.AppendLine($"{ident}    F{packet}Packet f{packet} = F{packet}Packet();");
-                    switchBuilder.AppendLine($"{ident}    f{packet}.Deserialize(Buffer);");
-                    switchBuilder.AppendLine($"{ident}    On{packet}.Broadcast(f{packet}.{fieldName});");
+            switchBuilder.AppendLine($"{ident}case EServerPackets::{packet}:");
+            switchBuilder.AppendLine(ident + "{");
+
+            if (fields.Length == 0)
+            {
+                switchBuilder.AppendLine($"{ident}    QueuePacketEvent(EServerPackets::{packet});");
+            }
+            else if (!IsInlineEvent(fields))
+            {
+                switchBuilder.AppendLine($"{ident}    const int32 Start = Buffer.GetPosition();");
+                switchBuilder.AppendLine($"{ident}    F{packet}Packet f{packet} = F{packet}Packet();");
+                switchBuilder.AppendLine($"{ident}    f{packet}.Deserialize(Buffer);");
+                switchBuilder.AppendLine($"{ident}    QueueRawPacketEvent(EServerPackets::{packet}, Buffer.GetData() + Start, Buffer.GetPosition() - Start);");
+            }
+            else
+            {
+                switchBuilder.AppendLine($"{ident}    F{packet}Packet f{packet} = F{packet}Packet();");
+                switchBuilder.AppendLine($"{ident}    f{packet}.Deserialize(Buffer);");
+
+                // Add special logging for UpdateEntityQuantized
+                if (packet == "UpdateEntityQuantized")
+                {
+                    switchBuilder.AppendLine($"{ident}    static int32 QuantizedUpdateCount = 0;");
+                    switchBuilder.AppendLine($"{ident}    QuantizedUpdateCount++;");
+                    switchBuilder.AppendLine($"{ident}    ");
+                    switchBuilder.AppendLine($"{ident}    if (QuantizedUpdateCount <= 10)");
+                    switchBuilder.AppendLine($"{ident}    {{");
+                    switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"=== RECEIVED UpdateEntityQuantizedPacket #%d ===\"), QuantizedUpdateCount));");
+                    switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"[CLIENT] EntityId: %d\"), f{packet}.EntityId));");
+                    switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"[CLIENT] Quantized Position: (%d, %d, %d)\"), f{packet}.QuantizedX, f{packet}.QuantizedY, f{packet}.QuantizedZ));");
+                    switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"[CLIENT] Quadrant: (%d, %d)\"), f{packet}.QuadrantX, f{packet}.QuadrantY));");
+                    switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"[CLIENT] Yaw: %f\"), f{packet}.Yaw));");
+                    switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"[CLIENT] Velocity: %s\"), *f{packet}.Velocity.ToString()));");
+                    switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"[CLIENT] AnimationState: %d\"), f{packet}.AnimationState));");
+                    switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"[CLIENT] Flags: %d\"), f{packet}.Flags));");
+                    switchBuilder.AppendLine($"{ident}    }}");
+                    switchBuilder.AppendLine($"{ident}    ");
                 }
-                else if (fields.Length == 0)
+
+                switchBuilder.AppendLine($"{ident}    QueuePacketEvent(EServerPackets::{packet}, f{packet});");
+            }
+
+            switchBuilder.AppendLine(ident + "}");
+            switchBuilder.AppendLine(ident + "break;");
+        }
+
+        return switchBuilder.ToString();
+    }
+
+    private static string GenerateEventSwitch()
+    {
+        StringBuilder switchBuilder = new StringBuilder();
+
+        foreach (var (packet, fields) in GetDispatchedServerPackets())
+        {
+            var ident = "        ";
+
+            switchBuilder.AppendLine($"{ident}case EServerPackets::{packet}:");
+            switchBuilder.AppendLine(ident + "{");
+
+            if (fields.Length == 0)
+            {
+                switchBuilder.AppendLine($"{ident}    On{packet}.Broadcast();");
+            }
+            else
+            {
+                if (IsInlineEvent(fields))
                 {
-                    switchBuilder.AppendLine($"{ident}    On{packet}.Broadcast();");
+                    switchBuilder.AppendLine($"{ident}    const F{packet}Packet& f{packet} = Event.Get<F{packet}Packet>();");
                 }
-                else if (fields.Length < 6)
+                else
                 {
                     switchBuilder.AppendLine($"{ident}    F{packet}Packet f{packet} = F{packet}Packet();");
-                    switchBuilder.AppendLine($"{ident}    f{packet}.Deserialize(Buffer);");
-                    var parameters = new List<string>();
-
-                    foreach (var field in fields)
-                    {
-                        var fieldType = ConvertToUnrealType(field.FieldType.Name);
-                        var fieldName = field.Name;
-                        parameters.Add($"f{packet}.{fieldName}");
-                    }
+                    switchBuilder.AppendLine($"{ident}    FFlatBufferView View = Event.GetRawView();");
+                    switchBuilder.AppendLine($"{ident}    f{packet}.Deserialize(View);");
+                }
 
+                if (fields.Length < 6)
+                {
+                    var parameters = fields.Select(field => $"f{packet}.{field.Name}");
                     switchBuilder.AppendLine($"{ident}    On{packet}.Broadcast({string.Join(", ", parameters)});");
                 }
                 else
                 {
-                    switchBuilder.AppendLine($"{ident}    F{packet}Packet f{packet} = F{packet}Packet();");
-                    switchBuilder.AppendLine($"{ident}    f{packet}.Deserialize(Buffer);");
-
-                    // Add special logging for UpdateEntityQuantized
-                    if (packet == "UpdateEntityQuantized")
-                    {
-                        switchBuilder.AppendLine($"{ident}    static int32 QuantizedUpdateCount = 0;");
-                        switchBuilder.AppendLine($"{ident}    QuantizedUpdateCount++;");
-                        switchBuilder.AppendLine($"{ident}    ");
-                        switchBuilder.AppendLine($"{ident}    if (QuantizedUpdateCount <= 10)");
-                        switchBuilder.AppendLine($"{ident}    {{");
-                        switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"=== RECEIVED UpdateEntityQuantizedPacket #%d ===\"), QuantizedUpdateCount));");
-                        switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"[CLIENT] EntityId: %d\"), f{packet}.EntityId));");
-                        switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"[CLIENT] Quantized Position: (%d, %d, %d)\"), f{packet}.QuantizedX, f{packet}.QuantizedY, f{packet}.QuantizedZ));");
-                        switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"[CLIENT] Quadrant: (%d, %d)\"), f{packet}.QuadrantX, f{packet}.QuadrantY));");
-                        switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"[CLIENT] Yaw: %f\"), f{packet}.Yaw));");
-                        switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"[CLIENT] Velocity: %s\"), *f{packet}.Velocity.ToString()));");
-                        switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"[CLIENT] AnimationState: %d\"), f{packet}.AnimationState));");
-                        switchBuilder.AppendLine($"{ident}        ClientFileLog(FString::Printf(TEXT(\"[CLIENT] Flags: %d\"), f{packet}.Flags));");
-                        switchBuilder.AppendLine($"{ident}    }}");
-                        switchBuilder.AppendLine($"{ident}    ");
-                    }
-
                     switchBuilder.AppendLine($"{ident}    On{packet}.Broadcast(f{packet});");
-
-                    // Add broadcast confirmation log for UpdateEntityQuantized
-                    if (packet == "UpdateEntityQuantized")
-                    {
-                        switchBuilder.AppendLine($"{ident}    ");
-                        switchBuilder.AppendLine($"{ident}    if (QuantizedUpdateCount <= 10)");
-                        switchBuilder.AppendLine($"{ident}    {{");
-                        switchBuilder.AppendLine($"{ident}        ClientFileLog(TEXT(\"[CLIENT] UpdateEntityQuantized broadcasted to delegates\"));");
-                        switchBuilder.AppendLine($"{ident}    }}");
-                    }
                 }
-
-                switchBuilder.AppendLine(ident + "}");
-                switchBuilder.AppendLine(ident + "break;");
             }
+
+            switchBuilder.AppendLine(ident + "}");
+            switchBuilder.AppendLine(ident + "break;");
         }
 
         return switchBuilder.ToString();
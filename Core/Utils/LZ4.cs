@@ -21,154 +21,479 @@
  * SOFTWARE.
  */
 
+using System.Numerics;
 using System.Runtime.CompilerServices;
 
+/// <summary>
+/// How hard LZ4.Compress looks for matches, picked per call so one sender can favour latency on small
+/// packets and ratio on bulk payloads. Fast probes a single hash slot per position and, with an
+/// acceleration above 1, widens its step sooner over literal runs so incompressible input is skimmed
+/// instead of scanned. High walks a hash chain of up to SearchDepth earlier positions and looks one byte
+/// ahead before committing to a match: several times slower, noticeably smaller.
+/// </summary>
+public readonly struct LZ4Level
+{
+    public const int MaxAcceleration = 256;
+    public const int DefaultSearchDepth = 64;
+
+    public readonly int Acceleration;
+    public readonly int SearchDepth; // 0 selects the fast match finder
+
+    private LZ4Level(int acceleration, int searchDepth)
+    {
+        Acceleration = acceleration;
+        SearchDepth = searchDepth;
+    }
+
+    public static LZ4Level Fast(int acceleration = 1) => new LZ4Level(acceleration, 0);
+    public static LZ4Level High(int searchDepth = DefaultSearchDepth) => new LZ4Level(1, Math.Max(1, searchDepth));
+
+    public bool IsHigh => SearchDepth > 0;
+}
+
 public static class LZ4
 {
-    private const int MinMatch = 4;
-    private const int HashLog = 16;
-    private const int HashSize = 1 << HashLog;
+    internal const int MinMatch = 4;
+    internal const int HashLog = 16;
+    internal const int HashSize = 1 << HashLog;
     private const uint HashMultiplier = 2654435761u;
 
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
-    private static int Hash(uint value)
+    internal static int Hash(uint value)
     {
         return (int)((value * HashMultiplier) >> ((MinMatch * 8) - HashLog));
     }
 
+    [ThreadStatic]
+    private static LZ4CompressState _threadState;
+
+    // Without a state of its own, the calling thread's is used
+    public static unsafe int Compress(byte* src, int srcLength, byte* dst, int dstCapacity, LZ4Level level = default)
+    {
+        return CompressBlock(src, srcLength, dst, dstCapacity, null, _threadState ??= new LZ4CompressState(), level);
+    }
+
+    public static unsafe int Compress(byte* src, int srcLength, byte* dst, int dstCapacity, LZ4CompressState state, LZ4Level level = default)
+    {
+        return CompressBlock(src, srcLength, dst, dstCapacity, null, state, level);
+    }
+
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
-    public static unsafe int Compress(byte* src, int srcLength, byte* dst, int dstCapacity)
+    public static unsafe int Decompress(byte* src, int srcLength, byte* dst, int dstCapacity)
     {
-        uint* hashTable = stackalloc uint[HashSize];
+        return DecompressBlock(src, srcLength, dst, dstCapacity, null, 0);
+    }
 
-        for (int i = 0; i < HashSize; i++)
-            hashTable[i] = 0;
+    // The dictionary is treated as the data immediately preceding src / dst, both peers must hold the same one
+    public static unsafe int CompressWithDictionary(byte* src, int srcLength, byte* dst, int dstCapacity, LZ4Dictionary dictionary, LZ4Level level = default)
+    {
+        return CompressBlock(src, srcLength, dst, dstCapacity, dictionary != null && dictionary.IsValid ? dictionary : null,
+            _threadState ??= new LZ4CompressState(), level);
+    }
 
+    public static unsafe int CompressWithDictionary(byte* src, int srcLength, byte* dst, int dstCapacity, LZ4Dictionary dictionary,
+        LZ4CompressState state, LZ4Level level = default)
+    {
+        return CompressBlock(src, srcLength, dst, dstCapacity, dictionary != null && dictionary.IsValid ? dictionary : null, state, level);
+    }
+
+    public static unsafe int DecompressWithDictionary(byte* src, int srcLength, byte* dst, int dstCapacity, LZ4Dictionary dictionary)
+    {
+        if (dictionary == null || !dictionary.IsValid)
+            return DecompressBlock(src, srcLength, dst, dstCapacity, null, 0);
+
+        fixed (byte* dict = dictionary.Data)
+        {
+            return DecompressBlock(src, srcLength, dst, dstCapacity, dict + dictionary.Size, dictionary.Size);
+        }
+    }
+
+    // Block format end rules: the last 5 bytes are always literals and the last match starts at least
+    // 12 bytes before the end, which is what lets decoders copy in wide steps without checking every byte
+    private const int LastLiterals = 5;
+    private const int MFLimit = 12;
+
+    // Fast level: misses in a row before the search step grows by one
+    private const int SkipTrigger = 6;
+
+    // Offsets are 16 bits, one short of the full range like the dictionary size
+    private const int MaxDistance = 0xFFFF;
+
+    private static unsafe int CompressBlock(byte* src, int srcLength, byte* dst, int dstCapacity, LZ4Dictionary dictionary,
+        LZ4CompressState state, LZ4Level level)
+    {
+        if (srcLength < 0 || dstCapacity <= 0)
+            return 0;
+
+        fixed (byte* dictBegin = dictionary?.Data)
+        fixed (uint* dictTable = dictionary?.HashTable)
+        {
+            int dictSize = dictionary?.Size ?? 0;
+
+            return level.IsHigh
+                ? CompressHigh(src, srcLength, dst, dstCapacity, dictBegin, dictTable, dictSize, state, level.SearchDepth)
+                : CompressFast(src, srcLength, dst, dstCapacity, dictBegin, dictTable, dictSize, state,
+                    Math.Clamp(level.Acceleration, 1, LZ4Level.MaxAcceleration));
+        }
+    }
+
+    private static unsafe int CompressFast(byte* src, int srcLength, byte* dst, int dstCapacity, byte* dictBegin, uint* dictTable, int dictSize,
+        LZ4CompressState state, int acceleration)
+    {
         byte* ip = src;
-        byte* anchor = ip;
+        byte* anchor = src;
         byte* iend = src + srcLength;
-        byte* mflimit = iend - MinMatch;
         byte* op = dst;
         byte* oend = dst + dstCapacity;
 
-        while (ip < mflimit)
+        if (srcLength > MFLimit)
         {
-            uint sequence = *(uint*)ip;
-            int h = Hash(sequence);
-            byte* refp = src + hashTable[h];
-            hashTable[h] = (uint)(ip - src);
+            byte* mflimit = iend - MFLimit;
+            byte* matchlimit = iend - LastLiterals;
+            uint origin = state.Begin(srcLength, false);
 
-            if (refp < ip && (ip - refp) < 0xFFFF && *(uint*)refp == sequence)
+            fixed (uint* table = state.HashTable)
             {
-                byte* token = op++;
-                int literalLength = (int)(ip - anchor);
-
-                if (op + literalLength + 8 > oend)
-                    return 0;
+                int search = acceleration << SkipTrigger;
 
-                if (literalLength >= 15)
+                while (ip <= mflimit)
                 {
-                    *token = 15 << 4;
-                    int len = literalLength - 15;
+                    uint sequence = *(uint*)ip;
+                    int h = Hash(sequence);
+                    uint current = origin + (uint)(ip - src);
+                    uint entry = table[h];
+                    table[h] = current;
+
+                    byte* refp = null;
+                    byte* refBegin = src;
+                    byte* limit = matchlimit;
+                    int offset = (int)(current - entry);
+
+                    // History from the block itself first, then the dictionary that logically precedes it
+                    if (entry >= origin && offset < MaxDistance && *(uint*)(src + (entry - origin)) == sequence)
+                    {
+                        refp = src + (entry - origin);
+                    }
+                    else if (dictTable != null && dictTable[h] != 0)
+                    {
+                        int dictPosition = (int)dictTable[h] - 1;
+                        offset = (int)(ip - src) + dictSize - dictPosition;
+
+                        if (offset < MaxDistance && *(uint*)(dictBegin + dictPosition) == sequence)
+                        {
+                            refp = dictBegin + dictPosition;
+                            refBegin = dictBegin;
+
+                            // A dictionary match stops at the end of the dictionary
+                            if (ip + (dictSize - dictPosition) < limit)
+                                limit = ip + (dictSize - dictPosition);
+                        }
+                    }
 
-                    while (len >= 255)
+                    if (refp == null)
                     {
-                        *op++ = 255;
-                        len -= 255;
+                        // The longer the literal run, the further each miss jumps
+                        ip += search++ >> SkipTrigger;
+                        continue;
                     }
 
-                    *op++ = (byte)len;
-                }
-                else
-                {
-                    *token = (byte)(literalLength << 4);
+                    // Reclaim bytes the step jumped over that already belong to the match
+                    while (ip > anchor && refp > refBegin && ip[-1] == refp[-1])
+                    {
+                        ip--;
+                        refp--;
+                    }
+
+                    int matchLength = MinMatch + Count(ip + MinMatch, refp + MinMatch, limit);
+
+                    if ((op = WriteSequence(op, oend, anchor, (int)(ip - anchor), offset, matchLength - MinMatch)) == null)
+                        return 0;
+
+                    ip += matchLength;
+                    anchor = ip;
+                    search = acceleration << SkipTrigger;
+
+                    // Keeps a match right behind this one findable, the positions inside it were never hashed
+                    table[Hash(*(uint*)(ip - 2))] = origin + (uint)(ip - 2 - src);
                 }
+            }
+        }
 
-                for (int i = 0; i < literalLength; i++)
-                    *op++ = anchor[i];
+        if ((op = WriteLastLiterals(op, oend, anchor, (int)(iend - anchor))) == null)
+            return 0;
 
-                ushort offset = (ushort)(ip - refp);
-                *op++ = (byte)offset;
-                *op++ = (byte)(offset >> 8);
+        return (int)(op - dst);
+    }
 
-                ip += MinMatch;
-                refp += MinMatch;
+    private static unsafe int CompressHigh(byte* src, int srcLength, byte* dst, int dstCapacity, byte* dictBegin, uint* dictTable, int dictSize,
+        LZ4CompressState state, int searchDepth)
+    {
+        byte* ip = src;
+        byte* anchor = src;
+        byte* iend = src + srcLength;
+        byte* op = dst;
+        byte* oend = dst + dstCapacity;
 
-                int matchLength = 0;
+        if (srcLength > MFLimit)
+        {
+            byte* mflimit = iend - MFLimit;
+            byte* matchlimit = iend - LastLiterals;
+            uint origin = state.Begin(srcLength, true);
 
-                while (ip < mflimit && *(uint*)ip == *(uint*)refp)
-                {
-                    ip += 4;
-                    refp += 4;
-                    matchLength += 4;
-                }
+            fixed (uint* table = state.HashTable)
+            fixed (ushort* chain = state.ChainTable)
+            {
+                byte* nextToInsert = src;
 
-                while (ip < iend && *ip == *refp)
+                while (ip <= mflimit)
                 {
-                    ip++;
-                    refp++;
-                    matchLength++;
-                }
+                    nextToInsert = InsertChain(src, nextToInsert, ip, origin, table, chain);
+                    int matchLength = FindLongestMatch(src, ip, matchlimit, origin, table, chain, searchDepth, dictBegin, dictTable, dictSize, out int offset);
 
-                if (matchLength >= 15)
-                {
-                    *token |= 15;
-                    int len = matchLength - 15;
+                    if (matchLength == 0)
+                    {
+                        ip++;
+                        continue;
+                    }
 
-                    while (len >= 255)
+                    // Lazy matching: a longer match starting one byte later is worth one more literal
+                    while (ip < mflimit)
                     {
-                        *op++ = 255;
-                        len -= 255;
+                        nextToInsert = InsertChain(src, nextToInsert, ip + 1, origin, table, chain);
+                        int nextLength = FindLongestMatch(src, ip + 1, matchlimit, origin, table, chain, searchDepth, dictBegin, dictTable, dictSize, out int nextOffset);
+
+                        if (nextLength <= matchLength)
+                            break;
+
+                        ip++;
+                        matchLength = nextLength;
+                        offset = nextOffset;
                     }
 
-                    *op++ = (byte)len;
-                }
-                else
-                {
-                    *token |= (byte)matchLength;
+                    if ((op = WriteSequence(op, oend, anchor, (int)(ip - anchor), offset, matchLength - MinMatch)) == null)
+                        return 0;
+
+                    ip += matchLength;
+                    anchor = ip;
                 }
+            }
+        }
 
-                anchor = ip;
+        if ((op = WriteLastLiterals(op, oend, anchor, (int)(iend - anchor))) == null)
+            return 0;
 
-                if (op > oend - 5)
-                    return 0;
+        return (int)(op - dst);
+    }
 
-                continue;
-            }
+    // Links every position before `to` into the hash chains, so a search sees all of them and not only
+    // those the parse stopped on. Returns the next position to link.
+    private static unsafe byte* InsertChain(byte* src, byte* from, byte* to, uint origin, uint* table, ushort* chain)
+    {
+        for (; from < to; from++)
+        {
+            uint position = origin + (uint)(from - src);
+            int h = Hash(*(uint*)from);
 
-            ip++;
+            // Anything older than a full offset, including entries left over from earlier blocks, ends the chain
+            chain[position & 0xFFFF] = (ushort)Math.Min(position - table[h], MaxDistance);
+            table[h] = position;
         }
 
-        int lastLit = (int)(iend - anchor);
-        if (op + lastLit + (lastLit / 255) + 1 > oend)
-            return 0;
+        return from;
+    }
+
+    // Longest match for the sequence at `at` among up to searchDepth chained positions and the dictionary, 0 when there is none
+    private static unsafe int FindLongestMatch(byte* src, byte* at, byte* matchlimit, uint origin, uint* table, ushort* chain, int searchDepth,
+        byte* dictBegin, uint* dictTable, int dictSize, out int offset)
+    {
+        uint sequence = *(uint*)at;
+        int h = Hash(sequence);
+        uint current = origin + (uint)(at - src);
+        int bestLength = 0;
+        offset = 0;
+
+        uint candidate = table[h];
 
-        if (lastLit >= 15)
+        for (int attempts = searchDepth; attempts > 0 && candidate >= origin && current - candidate < MaxDistance; attempts--)
         {
-            *op++ = 15 << 4;
-            int len = lastLit - 15;
+            byte* refp = src + (candidate - origin);
 
-            while (len >= 255)
+            // Only a candidate that also agrees at the current best length can beat it
+            if (refp[bestLength] == at[bestLength] && *(uint*)refp == sequence)
             {
-                *op++ = 255;
-                len -= 255;
+                int length = MinMatch + Count(at + MinMatch, refp + MinMatch, matchlimit);
+
+                if (length > bestLength)
+                {
+                    bestLength = length;
+                    offset = (int)(current - candidate);
+                }
             }
 
-            *op++ = (byte)len;
+            candidate -= chain[candidate & 0xFFFF];
         }
-        else
+
+        if (dictTable != null && dictTable[h] != 0)
         {
-            *op++ = (byte)(lastLit << 4);
+            int dictPosition = (int)dictTable[h] - 1;
+            int dictOffset = (int)(at - src) + dictSize - dictPosition;
+            byte* refp = dictBegin + dictPosition;
+
+            if (dictOffset < MaxDistance && *(uint*)refp == sequence)
+            {
+                byte* limit = at + (dictSize - dictPosition) < matchlimit ? at + (dictSize - dictPosition) : matchlimit;
+                int length = MinMatch + Count(at + MinMatch, refp + MinMatch, limit);
+
+                if (length > bestLength)
+                {
+                    bestLength = length;
+                    offset = dictOffset;
+                }
+            }
         }
 
-        for (int i = 0; i < lastLit; i++)
-            *op++ = anchor[i];
+        return bestLength;
+    }
 
-        return (int)(op - dst);
+    // Length of the common run at a and b, reading a no further than limit
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static unsafe int Count(byte* a, byte* b, byte* limit)
+    {
+        byte* start = a;
+
+        while (a + 8 <= limit)
+        {
+            ulong diff = Unsafe.ReadUnaligned<ulong>(a) ^ Unsafe.ReadUnaligned<ulong>(b);
+
+            if (diff != 0)
+                return (int)(a - start) + (BitOperations.TrailingZeroCount(diff) >> 3);
+
+            a += 8;
+            b += 8;
+        }
+
+        while (a < limit && *a == *b)
+        {
+            a++;
+            b++;
+        }
+
+        return (int)(a - start);
     }
 
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
-    public static unsafe int Decompress(byte* src, int srcLength, byte* dst, int dstCapacity)
+    private static unsafe byte* WriteLength(byte* op, int length)
+    {
+        while (length >= 255)
+        {
+            *op++ = 255;
+            length -= 255;
+        }
+
+        *op++ = (byte)length;
+        return op;
+    }
+
+    // Token, literal run, offset and match length past MinMatch. Returns the output position after the
+    // sequence, or null when it does not fit before oend.
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static unsafe byte* WriteSequence(byte* op, byte* oend, byte* anchor, int literalLength, int offset, int matchLength)
+    {
+        if (oend - op < 1 + literalLength / 255 + 1 + literalLength + 2 + matchLength / 255 + 1)
+            return null;
+
+        byte* token = op++;
+        *token = (byte)(Math.Min(literalLength, 15) << 4 | Math.Min(matchLength, 15));
+
+        if (literalLength >= 15)
+            op = WriteLength(op, literalLength - 15);
+
+        Buffer.MemoryCopy(anchor, op, literalLength, literalLength);
+        op += literalLength;
+
+        *op++ = (byte)offset;
+        *op++ = (byte)(offset >> 8);
+
+        if (matchLength >= 15)
+            op = WriteLength(op, matchLength - 15);
+
+        return op;
+    }
+
+    private static unsafe byte* WriteLastLiterals(byte* op, byte* oend, byte* anchor, int literalLength)
+    {
+        if (oend - op < 1 + literalLength / 255 + 1 + literalLength)
+            return null;
+
+        *op++ = (byte)(Math.Min(literalLength, 15) << 4);
+
+        if (literalLength >= 15)
+            op = WriteLength(op, literalLength - 15);
+
+        Buffer.MemoryCopy(anchor, op, literalLength, literalLength);
+        return op + literalLength;
+    }
+
+    // Wild copies move 8 bytes at a time and may run up to 7 bytes past the requested end, so they
+    // are only used while that much room is left in both buffers; the tails fall back to exact copies
+    private const int WildCopyLength = 8;
+
+    private static readonly int[] IncrementTable = { 0, 1, 2, 1, 0, 4, 4, 4 };
+    private static readonly int[] DecrementTable = { 0, 0, 0, -1, -4, 1, 2, 3 };
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static unsafe void Copy8(byte* dst, byte* src)
+    {
+        Unsafe.WriteUnaligned(dst, Unsafe.ReadUnaligned<ulong>(src));
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static unsafe void WildCopy8(byte* dst, byte* src, byte* dstEnd)
+    {
+        do
+        {
+            Copy8(dst, src);
+            dst += 8;
+            src += 8;
+        } while (dst < dstEnd);
+    }
+
+    // Same with 16-byte steps: up to 15 bytes of overrun, and the source must trail by 16 or more
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static unsafe void WildCopy16(byte* dst, byte* src, byte* dstEnd)
+    {
+        do
+        {
+            Unsafe.CopyBlockUnaligned(dst, src, 16);
+            dst += 16;
+            src += 16;
+        } while (dst < dstEnd);
+    }
+
+    // Extended length bytes: 255 means another byte follows. Returns the input position after them, or
+    // null when the input ends first or the length grows past the limit, which also keeps it from overflowing.
+    // The position is returned rather than passed by reference so the decoder's own pointer stays in a register.
+    private static unsafe byte* ReadLength(byte* ip, byte* iend, int limit, ref int length)
+    {
+        uint s;
+
+        do
+        {
+            if (ip >= iend)
+                return null;
+
+            s = *ip++;
+            length += (int)s;
+
+            if (length > limit)
+                return null;
+        } while (s == 255);
+
+        return ip;
+    }
+
+    // Input comes off the network: every length and offset is validated before it is used
+    internal static unsafe int DecompressBlock(byte* src, int srcLength, byte* dst, int dstCapacity, byte* dictEnd, int dictSize)
     {
         byte* ip = src;
         byte* iend = src + srcLength;
@@ -177,51 +502,131 @@ public static class LZ4
 
         while (ip < iend)
         {
-            byte token = *ip++;
-            int literalLength = token >> 4;
+            uint token = *ip++;
 
-            if (literalLength == 15)
+            int literalLength = (int)(token >> 4);
+
+            if (literalLength != 15 && iend - ip >= 16 && oend - op >= 16)
+            {
+                // Short literal run well inside both buffers: one fixed 16-byte copy, and with at least
+                // 2 input bytes left over this cannot be the last sequence
+                Copy8(op, ip);
+                Copy8(op + 8, ip + 8);
+                ip += literalLength;
+                op += literalLength;
+            }
+            else
             {
-                byte s;
+                if (literalLength == 15 && (ip = ReadLength(ip, iend, (int)(oend - op), ref literalLength)) == null)
+                    return 0;
+
+                if (literalLength > iend - ip || literalLength > oend - op)
+                    return 0;
+
+                if (literalLength <= (iend - ip) - 2 * WildCopyLength && literalLength <= (oend - op) - 2 * WildCopyLength)
+                    WildCopy16(op, ip, op + literalLength);
+                else if (literalLength <= (iend - ip) - WildCopyLength && literalLength <= (oend - op) - WildCopyLength)
+                    WildCopy8(op, ip, op + literalLength);
+                else
+                    Buffer.MemoryCopy(ip, op, literalLength, literalLength);
+
+                ip += literalLength;
+                op += literalLength;
+
+                // The last sequence carries literals only
+                if (ip >= iend)
+                    break;
+
+                if (iend - ip < 2)
+                    return 0;
+            }
+
+            int offset = ip[0] | (ip[1] << 8);
+            ip += 2;
 
-                while (((s = *ip++) == 255) && ip < iend)
-                    literalLength += 255;
+            int matchLength = (int)(token & 0x0F);
 
-                literalLength += s;
+            if (matchLength != 15 && offset >= 8 && offset <= op - dst && oend - op >= 18)
+            {
+                // Short match that neither overlaps its own first 8 bytes nor reaches into the dictionary:
+                // a fixed 18-byte copy covers every length the token can hold
+                byte* shortMatch = op - offset;
+                Copy8(op, shortMatch);
+                Copy8(op + 8, shortMatch + 8);
+                Unsafe.WriteUnaligned(op + 16, Unsafe.ReadUnaligned<ushort>(shortMatch + 16));
+                op += matchLength + MinMatch;
+                continue;
             }
 
-            if (op + literalLength > oend || ip + literalLength > iend)
+            if (matchLength == 15 && (ip = ReadLength(ip, iend, (int)(oend - op), ref matchLength)) == null)
                 return 0;
 
-            for (int i = 0; i < literalLength; i++)
-                *op++ = *ip++;
+            matchLength += MinMatch;
 
-            if (ip >= iend)
-                break;
+            if (matchLength > oend - op)
+                return 0;
 
-            ushort offset = (ushort)(ip[0] | (ip[1] << 8));
-            ip += 2;
-            byte* match = op - offset;
+            // The offset may reach back past the start of the output, into the dictionary
+            int produced = (int)(op - dst);
 
-            int matchLength = token & 0x0F;
+            if (offset == 0 || offset > produced + dictSize)
+                return 0;
 
-            if (matchLength == 15)
+            if (offset > produced)
             {
-                byte s;
+                int back = offset - produced;
+                int fromDictionary = back < matchLength ? back : matchLength;
 
-                while (((s = *ip++) == 255) && ip < iend)
-                    matchLength += 255;
+                Buffer.MemoryCopy(dictEnd - back, op, fromDictionary, fromDictionary);
+                op += fromDictionary;
+                matchLength -= fromDictionary;
 
-                matchLength += s;
+                // Whatever is left continues from the start of the output, still offset behind op
+                if (matchLength == 0)
+                    continue;
             }
 
-            matchLength += 4;
+            byte* match = op - offset;
+            byte* cend = op + matchLength;
 
-            if (op + matchLength > oend)
-                return 0;
+            if (cend > oend - WildCopyLength)
+            {
+                // Too close to the end for wild copies, byte by byte keeps overlapping matches right
+                while (op < cend)
+                    *op++ = *match++;
+
+                continue;
+            }
+
+            if (offset < 8)
+            {
+                // Overlapping match: the first 8 bytes are expanded by hand, after which the source trails
+                // the output by 8 bytes or more and the rest can be copied 8 at a time
+                op[0] = match[0];
+                op[1] = match[1];
+                op[2] = match[2];
+                op[3] = match[3];
+                match += IncrementTable[offset];
+                Unsafe.WriteUnaligned(op + 4, Unsafe.ReadUnaligned<uint>(match));
+                match -= DecrementTable[offset];
+                op += 8;
+            }
+            else
+            {
+                Copy8(op, match);
+                op += 8;
+                match += 8;
+            }
+
+            if (op < cend)
+            {
+                if (op - match >= 16 && cend <= oend - 2 * WildCopyLength)
+                    WildCopy16(op, match, cend);
+                else
+                    WildCopy8(op, match, cend);
+            }
 
-            for (int i = 0; i < matchLength; i++)
-                *op++ = match[i];
+            op = cend;
         }
 
         return (int)(op - dst);
@@ -0,0 +1,63 @@
+/*
+ * LZ4 Compress State
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/// <summary>
+/// Match finder tables for LZ4.Compress, owned by the caller and reused across blocks. Entries hold a
+/// running offset rather than positions within one block, so starting a block only moves the offset
+/// past the previous one and anything older reads as empty; the tables are cleared only when the offset
+/// is about to wrap. The hash chain the High level needs is allocated the first time it runs. Not thread-safe.
+/// </summary>
+public sealed class LZ4CompressState
+{
+    private const uint MaxOrigin = 1u << 30;
+
+    internal uint[] HashTable;   // Offset of the last position with each hash, below the current block's means empty
+    internal ushort[] ChainTable; // High only: distance back to the previous position with the same hash, by offset & 0xFFFF
+    private uint _origin = 1;     // Offset the next block starts at
+
+    public void Reset()
+    {
+        _origin = 1;
+
+        if (HashTable != null)
+            Array.Clear(HashTable);
+    }
+
+    // Returns the offset of src[0] for a block of size bytes, allocating or clearing the tables as needed
+    internal uint Begin(int size, bool chain)
+    {
+        HashTable ??= new uint[LZ4.HashSize];
+
+        // Chain entries are only followed from positions written during the same block, so stale ones need no clearing
+        if (chain)
+            ChainTable ??= GC.AllocateUninitializedArray<ushort>(0x10000);
+
+        if (_origin > MaxOrigin - (uint)size)
+            Reset();
+
+        uint origin = _origin;
+        _origin += (uint)size;
+
+        return origin;
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ * LZ4 Dictionary
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+using System.Collections.Concurrent;
+
+/// <summary>
+/// Shared LZ4 dictionary. Both peers preload the same bytes as match history, so packets too short
+/// to repeat themselves can still reference content seen across earlier traffic. The id is the
+/// CRC32C of the contents and is what the handshake negotiates, 0 means no dictionary.
+/// </summary>
+public sealed class LZ4Dictionary
+{
+    // Only the tail within reach of the 16 bit match offset is kept
+    public const int MaxSize = 0xFFFF - 1;
+
+    private static readonly ConcurrentDictionary<uint, LZ4Dictionary> Registry = new();
+
+    public uint Id { get; }
+    public byte[] Data { get; }
+    public int Size => Data.Length;
+    public bool IsValid => Id != 0;
+
+    // Last position + 1 of each hashed sequence, 0 when empty
+    internal uint[] HashTable { get; }
+
+    public unsafe LZ4Dictionary(ReadOnlySpan<byte> data)
+    {
+        if (data.Length < LZ4.MinMatch)
+            throw new ArgumentException("Dictionary is too small", nameof(data));
+
+        if (data.Length > MaxSize)
+            data = data.Slice(data.Length - MaxSize);
+
+        Data = data.ToArray();
+        HashTable = new uint[LZ4.HashSize];
+
+        fixed (byte* ptr = Data)
+        {
+            // Later positions overwrite earlier ones, so lookups land on the closest, cheapest offset
+            for (int position = 0; position + LZ4.MinMatch <= Data.Length; position++)
+                HashTable[LZ4.Hash(*(uint*)(ptr + position))] = (uint)position + 1;
+
+            uint id = CRC32C.Compute(ptr, Data.Length);
+            Id = id == 0 ? 1 : id;
+        }
+    }
+
+    public static LZ4Dictionary LoadFromFile(string path)
+    {
+        return new LZ4Dictionary(File.ReadAllBytes(path));
+    }
+
+    /// <summary>
+    /// Makes the dictionary available to sessions negotiating its id.
+    /// </summary>
+    public static void Register(LZ4Dictionary dictionary)
+    {
+        Registry[dictionary.Id] = dictionary;
+    }
+
+    public static bool TryGet(uint id, out LZ4Dictionary dictionary)
+    {
+        if (id == 0)
+        {
+            dictionary = null;
+            return false;
+        }
+
+        return Registry.TryGetValue(id, out dictionary);
+    }
+}
@@ -0,0 +1,169 @@
+/*
+ * LZ4 Dictionary Trainer
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/// <summary>
+/// Builds an LZ4 dictionary from captured packet payloads. Every sample is cut into short
+/// d-grams counted once per sample they appear in; the captured traffic is then split into
+/// epochs and from each epoch the segment covering the most frequent, not yet covered d-grams
+/// is kept. Segments picked first land at the end of the dictionary, closest to the data.
+/// </summary>
+public static class LZ4DictionaryTrainer
+{
+    public const int DefaultDictionarySize = 8 * 1024;
+    public const int DefaultSegmentSize = 32;
+    public const int DefaultGramSize = 6;
+
+    public static byte[] Train(IReadOnlyList<byte[]> samples, int dictionarySize = DefaultDictionarySize,
+        int segmentSize = DefaultSegmentSize, int gramSize = DefaultGramSize)
+    {
+        if (gramSize < LZ4.MinMatch || gramSize > 8)
+            throw new ArgumentOutOfRangeException(nameof(gramSize));
+
+        dictionarySize = Math.Clamp(dictionarySize, LZ4.MinMatch, LZ4Dictionary.MaxSize);
+        segmentSize = Math.Max(segmentSize, gramSize);
+
+        var frequency = new Dictionary<ulong, int>();
+        var seen = new HashSet<ulong>();
+        long totalBytes = 0;
+
+        foreach (var sample in samples)
+        {
+            seen.Clear();
+            totalBytes += sample.Length;
+
+            for (int i = 0; i + gramSize <= sample.Length; i++)
+            {
+                ulong gram = Gram(sample, i, gramSize);
+
+                if (seen.Add(gram))
+                    frequency[gram] = frequency.TryGetValue(gram, out int count) ? count + 1 : 1;
+            }
+        }
+
+        var segments = new List<byte[]>();
+        int selectedBytes = 0;
+        int epochs = Math.Max(1, dictionarySize / segmentSize);
+        long epochBytes = Math.Max(1, totalBytes / epochs);
+        int sampleIndex = 0;
+
+        while (selectedBytes < dictionarySize && sampleIndex < samples.Count)
+        {
+            long consumed = 0;
+            long bestScore = 0;
+            byte[] bestSample = null;
+            int bestStart = 0;
+            int bestLength = 0;
+
+            // Best segment within this epoch, segments never straddle two samples
+            for (; sampleIndex < samples.Count && consumed < epochBytes; sampleIndex++)
+            {
+                var sample = samples[sampleIndex];
+                consumed += sample.Length;
+
+                int length = Math.Min(segmentSize, sample.Length);
+
+                for (int start = 0; start + length <= sample.Length; start++)
+                {
+                    long score = 0;
+
+                    for (int i = start; i + gramSize <= start + length; i++)
+                    {
+                        if (frequency.TryGetValue(Gram(sample, i, gramSize), out int count) && count > 1)
+                            score += count;
+                    }
+
+                    if (score > bestScore)
+                    {
+                        bestScore = score;
+                        bestSample = sample;
+                        bestStart = start;
+                        bestLength = length;
+                    }
+                }
+            }
+
+            if (bestSample == null)
+                continue;
+
+            // Covered d-grams stop scoring so later epochs pick different content
+            for (int i = bestStart; i + gramSize <= bestStart + bestLength; i++)
+                frequency.Remove(Gram(bestSample, i, gramSize));
+
+            int take = Math.Min(bestLength, dictionarySize - selectedBytes);
+            segments.Add(bestSample.AsSpan(bestStart, take).ToArray());
+            selectedBytes += take;
+        }
+
+        var dictionary = new byte[selectedBytes];
+        int offset = selectedBytes;
+
+        foreach (var segment in segments)
+        {
+            offset -= segment.Length;
+            segment.CopyTo(dictionary, offset);
+        }
+
+        return dictionary;
+    }
+
+    /// <summary>
+    /// Compressed size of every sample with and without the dictionary, packets that do not
+    /// shrink are counted raw, exactly as the sender falls back to an uncompressed payload.
+    /// </summary>
+    public static unsafe (long Raw, long Compressed, long CompressedWithDictionary) Measure(
+        IReadOnlyList<byte[]> samples, LZ4Dictionary dictionary)
+    {
+        long raw = 0, compressed = 0, withDictionary = 0;
+        byte[] output = new byte[64 * 1024];
+
+        fixed (byte* dst = output)
+        {
+            foreach (var sample in samples)
+            {
+                raw += sample.Length;
+
+                fixed (byte* src = sample)
+                {
+                    int capacity = Math.Min(sample.Length - 1, output.Length);
+                    int plain = capacity > 0 ? LZ4.Compress(src, sample.Length, dst, capacity) : 0;
+                    int dict = capacity > 0 ? LZ4.CompressWithDictionary(src, sample.Length, dst, capacity, dictionary) : 0;
+
+                    compressed += plain > 0 ? plain : sample.Length;
+                    withDictionary += dict > 0 ? dict : sample.Length;
+                }
+            }
+        }
+
+        return (raw, compressed, withDictionary);
+    }
+
+    private static ulong Gram(byte[] data, int index, int length)
+    {
+        ulong value = 0;
+
+        for (int i = 0; i < length; i++)
+            value |= (ulong)data[index + i] << (i * 8);
+
+        return value;
+    }
+}
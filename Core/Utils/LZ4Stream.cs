@@ -0,0 +1,270 @@
+/*
+ * LZ4 Stream
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+using System.Runtime.CompilerServices;
+
+/// <summary>
+/// LZ4 over an ordered channel: every message joins a sliding 64 KB history the following messages
+/// can match against, so payloads repeated across packets shrink to a few bytes. The encoder keeps
+/// its hash table between calls instead of rebuilding it per message. Both ends must process the
+/// same messages in the same order, but since offsets are relative an encoder holding only a suffix
+/// of the decoder's history (fresh, or Reset on its own) still decodes correctly. Not thread-safe.
+/// </summary>
+public sealed class LZ4Stream
+{
+    public const int HistorySize = 64 * 1024;
+    public const int MaxMessageSize = 64 * 1024;
+
+    private const int HashLog = 12;
+    private const int HashSize = 1 << HashLog;
+    private const uint HashMultiplier = 2654435761u;
+
+    private byte[] _buffer;     // [history][message being processed], allocated on first use
+    private uint[] _hashTable;  // Encoder only, buffer position + 1 of each hashed sequence
+    private int _position;      // End of the history within the buffer
+
+    public int HistoryLength => Math.Min(_position, HistorySize);
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static int Hash(uint value)
+    {
+        return (int)((value * HashMultiplier) >> ((LZ4.MinMatch * 8) - HashLog));
+    }
+
+    public void Reset()
+    {
+        _position = 0;
+
+        if (_hashTable != null)
+            Array.Clear(_hashTable);
+    }
+
+    // Slides the history to the front of the buffer when size more bytes would not fit behind it
+    private int Reserve(int size)
+    {
+        _buffer ??= new byte[HistorySize + MaxMessageSize];
+
+        if (_position + size > _buffer.Length)
+        {
+            int keep = Math.Min(_position, HistorySize);
+            uint delta = (uint)(_position - keep);
+
+            Buffer.BlockCopy(_buffer, (int)delta, _buffer, 0, keep);
+            _position = keep;
+
+            // Rebase the encoder's positions, whatever slid out of the buffer is forgotten
+            if (_hashTable != null)
+            {
+                for (int i = 0; i < _hashTable.Length; i++)
+                    _hashTable[i] = _hashTable[i] > delta ? _hashTable[i] - delta : 0;
+            }
+        }
+
+        return _position;
+    }
+
+    /// <summary>
+    /// Encoder. The source always joins the history; returns 0 when the result does not fit the destination.
+    /// </summary>
+    public unsafe int Compress(ReadOnlySpan<byte> source, Span<byte> destination)
+    {
+        if (source.Length > MaxMessageSize)
+            return 0;
+
+        _hashTable ??= new uint[HashSize];
+
+        // The message goes right behind the history, so matching earlier messages and matching itself are the same
+        int start = Reserve(source.Length);
+        source.CopyTo(_buffer.AsSpan(start));
+        _position += source.Length;
+
+        fixed (byte* basePtr = _buffer)
+        fixed (byte* dst = destination)
+        fixed (uint* table = _hashTable)
+        {
+            byte* ip = basePtr + start;
+            byte* anchor = ip;
+            byte* iend = ip + source.Length;
+            byte* mflimit = iend - LZ4.MinMatch;
+            byte* op = dst;
+            byte* oend = dst + destination.Length;
+
+            while (ip < mflimit)
+            {
+                uint sequence = *(uint*)ip;
+                int h = Hash(sequence);
+                uint entry = table[h];
+                table[h] = (uint)(ip - basePtr) + 1;
+
+                if (entry == 0)
+                {
+                    ip++;
+                    continue;
+                }
+
+                byte* refp = basePtr + (entry - 1);
+                int offset = (int)(ip - refp);
+
+                if (offset >= 0xFFFF || *(uint*)refp != sequence)
+                {
+                    ip++;
+                    continue;
+                }
+
+                int literalLength = (int)(ip - anchor);
+                byte* matchStart = ip;
+
+                ip += LZ4.MinMatch;
+                refp += LZ4.MinMatch;
+
+                while (ip < mflimit && *(uint*)ip == *(uint*)refp)
+                {
+                    ip += 4;
+                    refp += 4;
+                }
+
+                while (ip < iend && *ip == *refp)
+                {
+                    ip++;
+                    refp++;
+                }
+
+                int matchLength = (int)(ip - matchStart) - LZ4.MinMatch;
+
+                // Token, both length extensions, literals and offset
+                if (op + 1 + literalLength / 255 + 1 + literalLength + 2 + matchLength / 255 + 1 > oend)
+                    return 0;
+
+                byte* token = op++;
+                *token = (byte)((Math.Min(literalLength, 15) << 4) | Math.Min(matchLength, 15));
+
+                if (literalLength >= 15)
+                    WriteLength(ref op, literalLength - 15);
+
+                for (int i = 0; i < literalLength; i++)
+                    *op++ = anchor[i];
+
+                *op++ = (byte)offset;
+                *op++ = (byte)(offset >> 8);
+
+                if (matchLength >= 15)
+                    WriteLength(ref op, matchLength - 15);
+
+                anchor = ip;
+            }
+
+            int lastLit = (int)(iend - anchor);
+
+            if (op + 1 + lastLit / 255 + 1 + lastLit > oend)
+                return 0;
+
+            *op++ = (byte)(Math.Min(lastLit, 15) << 4);
+
+            if (lastLit >= 15)
+                WriteLength(ref op, lastLit - 15);
+
+            for (int i = 0; i < lastLit; i++)
+                *op++ = anchor[i];
+
+            return (int)(op - dst);
+        }
+    }
+
+    /// <summary>
+    /// Decoder. The message written to the destination joins the history; returns 0 on malformed input.
+    /// </summary>
+    public unsafe int Decompress(ReadOnlySpan<byte> source, Span<byte> destination)
+    {
+        int capacity = Math.Min(destination.Length, MaxMessageSize);
+        int start = Reserve(capacity);
+        int length;
+
+        fixed (byte* basePtr = _buffer)
+        fixed (byte* src = source)
+        {
+            // Earlier messages sit right in front of the output, the block decoder reads them as its dictionary
+            byte* message = basePtr + start;
+            length = LZ4.DecompressBlock(src, source.Length, message, capacity, message, start);
+        }
+
+        if (length <= 0)
+            return 0;
+
+        _buffer.AsSpan(start, length).CopyTo(destination);
+        _position += length;
+
+        return length;
+    }
+
+    /// <summary>
+    /// Decoder, decoding straight into the history. The message is valid until the next call.
+    /// </summary>
+    public unsafe bool TryDecompress(ReadOnlySpan<byte> source, out ReadOnlySpan<byte> message)
+    {
+        int start = Reserve(MaxMessageSize);
+        int length;
+
+        fixed (byte* basePtr = _buffer)
+        fixed (byte* src = source)
+        {
+            byte* output = basePtr + start;
+            length = LZ4.DecompressBlock(src, source.Length, output, MaxMessageSize, output, start);
+        }
+
+        if (length <= 0)
+        {
+            message = default;
+            return false;
+        }
+
+        message = _buffer.AsSpan(start, length);
+        _position += length;
+
+        return true;
+    }
+
+    /// <summary>
+    /// Decoder, for messages of the stream that travelled uncompressed.
+    /// </summary>
+    public void Append(ReadOnlySpan<byte> data)
+    {
+        if (data.Length == 0 || data.Length > MaxMessageSize)
+            return;
+
+        int start = Reserve(data.Length);
+        data.CopyTo(_buffer.AsSpan(start));
+        _position += data.Length;
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static unsafe void WriteLength(ref byte* op, int length)
+    {
+        while (length >= 255)
+        {
+            *op++ = 255;
+            length -= 255;
+        }
+
+        *op++ = (byte)length;
+    }
+}
@@ -26,6 +26,8 @@
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
 #include "Network/UFlatBuffer.h"
+#include "Network/NetEventQueue.h"
+#include "Network/ServerPackets.h"
 #include "UObject/Object.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "Containers/Ticker.h"
@@ -95,6 +97,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "UDP")
 	void SetRetryEnabled(bool bEnabled);
 
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetConnectionMigrationEnabled(bool bEnabled);
+
 	UFUNCTION(BlueprintCallable, Category = "UDP")
 	float GetConnectTimeout() const;
 
@@ -104,6 +109,72 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "UDP")
     bool IsRetryEnabled() const;
 
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetLatencyMode(ENetLatencyMode Mode);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	ENetLatencyMode GetLatencyMode() const;
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetSpinWaitMicroseconds(int32 Microseconds);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetBatchedIOEnabled(bool bEnabled);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetMaxPacketSize(int32 Bytes);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetCoalescingEnabled(bool bEnabled);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetFlushIntervalMs(float Milliseconds);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void FlushOutgoing();
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetReliableTimeoutMs(int32 Milliseconds);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetMaxRetries(int32 Retries);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	float GetRoundTripTimeMs() const;
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetCongestionControl(ECongestionControl Algorithm);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetPacingEnabled(bool bEnabled);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	FNetCongestionStats GetCongestionStats() const;
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetCompression(bool bEnabled, int32 ThresholdBytes);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetCompressionLevel(int32 Acceleration, int32 HighCompressionThresholdBytes);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	float GetCompressionRatio() const;
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	bool SetCompressionDictionary(const FString& Path);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetStreamCompressionEnabled(bool bEnabled);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetOmitAEADChecksum(bool bEnabled);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetAES256GCMEnabled(bool bEnabled);
+
+	UFUNCTION(BlueprintCallable, Category = "UDP")
+	void SetSessionResumptionEnabled(bool bEnabled);
+
     void SendEntitySync(FVector Position, FRotator Rotation, int32 AnimID, FVector Velocity, bool IsFalling) const;
     void SendEntitySyncQuantized(FVector Position, FRotator Rotation, int32 AnimID, FVector Velocity, bool IsFalling) const;
 
@@ -116,6 +187,21 @@ private:
 	FTSTicker::FDelegateHandle TickHandle;
 	bool Tick(float DeltaTime);
 
+	// Network thread -> game thread handoff, drained once per frame in Tick
+	FNetEventQueue NetEvents;
+	void QueueEvent(const FNetEvent& Event);
+	void QueuePacketEvent(EServerPackets Type);
+	void QueueRawPacketEvent(EServerPackets Type, const uint8* Data, int32 Length);
+	void DispatchEvent(const FNetEvent& Event);
+
+	template<typename T>
+	void QueuePacketEvent(EServerPackets Type, const T& Packet)
+	{
+		FNetEvent Event(ENetEventKind::Packet, static_cast<uint8>(Type));
+		Event.Store(Packet);
+		QueueEvent(Event);
+	}
+
 	TUniquePtr<class UDPClient> UdpClient;
 
 	FSocket* Socket = nullptr;
@@ -0,0 +1,49 @@
+namespace Tests
+{
+    public class RttEstimatorTests : AbstractTest
+    {
+        public RttEstimatorTests()
+        {
+            Describe("RttEstimator", () =>
+            {
+                It("should use the initial timeout until the first sample", () =>
+                {
+                    var rtt = new RttEstimator(250);
+
+                    Expect(rtt.HasSample).ToBe(false);
+                    Expect(rtt.TimeoutMs).ToBe(250.0);
+                });
+
+                It("should derive the timeout from the first sample", () =>
+                {
+                    var rtt = new RttEstimator(250);
+                    rtt.AddSample(100);
+
+                    Expect(rtt.SmoothedRttMs).ToBe(100.0);
+                    Expect(rtt.RttVarianceMs).ToBe(50.0);
+                    Expect(rtt.TimeoutMs).ToBe(300.0);
+                });
+
+                It("should smooth later samples", () =>
+                {
+                    var rtt = new RttEstimator(250);
+                    rtt.AddSample(100);
+                    rtt.AddSample(20);
+
+                    Expect(rtt.SmoothedRttMs).ToBe(90.0);
+                    Expect(rtt.RttVarianceMs).ToBe(57.5);
+                    Expect(rtt.LatestRttMs).ToBe(20.0);
+                });
+
+                It("should back off exponentially up to the maximum", () =>
+                {
+                    var rtt = new RttEstimator(100);
+
+                    Expect(rtt.GetRetransmitTimeoutMs(0)).ToBe(100.0);
+                    Expect(rtt.GetRetransmitTimeoutMs(2)).ToBe(400.0);
+                    Expect(rtt.GetRetransmitTimeoutMs(10)).ToBe(RttEstimator.MaxTimeoutMs);
+                });
+            });
+        }
+    }
+}
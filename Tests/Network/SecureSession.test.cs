@@ -209,6 +209,82 @@ namespace Tests
                     var session = CreateTestSession(12345);
                     Expect(true).ToBe(true); 
                 });
+
+                It("should check a sequence without moving the window", () =>
+                {
+                    var session = CreateTestSession(12345);
+
+                    Expect(session.IsSequenceValid(7)).ToBe(true);
+                    Expect(session.IsSequenceValid(7)).ToBe(true);
+                    Expect(session.IsSequenceValid(1000)).ToBe(true);
+                    Expect(session.IsSequenceValid(7)).ToBe(true);
+                });
+            });
+
+            Describe("SecureSession Options", () =>
+            {
+                It("should keep the checksum until it is negotiated away", () =>
+                {
+                    var session = CreateTestSession(12345);
+                    Expect(session.ChecksumEnabled).ToBe(true);
+
+                    session.Options = SessionOptions.NoChecksum;
+                    Expect(session.ChecksumEnabled).ToBe(false);
+                });
+
+                It("should name the negotiated suite in the AEAD header bits", () =>
+                {
+                    var session = CreateTestSession(12345);
+                    Expect(session.AeadFlag).ToBe(PacketHeaderFlags.AEAD_ChaCha20Poly1305);
+
+                    session.Options = SessionOptions.AES256GCM;
+                    Expect(session.AeadFlag).ToBe(PacketHeaderFlags.AEAD_AES256GCM);
+
+                    var flags = PacketHeaderFlags.Encrypted | PacketHeaderFlags.Compressed | session.AeadFlag;
+                    Expect(flags.GetAead()).ToBe(PacketHeaderFlags.AEAD_AES256GCM);
+                });
+
+                It("should exchange packets over AES-256-GCM", () =>
+                {
+                    if (!AesGcm.IsSupported)
+                        return;
+
+                    var server = CreateTestSession(12345);
+                    server.Options = SessionOptions.AES256GCM;
+                    var client = CreatePeerSession(server);
+
+                    byte[] plaintext = System.Text.Encoding.UTF8.GetBytes("sealed with AES-256-GCM");
+                    byte[] aad = new byte[PacketHeader.Size];
+                    byte[] ciphertext = new byte[plaintext.Length + SecureSession.TagSize];
+                    byte[] decrypted = new byte[plaintext.Length];
+
+                    Expect(server.EncryptPayload(plaintext, aad, ciphertext, out int ciphertextLength)).ToBe(true);
+                    Expect(ciphertextLength).ToBe(plaintext.Length + SecureSession.TagSize);
+                    Expect(client.DecryptPayload(ciphertext, aad, 0, decrypted, out int decryptedLength)).ToBe(true);
+                    Expect(decrypted.AsSpan(0, decryptedLength).SequenceEqual(plaintext)).ToBe(true);
+
+                    ciphertext[0] ^= 0x01;
+                    Expect(client.DecryptPayload(ciphertext, aad, 1, decrypted, out _)).ToBe(false);
+                });
+
+                It("should not open packets sealed with the other suite", () =>
+                {
+                    if (!AesGcm.IsSupported)
+                        return;
+
+                    var server = CreateTestSession(12345);
+                    server.Options = SessionOptions.AES256GCM;
+                    var client = CreatePeerSession(server);
+                    client.Options = SessionOptions.None;
+
+                    byte[] plaintext = System.Text.Encoding.UTF8.GetBytes("suite mismatch");
+                    byte[] aad = new byte[PacketHeader.Size];
+                    byte[] ciphertext = new byte[plaintext.Length + SecureSession.TagSize];
+                    byte[] decrypted = new byte[plaintext.Length];
+
+                    Expect(server.EncryptPayload(plaintext, aad, ciphertext, out _)).ToBe(true);
+                    Expect(client.DecryptPayload(ciphertext, aad, 0, decrypted, out _)).ToBe(false);
+                });
             });
 
             Describe("SecureSession Rekey Operations", () =>
@@ -304,6 +380,63 @@ namespace Tests
                     Expect(ciphertextLen).ToBe(plaintext.Length + 16);
                 });
             });
+
+            Describe("SecureSession Compression", () =>
+            {
+                It("should skip payloads below the compression threshold", () =>
+                {
+                    var session = CreateTestSession(12345);
+                    session.ConfigureCompression(true, 512);
+
+                    Expect(session.ShouldCompress(511)).ToBe(false);
+                    Expect(session.ShouldCompress(512)).ToBe(true);
+                });
+
+                It("should never compress when compression is disabled", () =>
+                {
+                    var session = CreateTestSession(12345);
+                    session.ConfigureCompression(false, 512);
+
+                    Expect(session.ShouldCompress(4096)).ToBe(false);
+                });
+
+                It("should compress repetitive payloads and track the ratio", () =>
+                {
+                    var session = CreateTestSession(12345);
+                    session.ConfigureCompression(true, 64);
+
+                    byte[] plaintext = new byte[1024];
+                    for (int i = 0; i < plaintext.Length; i++)
+                        plaintext[i] = (byte)(i % 16);
+
+                    byte[] compressed = new byte[plaintext.Length];
+                    int compressedLength = session.Compress(plaintext, compressed);
+
+                    Expect(compressedLength).ToBeGreaterThan(0);
+                    Expect(compressedLength).ToBeLessThan(plaintext.Length);
+                    Expect(session.CompressionRatio).ToBeLessThan(0.5f);
+                });
+
+                It("should back off on incompressible payloads and probe again later", () =>
+                {
+                    var session = CreateTestSession(12345);
+                    session.ConfigureCompression(true, 64);
+
+                    byte[] plaintext = new byte[1024];
+                    RandomNumberGenerator.Fill(plaintext);
+                    byte[] compressed = new byte[plaintext.Length];
+
+                    Expect(session.ShouldCompress(plaintext.Length)).ToBe(true);
+                    Expect(session.Compress(plaintext, compressed)).ToBe(0);
+                    Expect(session.CompressionRatio).ToBe(1f);
+
+                    int skipped = 0;
+                    while (!session.ShouldCompress(plaintext.Length))
+                        skipped++;
+
+                    Expect(skipped).ToBe(31);
+                });
+            });
         }
 
         private SecureSession CreateTestSession(uint connectionId)
@@ -329,6 +462,22 @@ namespace Tests
             }
         }
 
+        // The other end of a session: same connection id and suite, directions swapped
+        private static unsafe SecureSession CreatePeerSession(SecureSession session)
+        {
+            var peer = new SecureSession();
+            peer.ConnectionId = session.ConnectionId;
+            peer.Options = session.Options;
+
+            for (int i = 0; i < 32; i++)
+            {
+                peer.TxKey[i] = session.RxKey[i];
+                peer.RxKey[i] = session.TxKey[i];
+            }
+
+            return peer;
+        }
+
         private byte[] GenerateTestPublicKey()
         {
             byte[] key = new byte[32];
@@ -0,0 +1,145 @@
+using System.Security.Cryptography;
+
+namespace Tests
+{
+    public class SessionTicketManagerTests : AbstractTest
+    {
+        public SessionTicketManagerTests()
+        {
+            Describe("SessionTicketManager Tickets", () =>
+            {
+                It("should redeem a ticket exactly once", () =>
+                {
+                    byte[] secret = GenerateTestSecret();
+                    byte[] ticket = SessionTicketManager.Issue(secret);
+                    byte[] redeemed = new byte[SecureSession.ResumptionSecretSize];
+
+                    Expect(ticket.Length).ToBe(SessionTicketManager.TicketSize);
+                    Expect(SessionTicketManager.TryRedeem(ticket, redeemed)).ToBe(true);
+                    Expect(redeemed.SequenceEqual(secret)).ToBe(true);
+                    Expect(SessionTicketManager.TryRedeem(ticket, redeemed)).ToBe(false);
+                });
+
+                It("should reject tampered tickets", () =>
+                {
+                    byte[] redeemed = new byte[SecureSession.ResumptionSecretSize];
+
+                    foreach (int offset in new[] { 0, 12, SessionTicketManager.TicketSize - 1 })
+                    {
+                        byte[] ticket = SessionTicketManager.Issue(GenerateTestSecret());
+                        ticket[offset] ^= 0x01;
+
+                        Expect(SessionTicketManager.TryRedeem(ticket, redeemed)).ToBe(false);
+                    }
+
+                    Expect(SessionTicketManager.TryRedeem(new byte[SessionTicketManager.TicketSize - 1], redeemed)).ToBe(false);
+                });
+
+                It("should reject tickets past their lifetime", () =>
+                {
+                    var lifetime = SessionTicketManager.Lifetime;
+                    byte[] ticket = SessionTicketManager.Issue(GenerateTestSecret());
+                    byte[] redeemed = new byte[SecureSession.ResumptionSecretSize];
+
+                    try
+                    {
+                        SessionTicketManager.Lifetime = TimeSpan.FromMilliseconds(1);
+                        Expect(SessionTicketManager.TryRedeem(ticket, redeemed)).ToBe(false);
+                    }
+                    finally
+                    {
+                        SessionTicketManager.Lifetime = lifetime;
+                    }
+                });
+            });
+
+            Describe("SecureSession Resumption", () =>
+            {
+                It("should derive the resumption secret the client derives", () =>
+                {
+                    var (_, _, server) = SecureSession.CreateAsServer(GenerateTestSecret(), 1001);
+                    var client = Mirror(server);
+
+                    byte[] serverSecret = new byte[SecureSession.ResumptionSecretSize];
+                    server.DeriveResumptionSecret(serverSecret);
+
+                    // The client side HKDF: its own Tx (client to server) key first, then its Rx key
+                    byte[] ikm = new byte[64];
+                    byte[] salt = new byte[16];
+                    unsafe
+                    {
+                        new ReadOnlySpan<byte>(client.TxKey, 32).CopyTo(ikm);
+                        new ReadOnlySpan<byte>(client.RxKey, 32).CopyTo(ikm.AsSpan(32));
+                        new ReadOnlySpan<byte>(client.SessionSalt, 16).CopyTo(salt);
+                    }
+
+                    byte[] clientSecret = HKDF.DeriveKey(HashAlgorithmName.SHA256, ikm, SecureSession.ResumptionSecretSize, salt,
+                        System.Text.Encoding.ASCII.GetBytes("ToS-UE5 v1 resumption"));
+
+                    Expect(serverSecret.SequenceEqual(clientSecret)).ToBe(true);
+                });
+
+                It("should key each resumed session afresh", () =>
+                {
+                    byte[] secret = GenerateTestSecret();
+                    byte[] nonce = new byte[SecureSession.ResumeNonceSize];
+                    RandomNumberGenerator.Fill(nonce);
+
+                    var (salt1, session1) = SecureSession.CreateFromResumption(secret, nonce, 2001);
+                    var (salt2, session2) = SecureSession.CreateFromResumption(secret, nonce, 2002);
+
+                    Expect(salt1.SequenceEqual(salt2)).ToBe(false);
+                    Expect(session1.GetTxKeyHex()).NotToBe(session2.GetTxKeyHex());
+                    Expect(session1.ConnectionId).ToBe(2001U);
+                });
+
+                It("should exchange packets over a resumed session", () =>
+                {
+                    byte[] nonce = new byte[SecureSession.ResumeNonceSize];
+                    RandomNumberGenerator.Fill(nonce);
+
+                    var (_, server) = SecureSession.CreateFromResumption(GenerateTestSecret(), nonce, 3001);
+                    var client = Mirror(server);
+
+                    byte[] plaintext = System.Text.Encoding.UTF8.GetBytes("resumed");
+                    byte[] aad = new byte[PacketHeader.Size];
+                    byte[] ciphertext = new byte[plaintext.Length + 16];
+                    byte[] decrypted = new byte[plaintext.Length];
+
+                    Expect(server.EncryptPayload(plaintext, aad, ciphertext, out int ciphertextLength)).ToBe(true);
+                    Expect(client.DecryptPayload(ciphertext.AsSpan(0, ciphertextLength), aad, 0, decrypted, out int decryptedLength)).ToBe(true);
+                    Expect(decryptedLength).ToBe(plaintext.Length);
+                    Expect(decrypted.SequenceEqual(plaintext)).ToBe(true);
+                });
+            });
+        }
+
+        // The peer of a session: same salt and connection id, directions swapped
+        private static unsafe SecureSession Mirror(SecureSession session)
+        {
+            SecureSession peer = default;
+
+            for (int i = 0; i < 32; i++)
+            {
+                peer.TxKey[i] = session.RxKey[i];
+                peer.RxKey[i] = session.TxKey[i];
+            }
+
+            for (int i = 0; i < 16; i++)
+                peer.SessionSalt[i] = session.SessionSalt[i];
+
+            peer.ConnectionId = session.ConnectionId;
+            return peer;
+        }
+
+        private byte[] GenerateTestSecret()
+        {
+            byte[] secret = new byte[32];
+            using (var rng = RandomNumberGenerator.Create())
+            {
+                rng.GetBytes(secret);
+            }
+            return secret;
+        }
+    }
+}
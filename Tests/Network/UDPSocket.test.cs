@@ -263,6 +263,219 @@ namespace Tests
                     Expect(udpSocket.EntityId).ToBe(12345u);
                 });
 
+                It("should reassemble fragments arriving out of order", () =>
+                {
+                    var serverSocket = new Socket();
+                    var udpSocket = new UDPSocket(serverSocket);
+
+                    FlatBuffer MakeFragment(ushort offset, byte[] chunk)
+                    {
+                        var fragment = new FlatBuffer(8 + chunk.Length);
+                        fragment.Write((ushort)7);
+                        fragment.Write(offset);
+                        fragment.Write((uint)10);
+                        fragment.WriteBytes(chunk);
+                        fragment.RestorePosition(0);
+                        return fragment;
+                    }
+
+                    var second = MakeFragment(6, new byte[] { 6, 7, 8, 9 });
+                    var first = MakeFragment(0, new byte[] { 0, 1, 2, 3, 4, 5 });
+
+                    bool done = udpSocket.AppendFragment(second, second.Capacity, out _);
+                    Expect(done).ToBe(false);
+
+                    done = udpSocket.AppendFragment(first, first.Capacity, out var message);
+                    Expect(done).ToBe(true);
+                    Expect(message.Capacity).ToBe(10);
+                    Expect(message.Read<byte>()).ToBe((byte)0);
+
+                    message.RestorePosition(9);
+                    Expect(message.Read<byte>()).ToBe((byte)9);
+                    Expect(udpSocket.Fragments.Count).ToBe(0);
+
+                    message.Free();
+                    first.Free();
+                    second.Free();
+                });
+
+                It("should reject fragments that overrun the message", () =>
+                {
+                    var serverSocket = new Socket();
+                    var udpSocket = new UDPSocket(serverSocket);
+
+                    var fragment = new FlatBuffer(8 + 6);
+                    fragment.Write((ushort)3);
+                    fragment.Write((ushort)8);
+                    fragment.Write((uint)10);
+                    fragment.WriteBytes(new byte[] { 1, 2, 3, 4, 5, 6 });
+                    fragment.RestorePosition(0);
+
+                    bool done = udpSocket.AppendFragment(fragment, fragment.Capacity, out _);
+                    Expect(done).ToBe(false);
+                    Expect(udpSocket.Fragments.Count).ToBe(0);
+
+                    fragment.Free();
+                });
+
+                It("should not complete a message from duplicated fragments", () =>
+                {
+                    var serverSocket = new Socket();
+                    var udpSocket = new UDPSocket(serverSocket);
+
+                    FlatBuffer MakeFragment(ushort offset, byte[] chunk)
+                    {
+                        var fragment = new FlatBuffer(8 + chunk.Length);
+                        fragment.Write((ushort)9);
+                        fragment.Write(offset);
+                        fragment.Write((uint)12);
+                        fragment.WriteBytes(chunk);
+                        fragment.RestorePosition(0);
+                        return fragment;
+                    }
+
+                    var first = MakeFragment(0, new byte[] { 0, 1, 2, 3 });
+                    var duplicate = MakeFragment(0, new byte[] { 0, 1, 2, 3 });
+                    var last = MakeFragment(8, new byte[] { 8, 9, 10, 11 });
+                    var middle = MakeFragment(4, new byte[] { 4, 5, 6, 7 });
+
+                    Expect(udpSocket.AppendFragment(first, first.Capacity, out _)).ToBe(false);
+                    Expect(udpSocket.AppendFragment(duplicate, duplicate.Capacity, out _)).ToBe(false);
+                    Expect(udpSocket.AppendFragment(last, last.Capacity, out _)).ToBe(false);
+
+                    bool done = udpSocket.AppendFragment(middle, middle.Capacity, out var message);
+                    Expect(done).ToBe(true);
+                    message.RestorePosition(5);
+                    Expect(message.Read<byte>()).ToBe((byte)5);
+
+                    message.Free();
+                    first.Free();
+                    duplicate.Free();
+                    last.Free();
+                    middle.Free();
+                });
+
+                It("should reject fragments of messages larger than a client can send", () =>
+                {
+                    var serverSocket = new Socket();
+                    var udpSocket = new UDPSocket(serverSocket);
+
+                    var fragment = new FlatBuffer(8 + 4);
+                    fragment.Write((ushort)5);
+                    fragment.Write((ushort)0);
+                    fragment.Write(uint.MaxValue);
+                    fragment.WriteBytes(new byte[] { 1, 2, 3, 4 });
+                    fragment.RestorePosition(0);
+
+                    bool done = udpSocket.AppendFragment(fragment, fragment.Capacity, out _);
+                    Expect(done).ToBe(false);
+                    Expect(udpSocket.Fragments.Count).ToBe(0);
+
+                    fragment.Free();
+                });
+
+                It("should release packets covered by a cumulative and selective ack", () =>
+                {
+                    var serverSocket = new Socket();
+                    var udpSocket = new UDPSocket(serverSocket);
+
+                    for (short sequence = 1; sequence <= 5; sequence++)
+                        udpSocket.AddReliablePacket(sequence, new FlatBuffer(16));
+
+                    // Cumulative 2 covers 1 and 2, bit 1 of the mask covers 2 + 2 + 1 = 5
+                    udpSocket.ProcessAcknowledgment(2, 0b10);
+
+                    Expect(udpSocket.ReliablePackets.Count).ToBe(2);
+                    Expect(udpSocket.ReliablePackets.ContainsKey(3)).ToBe(true);
+                    Expect(udpSocket.ReliablePackets.ContainsKey(4)).ToBe(true);
+
+                    udpSocket.ProcessAcknowledgment(4, 0);
+                    Expect(udpSocket.ReliablePackets.Count).ToBe(0);
+                });
+
+                It("should disconnect once a reliable packet runs out of retries", () =>
+                {
+                    var serverSocket = new Socket();
+                    var udpSocket = new UDPSocket(serverSocket);
+                    udpSocket.State = ConnectionState.Connected;
+
+                    udpSocket.AddReliablePacket(1, new FlatBuffer(16));
+                    udpSocket.ReliablePackets[1].RetryCount = UDPServer.MaxRetries - 1;
+                    udpSocket.ReliablePackets[1].SentAt = DateTime.MinValue;
+
+                    Expect(udpSocket.Update(0.1f)).ToBe(false);
+                    Expect(udpSocket.Reason).ToBe(DisconnectReason.ReliableDeliveryFailed);
+                    Expect(udpSocket.ReliablePackets.Count).ToBe(0);
+                });
+
+                It("should deliver each reliable stream without waiting on another stream's gap", () =>
+                {
+                    var serverSocket = new Socket();
+                    var udpSocket = new UDPSocket(serverSocket);
+
+                    FlatBuffer MakeMessage(byte marker)
+                    {
+                        var message = new FlatBuffer(1);
+                        message.Write(marker);
+                        message.RestorePosition(0);
+                        return message;
+                    }
+
+                    // Reliable sequence 1, the first chat message, is lost
+                    udpSocket.ProcessReliablePacket(2, ReliableStream.World, 1, MakeMessage(20));
+                    udpSocket.ProcessReliablePacket(3, ReliableStream.Chat, 2, MakeMessage(12));
+
+                    Expect(udpSocket.ReliableEventQueue.Reader.TryRead(out var delivered)).ToBe(true);
+                    Expect(delivered.Read<byte>()).ToBe((byte)20);
+                    Expect(udpSocket.ReliableEventQueue.Reader.TryRead(out _)).ToBe(false);
+                    delivered.Free();
+
+                    // The retransmit releases the chat stream in order
+                    udpSocket.ProcessReliablePacket(1, ReliableStream.Chat, 1, MakeMessage(11));
+
+                    Expect(udpSocket.ReliableEventQueue.Reader.TryRead(out delivered)).ToBe(true);
+                    Expect(delivered.Read<byte>()).ToBe((byte)11);
+                    delivered.Free();
+
+                    Expect(udpSocket.ReliableEventQueue.Reader.TryRead(out delivered)).ToBe(true);
+                    Expect(delivered.Read<byte>()).ToBe((byte)12);
+                    delivered.Free();
+                });
+
+                It("should drop reliable packets beyond the receive window unacknowledged", () =>
+                {
+                    var serverSocket = new Socket();
+                    var udpSocket = new UDPSocket(serverSocket);
+
+                    FlatBuffer MakeMessage(byte marker)
+                    {
+                        var message = new FlatBuffer(1);
+                        message.Write(marker);
+                        message.RestorePosition(0);
+                        return message;
+                    }
+
+                    // In order on its stream, but too far past the shared sequence to be tracked
+                    udpSocket.ProcessReliablePacket(UDPSocket.ReliableReceiveWindow + 1, ReliableStream.World, 1, MakeMessage(30));
+                    Expect(udpSocket.ReliableEventQueue.Reader.TryRead(out _)).ToBe(false);
+
+                    // Within the shared window, but too far past its own stream
+                    udpSocket.ProcessReliablePacket(2, ReliableStream.Chat, UDPSocket.ReliableReceiveWindow + 2, MakeMessage(31));
+                    Expect(udpSocket.ReliableEventQueue.Reader.TryRead(out _)).ToBe(false);
+
+                    // Neither was acknowledged, so both sequences are still open
+                    udpSocket.ProcessReliablePacket(1, ReliableStream.World, 1, MakeMessage(10));
+                    udpSocket.ProcessReliablePacket(2, ReliableStream.Chat, 1, MakeMessage(11));
+
+                    Expect(udpSocket.ReliableEventQueue.Reader.TryRead(out var delivered)).ToBe(true);
+                    Expect(delivered.Read<byte>()).ToBe((byte)10);
+                    delivered.Free();
+
+                    Expect(udpSocket.ReliableEventQueue.Reader.TryRead(out delivered)).ToBe(true);
+                    Expect(delivered.Read<byte>()).ToBe((byte)11);
+                    delivered.Free();
+                });
+
                 It("should handle packet flags", () =>
                 {
                     var serverSocket = new Socket();
@@ -272,6 +485,55 @@ namespace Tests
                     Expect((int)udpSocket.Flags).ToBe((int)(PacketFlags.XOR | PacketFlags.Encrypted));
                 });
             });
+
+            Describe("UDPSocket Path Validation", () =>
+            {
+                It("should only accept the challenge echoed from the new address", () =>
+                {
+                    var udpSocket = new UDPSocket(new Socket());
+                    var moved = new Address { port = 4001 };
+                    var other = new Address { port = 4002 };
+
+                    Expect(udpSocket.BeginPathChallenge(moved, out ulong challenge)).ToBe(true);
+                    Expect(challenge).NotToBe(0UL);
+                    Expect(udpSocket.TryCompletePathChallenge(other, challenge)).ToBe(false);
+                    Expect(udpSocket.TryCompletePathChallenge(moved, challenge + 1)).ToBe(false);
+                    Expect(udpSocket.TryCompletePathChallenge(moved, challenge)).ToBe(true);
+                    Expect(udpSocket.TryCompletePathChallenge(moved, challenge)).ToBe(false);
+                });
+
+                It("should repeat a challenge no faster than the interval", () =>
+                {
+                    var udpSocket = new UDPSocket(new Socket());
+                    var moved = new Address { port = 4001 };
+                    var movedAgain = new Address { port = 4002 };
+
+                    Expect(udpSocket.BeginPathChallenge(moved, out ulong first)).ToBe(true);
+                    Expect(udpSocket.BeginPathChallenge(moved, out _)).ToBe(false);
+
+                    // Moving again supersedes the challenge in flight
+                    Expect(udpSocket.BeginPathChallenge(movedAgain, out ulong second)).ToBe(true);
+                    Expect(udpSocket.TryCompletePathChallenge(moved, first)).ToBe(false);
+                    Expect(udpSocket.TryCompletePathChallenge(movedAgain, second)).ToBe(true);
+                });
+
+                It("should keep the session when the path changes", () =>
+                {
+                    var udpSocket = new UDPSocket(new Socket());
+                    var moved = new Address { port = 4001 };
+
+                    udpSocket.Id = 5001;
+                    udpSocket.Session.ConnectionId = 5001;
+                    udpSocket.Session.SeqTx = 42;
+                    udpSocket.TimeoutLeft = 3f;
+                    udpSocket.MigrateTo(moved);
+
+                    Expect(udpSocket.RemoteAddress.Equals(moved)).ToBe(true);
+                    Expect(udpSocket.Session.ConnectionId).ToBe(5001U);
+                    Expect(udpSocket.Session.SeqTx).ToBe(42UL);
+                    Expect(udpSocket.TimeoutLeft).ToBe(30f);
+                });
+            });
         }
     }
 }
@@ -188,6 +188,59 @@ namespace Tests
                         }
                     }
                 });
+
+                It("should reject a length that runs past the end of the input", () =>
+                {
+                    byte[] truncated = new byte[] { 0xF0, 0xFF, 0xFF };
+                    byte[] decompressed = new byte[1024];
+
+                    unsafe
+                    {
+                        fixed (byte* truncatedPtr = truncated, decompressedPtr = decompressed)
+                        {
+                            int decompressedSize = LZ4.Decompress(truncatedPtr, truncated.Length, decompressedPtr, decompressed.Length);
+                            Expect(decompressedSize).ToBe(0);
+                        }
+                    }
+                });
+
+                It("should never write past the output on mutated blocks", () =>
+                {
+                    byte[] input = new byte[2048];
+                    for (int i = 0; i < input.Length; i++)
+                        input[i] = (byte)((i * 7) % 13);
+
+                    byte[] compressed = new byte[4096];
+                    var random = new Random(1234);
+
+                    unsafe
+                    {
+                        fixed (byte* inputPtr = input, compressedPtr = compressed)
+                        {
+                            int compressedSize = LZ4.Compress(inputPtr, input.Length, compressedPtr, compressed.Length);
+                            Expect(compressedSize).ToBeGreaterThan(0);
+
+                            for (int round = 0; round < 2000; round++)
+                            {
+                                byte[] mutated = compressed.AsSpan(0, compressedSize).ToArray();
+                                mutated[random.Next(mutated.Length)] = (byte)random.Next(256);
+
+                                int capacity = random.Next(1, input.Length + 1);
+                                byte[] output = new byte[capacity + 32];
+                                output.AsSpan(capacity).Fill(0xCD);
+
+                                fixed (byte* mutatedPtr = mutated, outputPtr = output)
+                                {
+                                    int decompressedSize = LZ4.Decompress(mutatedPtr, mutated.Length, outputPtr, capacity);
+                                    Expect(decompressedSize <= capacity).ToBeTrue();
+                                }
+
+                                for (int i = capacity; i < output.Length; i++)
+                                    Expect(output[i]).ToBe((byte)0xCD);
+                            }
+                        }
+                    }
+                });
             });
 
             Describe("LZ4 Roundtrip Compression", () =>
@@ -217,6 +270,32 @@ namespace Tests
                     }
                 });
 
+                It("should roundtrip overlapping matches with short offsets", () =>
+                {
+                    for (int period = 1; period <= 9; period++)
+                    {
+                        byte[] input = new byte[300 + period];
+                        for (int i = 0; i < input.Length; i++)
+                            input[i] = (byte)(i < 20 ? i * 31 : 'a' + i % period);
+
+                        byte[] compressed = new byte[1024];
+                        byte[] decompressed = new byte[input.Length];
+
+                        unsafe
+                        {
+                            fixed (byte* inputPtr = input, compressedPtr = compressed, decompressedPtr = decompressed)
+                            {
+                                int compressedSize = LZ4.Compress(inputPtr, input.Length, compressedPtr, compressed.Length);
+                                Expect(compressedSize).ToBeGreaterThan(0);
+
+                                int decompressedSize = LZ4.Decompress(compressedPtr, compressedSize, decompressedPtr, decompressed.Length);
+                                Expect(decompressedSize).ToBe(input.Length);
+                                Expect(decompressed.AsSpan().SequenceEqual(input)).ToBeTrue();
+                            }
+                        }
+                    }
+                });
+
                 It("should roundtrip repetitive data correctly", () =>
                 {
                     byte[] input = new byte[1000];
@@ -322,6 +401,231 @@ namespace Tests
                     }
                 });
             });
+
+            Describe("LZ4 Levels", () =>
+            {
+                It("should roundtrip at every level with a reused state", () =>
+                {
+                    var state = new LZ4CompressState();
+                    LZ4Level[] levels = { LZ4Level.Fast(), LZ4Level.Fast(8), LZ4Level.Fast(LZ4Level.MaxAcceleration), LZ4Level.High(4), LZ4Level.High() };
+                    var random = new Random(42);
+
+                    for (int round = 0; round < 200; round++)
+                    {
+                        byte[] input = new byte[random.Next(0, 4096)];
+
+                        for (int i = 0; i < input.Length; i++)
+                            input[i] = round % 2 == 0 ? (byte)random.Next(256) : (byte)('a' + (i * 7 + round) % 11);
+
+                        byte[] compressed = new byte[input.Length + input.Length / 255 + 16];
+                        byte[] decompressed = new byte[input.Length];
+
+                        unsafe
+                        {
+                            fixed (byte* inputPtr = input, compressedPtr = compressed, decompressedPtr = decompressed)
+                            {
+                                int compressedSize = LZ4.Compress(inputPtr, input.Length, compressedPtr, compressed.Length, state, levels[round % levels.Length]);
+                                Expect(compressedSize).ToBeGreaterThan(0);
+
+                                int decompressedSize = LZ4.Decompress(compressedPtr, compressedSize, decompressedPtr, decompressed.Length);
+                                Expect(decompressedSize).ToBe(input.Length);
+                                Expect(decompressed.AsSpan().SequenceEqual(input)).ToBeTrue();
+                            }
+                        }
+                    }
+                });
+
+                It("should compress at least as well in High mode as in Fast mode", () =>
+                {
+                    var builder = new StringBuilder();
+                    var random = new Random(7);
+
+                    for (int i = 0; i < 300; i++)
+                        builder.Append($"entity {random.Next(50)} moved to {random.Next(1000)},{random.Next(1000)};");
+
+                    byte[] input = Encoding.ASCII.GetBytes(builder.ToString());
+                    byte[] compressed = new byte[input.Length + input.Length / 255 + 16];
+
+                    unsafe
+                    {
+                        fixed (byte* inputPtr = input, compressedPtr = compressed)
+                        {
+                            int fastSize = LZ4.Compress(inputPtr, input.Length, compressedPtr, compressed.Length, LZ4Level.Fast());
+                            int highSize = LZ4.Compress(inputPtr, input.Length, compressedPtr, compressed.Length, LZ4Level.High());
+
+                            Expect(fastSize).ToBeGreaterThan(0);
+                            Expect(highSize).ToBeGreaterThan(0);
+                            Expect(highSize).ToBeLessThanOrEqualTo(fastSize);
+                        }
+                    }
+                });
+
+                It("should leave blocks shorter than 13 bytes as literals", () =>
+                {
+                    byte[] input = new byte[12];
+                    byte[] compressed = new byte[64];
+
+                    unsafe
+                    {
+                        fixed (byte* inputPtr = input, compressedPtr = compressed)
+                        {
+                            // The last match has to start 12 bytes before the end, so nothing here can be one
+                            int compressedSize = LZ4.Compress(inputPtr, input.Length, compressedPtr, compressed.Length);
+                            Expect(compressedSize).ToBe(1 + input.Length);
+                            Expect(compressed[0]).ToBe((byte)(input.Length << 4));
+                        }
+                    }
+                });
+
+                It("should keep the last five bytes of a block as literals", () =>
+                {
+                    byte[] input = new byte[256];
+                    byte[] compressed = new byte[512];
+
+                    unsafe
+                    {
+                        fixed (byte* inputPtr = input, compressedPtr = compressed)
+                        {
+                            int compressedSize = LZ4.Compress(inputPtr, input.Length, compressedPtr, compressed.Length, LZ4Level.High());
+                            Expect(compressedSize).ToBeGreaterThan(0);
+
+                            // A run of zeros ends in a token of five literals followed by the literals themselves
+                            Expect(compressed[compressedSize - 6]).ToBe((byte)(5 << 4));
+                        }
+                    }
+                });
+            });
+
+            Describe("LZ4 Dictionary", () =>
+            {
+                It("should roundtrip a small packet against the dictionary", () =>
+                {
+                    byte[] dictionaryData = Encoding.ASCII.GetBytes("position rotation velocity animation falling entity update sync");
+                    var dictionary = new LZ4Dictionary(dictionaryData);
+                    byte[] input = Encoding.ASCII.GetBytes("entity sync position velocity");
+                    byte[] compressed = new byte[1024];
+                    byte[] decompressed = new byte[1024];
+
+                    unsafe
+                    {
+                        fixed (byte* inputPtr = input, compressedPtr = compressed, decompressedPtr = decompressed)
+                        {
+                            int compressedSize = LZ4.CompressWithDictionary(inputPtr, input.Length, compressedPtr, compressed.Length, dictionary);
+                            int plainSize = LZ4.Compress(inputPtr, input.Length, decompressedPtr, decompressed.Length);
+                            Expect(compressedSize).ToBeLessThan(plainSize);
+
+                            int decompressedSize = LZ4.DecompressWithDictionary(compressedPtr, compressedSize, decompressedPtr, decompressed.Length, dictionary);
+                            Expect(decompressedSize).ToBe(input.Length);
+                            Expect(Encoding.ASCII.GetString(decompressed, 0, decompressedSize)).ToBe("entity sync position velocity");
+                        }
+                    }
+                });
+
+                It("should reject offsets reaching past the dictionary", () =>
+                {
+                    var dictionary = new LZ4Dictionary(new byte[] { 1, 2, 3, 4, 5, 6, 7, 8 });
+                    // One literal, then a match 64 bytes back with only 9 bytes of history
+                    byte[] corrupted = new byte[] { 0x10, 0xAA, 0x40, 0x00 };
+                    byte[] decompressed = new byte[64];
+
+                    unsafe
+                    {
+                        fixed (byte* corruptedPtr = corrupted, decompressedPtr = decompressed)
+                        {
+                            int decompressedSize = LZ4.DecompressWithDictionary(corruptedPtr, corrupted.Length, decompressedPtr, decompressed.Length, dictionary);
+                            Expect(decompressedSize).ToBe(0);
+                        }
+                    }
+                });
+
+                It("should train a dictionary that shrinks repetitive packets", () =>
+                {
+                    var samples = new System.Collections.Generic.List<byte[]>();
+                    var random = new Random(7);
+
+                    for (int i = 0; i < 200; i++)
+                    {
+                        byte[] packet = new byte[26];
+                        packet[0] = 0x0B;
+                        packet[1] = 0x1F;
+                        packet[2] = 0x00;
+                        packet[3] = 0x00;
+                        packet[4] = (byte)random.Next(4);
+                        packet[5] = (byte)random.Next(256);
+                        packet[24] = 0x01;
+                        samples.Add(packet);
+                    }
+
+                    var dictionary = new LZ4Dictionary(LZ4DictionaryTrainer.Train(samples, 1024));
+                    var (raw, compressed, withDictionary) = LZ4DictionaryTrainer.Measure(samples, dictionary);
+
+                    Expect(dictionary.IsValid).ToBeTrue();
+                    Expect(withDictionary).ToBeLessThan(compressed);
+                    Expect(withDictionary).ToBeLessThan(raw);
+                });
+            });
+
+            Describe("LZ4 Stream", () =>
+            {
+                It("should match a message against the previous ones", () =>
+                {
+                    var encoder = new LZ4Stream();
+                    var decoder = new LZ4Stream();
+                    byte[] message = Encoding.ASCII.GetBytes("inventory slot 12 item 4471 count 3 durability 87");
+                    byte[] compressed = new byte[256];
+                    byte[] decompressed = new byte[256];
+
+                    int first = encoder.Compress(message, compressed);
+                    Expect(decoder.Decompress(compressed.AsSpan(0, first), decompressed)).ToBe(message.Length);
+
+                    int second = encoder.Compress(message, compressed);
+                    Expect(second).ToBeLessThan(first);
+                    Expect(second).ToBeLessThan(8);
+
+                    int decompressedSize = decoder.Decompress(compressed.AsSpan(0, second), decompressed);
+                    Expect(decompressedSize).ToBe(message.Length);
+                    Expect(Encoding.ASCII.GetString(decompressed, 0, decompressedSize)).ToBe(Encoding.ASCII.GetString(message));
+                });
+
+                It("should keep decoding across raw messages and an encoder reset", () =>
+                {
+                    var encoder = new LZ4Stream();
+                    var decoder = new LZ4Stream();
+                    var random = new Random(11);
+                    byte[] template = new byte[120];
+                    random.NextBytes(template);
+                    byte[] compressed = new byte[256];
+                    byte[] decompressed = new byte[256];
+
+                    for (int i = 0; i < 2000; i++)
+                    {
+                        byte[] message = (byte[])template.Clone();
+                        message[random.Next(message.Length)] = (byte)i;
+
+                        // Incompressible messages travel raw, the decoder only appends them
+                        if (i % 7 == 0)
+                            random.NextBytes(message);
+
+                        // The encoder may restart on its own, the decoder's history still covers it
+                        if (i == 1000)
+                            encoder.Reset();
+
+                        int compressedSize = encoder.Compress(message, compressed.AsSpan(0, message.Length - 1));
+
+                        if (compressedSize == 0)
+                        {
+                            decoder.Append(message);
+                            continue;
+                        }
+
+                        int decompressedSize = decoder.Decompress(compressed.AsSpan(0, compressedSize), decompressed);
+                        Expect(decompressedSize).ToBe(message.Length);
+                        Expect(decompressed.AsSpan(0, decompressedSize).SequenceEqual(message)).ToBeTrue();
+                    }
+
+                    Expect(decoder.HistoryLength).ToBe(LZ4Stream.HistorySize);
+                });
+            });
         }
     }
 }
@@ -17,11 +17,19 @@ UClientConfig* UClientConfig::GetDefaultConfig()
         DefaultConfigInstance->Network.ConnectionTimeoutSeconds = 10.0f;
         DefaultConfigInstance->Network.RetryIntervalSeconds = 5.0f;
         DefaultConfigInstance->Network.bEnableRetry = true;
+        DefaultConfigInstance->Network.bEnableConnectionMigration = true;
 
         DefaultConfigInstance->Security.bEnableEndToEndEncryption = true;
         DefaultConfigInstance->Security.bEnableIntegrityCheck = true;
         DefaultConfigInstance->Security.bEnableLZ4Compression = true;
         DefaultConfigInstance->Security.CompressionThreshold = 512;
+        DefaultConfigInstance->Security.CompressionAcceleration = 1;
+        DefaultConfigInstance->Security.HighCompressionThreshold = 1024;
+        DefaultConfigInstance->Security.CompressionDictionaryPath = TEXT("");
+        DefaultConfigInstance->Security.bEnableStreamCompression = true;
+        DefaultConfigInstance->Security.bOmitAEADChecksum = false;
+        DefaultConfigInstance->Security.bEnableAES256GCM = true;
+        DefaultConfigInstance->Security.bEnableSessionResumption = true;
         DefaultConfigInstance->Security.ServerPassword = TEXT("");
         DefaultConfigInstance->Security.bEnableAntiCheat = false;
 
@@ -30,6 +38,13 @@ UClientConfig* UClientConfig::GetDefaultConfig()
         DefaultConfigInstance->Performance.bEnablePerformanceMetrics = false;
         DefaultConfigInstance->Performance.ReliableTimeoutMs = 250;
         DefaultConfigInstance->Performance.MaxRetries = 10;
+        DefaultConfigInstance->Performance.LatencyMode = ENetLatencyMode::Park;
+        DefaultConfigInstance->Performance.SpinWaitMicroseconds = 50;
+        DefaultConfigInstance->Performance.bEnableBatchedIO = true;
+        DefaultConfigInstance->Performance.bEnableCoalescing = true;
+        DefaultConfigInstance->Performance.FlushIntervalMs = 0.0f;
+        DefaultConfigInstance->Performance.CongestionControl = ECongestionControl::NewReno;
+        DefaultConfigInstance->Performance.bEnablePacing = true;
 
         DefaultConfigInstance->Logging.bEnableDebugLogs = false;
         DefaultConfigInstance->Logging.bEnableFileLogging = true;
@@ -80,6 +95,18 @@ bool UClientConfig::ValidateConfiguration() const
         return false;
     }
 
+    if (Security.CompressionAcceleration < 1 || Security.CompressionAcceleration > 256)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Invalid compression acceleration: %d"), Security.CompressionAcceleration);
+        return false;
+    }
+
+    if (Security.HighCompressionThreshold < 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Invalid high compression threshold: %d"), Security.HighCompressionThreshold);
+        return false;
+    }
+
     // Validate performance settings
     if (Performance.SendRateHz <= 0 || Performance.SendRateHz > 120)
     {
@@ -93,6 +120,12 @@ bool UClientConfig::ValidateConfiguration() const
         return false;
     }
 
+    if (Performance.FlushIntervalMs < 0.0f || Performance.FlushIntervalMs > 100.0f)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Invalid flush interval: %.2f ms"), Performance.FlushIntervalMs);
+        return false;
+    }
+
     if (Performance.ReliableTimeoutMs < 50 || Performance.ReliableTimeoutMs > 5000)
     {
         UE_LOG(LogTemp, Error, TEXT("Invalid reliable timeout: %d"), Performance.ReliableTimeoutMs);
@@ -105,6 +138,12 @@ bool UClientConfig::ValidateConfiguration() const
         return false;
     }
 
+    if (Performance.SpinWaitMicroseconds < 0 || Performance.SpinWaitMicroseconds > 1000)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Invalid spin wait: %d"), Performance.SpinWaitMicroseconds);
+        return false;
+    }
+
     return true;
 }
 
@@ -132,6 +171,13 @@ void UClientConfig::ApplyToGameInstance(UTOSGameInstance* GameInstance) const
     GameInstance->bEnableIntegrityCheck = Security.bEnableIntegrityCheck;
     GameInstance->bEnableLZ4Compression = Security.bEnableLZ4Compression;
     GameInstance->CompressionThreshold = Security.CompressionThreshold;
+    GameInstance->CompressionAcceleration = Security.CompressionAcceleration;
+    GameInstance->HighCompressionThreshold = Security.HighCompressionThreshold;
+    GameInstance->CompressionDictionaryPath = Security.CompressionDictionaryPath;
+    GameInstance->bEnableStreamCompression = Security.bEnableStreamCompression;
+    GameInstance->bOmitAEADChecksum = Security.bOmitAEADChecksum;
+    GameInstance->bEnableAES256GCM = Security.bEnableAES256GCM;
+    GameInstance->bEnableSessionResumption = Security.bEnableSessionResumption;
     GameInstance->ServerPassword = Security.ServerPassword;
 
     // Apply performance settings
@@ -139,6 +185,13 @@ void UClientConfig::ApplyToGameInstance(UTOSGameInstance* GameInstance) const
     GameInstance->MaxPacketSize = Performance.MaxPacketSize;
     GameInstance->ReliableTimeoutMs = Performance.ReliableTimeoutMs;
     GameInstance->MaxRetries = Performance.MaxRetries;
+    GameInstance->NetLatencyMode = Performance.LatencyMode;
+    GameInstance->SpinWaitMicroseconds = Performance.SpinWaitMicroseconds;
+    GameInstance->bEnableBatchedIO = Performance.bEnableBatchedIO;
+    GameInstance->bEnableCoalescing = Performance.bEnableCoalescing;
+    GameInstance->FlushIntervalMs = Performance.FlushIntervalMs;
+    GameInstance->CongestionControl = Performance.CongestionControl;
+    GameInstance->bEnablePacing = Performance.bEnablePacing;
 
     // Apply logging settings
     GameInstance->bEnableDebugLogs = Logging.bEnableDebugLogs;
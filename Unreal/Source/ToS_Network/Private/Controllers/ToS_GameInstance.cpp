@@ -1,7 +1,6 @@
 #include "Controllers/ToS_GameInstance.h"
 #include "Controllers/ToS_PlayerController.h"
 #include "Engine/World.h"
-#include "Async/Async.h"
 #include "Config/ClientConfig.h"
 
 static bool bENetInitialized = false;
@@ -67,72 +66,32 @@ void UTOSGameInstance::OnStart()
 
 void UTOSGameInstance::HandleCreateEntity(int32 EntityId, FVector Positon, FRotator Rotator, int32 Flags)
 {
-    if (!PlayerController)
-        return;
-
-    AsyncTask(ENamedThreads::GameThread, [this, EntityId, Positon, Rotator, Flags]()
-    {
-        if (PlayerController)
-        {
-            PlayerController->HandleCreateEntity(EntityId, Positon, Rotator, Flags);
-        }
-    });
+    if (PlayerController)
+        PlayerController->HandleCreateEntity(EntityId, Positon, Rotator, Flags);
 }
 
 void UTOSGameInstance::HandleUpdateEntity(FUpdateEntityPacket data)
 {
-    if (!PlayerController)
-        return;
-
-    AsyncTask(ENamedThreads::GameThread, [this, data]()
-    {
-        if (PlayerController)
-        {
-            PlayerController->HandleUpdateEntity(data);
-        }
-    });
+    if (PlayerController)
+        PlayerController->HandleUpdateEntity(data);
 }
 
 void UTOSGameInstance::HandleRemoveEntity(int32 EntityId)
 {
-    if (!PlayerController)
-        return;
-
-    AsyncTask(ENamedThreads::GameThread, [this, EntityId]()
-    {
-        if (PlayerController)
-        {
-            PlayerController->HandleRemoveEntity(EntityId);
-        }
-    });
+    if (PlayerController)
+        PlayerController->HandleRemoveEntity(EntityId);
 }
 
 void UTOSGameInstance::HandleDeltaUpdate(FDeltaUpdateData data)
 {
-    if (!PlayerController)
-        return;
-
-    AsyncTask(ENamedThreads::GameThread, [this, data]()
-    {
-        if (PlayerController)
-        {
-            PlayerController->HandleDeltaUpdate(data);
-        }
-    });
+    if (PlayerController)
+        PlayerController->HandleDeltaUpdate(data);
 }
 
 void UTOSGameInstance::HandleUpdateEntityQuantized(FUpdateEntityQuantizedPacket data)
 {
-    if (!PlayerController)
-        return;
-
-    AsyncTask(ENamedThreads::GameThread, [this, data]()
-    {
-        if (PlayerController)
-        {
-            PlayerController->HandleUpdateEntityQuantized(data);
-        }
-    });
+    if (PlayerController)
+        PlayerController->HandleUpdateEntityQuantized(data);
 }
 
 void UTOSGameInstance::LoadDefaultConfiguration()
@@ -173,6 +132,13 @@ void UTOSGameInstance::ApplyClientConfiguration(UClientConfig* Config)
     bEnableIntegrityCheck = Config->Security.bEnableIntegrityCheck;
     bEnableLZ4Compression = Config->Security.bEnableLZ4Compression;
     CompressionThreshold = Config->Security.CompressionThreshold;
+    CompressionAcceleration = Config->Security.CompressionAcceleration;
+    HighCompressionThreshold = Config->Security.HighCompressionThreshold;
+    CompressionDictionaryPath = Config->Security.CompressionDictionaryPath;
+    bEnableStreamCompression = Config->Security.bEnableStreamCompression;
+    bOmitAEADChecksum = Config->Security.bOmitAEADChecksum;
+    bEnableAES256GCM = Config->Security.bEnableAES256GCM;
+    bEnableSessionResumption = Config->Security.bEnableSessionResumption;
     ServerPassword = Config->Security.ServerPassword;
 
     // Apply performance settings
@@ -180,6 +146,13 @@ void UTOSGameInstance::ApplyClientConfiguration(UClientConfig* Config)
     MaxPacketSize = Config->Performance.MaxPacketSize;
     ReliableTimeoutMs = Config->Performance.ReliableTimeoutMs;
     MaxRetries = Config->Performance.MaxRetries;
+    NetLatencyMode = Config->Performance.LatencyMode;
+    SpinWaitMicroseconds = Config->Performance.SpinWaitMicroseconds;
+    bEnableBatchedIO = Config->Performance.bEnableBatchedIO;
+    bEnableCoalescing = Config->Performance.bEnableCoalescing;
+    FlushIntervalMs = Config->Performance.FlushIntervalMs;
+    CongestionControl = Config->Performance.CongestionControl;
+    bEnablePacing = Config->Performance.bEnablePacing;
 
     // Apply logging settings
     bEnableDebugLogs = Config->Logging.bEnableDebugLogs;
@@ -193,6 +166,24 @@ void UTOSGameInstance::ApplyClientConfiguration(UClientConfig* Config)
         NetSubsystem->SetConnectTimeout(Config->Network.ConnectionTimeoutSeconds);
         NetSubsystem->SetRetryInterval(Config->Network.RetryIntervalSeconds);
         NetSubsystem->SetRetryEnabled(Config->Network.bEnableRetry);
+        NetSubsystem->SetConnectionMigrationEnabled(Config->Network.bEnableConnectionMigration);
+        NetSubsystem->SetLatencyMode(NetLatencyMode);
+        NetSubsystem->SetSpinWaitMicroseconds(SpinWaitMicroseconds);
+        NetSubsystem->SetBatchedIOEnabled(bEnableBatchedIO);
+        NetSubsystem->SetMaxPacketSize(MaxPacketSize);
+        NetSubsystem->SetCoalescingEnabled(bEnableCoalescing);
+        NetSubsystem->SetFlushIntervalMs(FlushIntervalMs);
+        NetSubsystem->SetReliableTimeoutMs(ReliableTimeoutMs);
+        NetSubsystem->SetMaxRetries(MaxRetries);
+        NetSubsystem->SetCongestionControl(CongestionControl);
+        NetSubsystem->SetPacingEnabled(bEnablePacing);
+        NetSubsystem->SetCompression(bEnableLZ4Compression, CompressionThreshold);
+        NetSubsystem->SetCompressionLevel(CompressionAcceleration, HighCompressionThreshold);
+        NetSubsystem->SetCompressionDictionary(CompressionDictionaryPath);
+        NetSubsystem->SetStreamCompressionEnabled(bEnableStreamCompression);
+        NetSubsystem->SetOmitAEADChecksum(bOmitAEADChecksum);
+        NetSubsystem->SetAES256GCMEnabled(bEnableAES256GCM);
+        NetSubsystem->SetSessionResumptionEnabled(bEnableSessionResumption);
     }
 
     UE_LOG(LogTemp, Warning, TEXT("Client configuration applied successfully"));
@@ -214,16 +214,14 @@ void ASyncPlayer::SendSyncToServer()
     if (UCharacterMovementComponent* Movement = GetCharacterMovement())
 		IsFalling = Movement->IsFalling();
 
-    struct FSyncSnapshot
-    {
-        FVector Position;
-        FRotator Rotation;
-        int32 AnimID;
-        bool IsFalling;
-    };
-
-    FSyncSnapshot Snapshot{ Position, Rotation, AnimID, IsFalling };
-    uint32 CurrentHash = FCRC32C::Compute(reinterpret_cast<const uint8*>(&Snapshot), sizeof(Snapshot));
+    // Field by field, a snapshot struct would also hash its padding bytes
+    const uint8 Falling = IsFalling ? 1 : 0;
+    uint32 HashState = FCRC32C::Initial;
+    HashState = FCRC32C::Update(HashState, reinterpret_cast<const uint8*>(&Position), sizeof(Position));
+    HashState = FCRC32C::Update(HashState, reinterpret_cast<const uint8*>(&Rotation), sizeof(Rotation));
+    HashState = FCRC32C::Update(HashState, reinterpret_cast<const uint8*>(&AnimID), sizeof(AnimID));
+    HashState = FCRC32C::Update(HashState, &Falling, sizeof(Falling));
+    uint32 CurrentHash = FCRC32C::Finalize(HashState);
 
     if (CurrentHash == LastSyncHash)
     {
@@ -0,0 +1,199 @@
+#include "Network/CongestionController.h"
+
+double ICongestionController::GetPacingRate(const FRttEstimator& Rtt) const
+{
+    // Without a round trip measurement there is nothing to spread the window over
+    if (!Rtt.HasSample() || Rtt.GetSmoothedRtt() <= 0.0)
+        return 0.0;
+
+    return static_cast<double>(GetCongestionWindow()) / Rtt.GetSmoothedRtt();
+}
+
+TUniquePtr<ICongestionController> ICongestionController::Create(ECongestionControl Algorithm, int32 MaxDatagramSize)
+{
+    TUniquePtr<ICongestionController> Controller;
+
+    switch (Algorithm)
+    {
+        case ECongestionControl::NewReno:
+            Controller = MakeUnique<FNewRenoCongestionController>();
+            break;
+        case ECongestionControl::Cubic:
+            Controller = MakeUnique<FCubicCongestionController>();
+            break;
+        default:
+            return nullptr;
+    }
+
+    Controller->Reset(MaxDatagramSize);
+    return Controller;
+}
+
+void FLossBasedCongestionController::Reset(int32 InMaxDatagramSize)
+{
+    MaxDatagramSize = FMath::Max(InMaxDatagramSize, 1);
+    Window = static_cast<double>(InitialWindowPackets) * MaxDatagramSize;
+    SlowStartThreshold = TNumericLimits<double>::Max();
+    RecoveryStart = -1.0;
+}
+
+void FLossBasedCongestionController::OnPacketAcked(double Now, int32 Bytes, double SentTime, const FRttEstimator& Rtt)
+{
+    // Still draining the loss event, the window stays where the reduction put it
+    if (SentTime <= RecoveryStart)
+        return;
+
+    if (InSlowStart())
+        Window += Bytes;
+    else
+        OnCongestionAvoidance(Now, Bytes, Rtt);
+}
+
+void FLossBasedCongestionController::OnPacketLost(double Now, int32 Bytes, double SentTime, bool bTimeout)
+{
+    if (SentTime > RecoveryStart)
+    {
+        RecoveryStart = Now;
+        OnCongestionEvent(Now);
+        Window = FMath::Max(Window, GetMinWindow());
+        SlowStartThreshold = Window;
+    }
+
+    // A timeout means the ACK clock stopped, restart from the minimum window
+    if (bTimeout)
+        Window = GetMinWindow();
+}
+
+double FLossBasedCongestionController::GetPacingRate(const FRttEstimator& Rtt) const
+{
+    return ICongestionController::GetPacingRate(Rtt) * (InSlowStart() ? SlowStartPacingGain : PacingGain);
+}
+
+void FNewRenoCongestionController::OnCongestionAvoidance(double Now, int32 Bytes, const FRttEstimator& Rtt)
+{
+    Window += static_cast<double>(MaxDatagramSize) * Bytes / Window;
+}
+
+void FNewRenoCongestionController::OnCongestionEvent(double Now)
+{
+    Window *= 0.5;
+}
+
+void FCubicCongestionController::Reset(int32 InMaxDatagramSize)
+{
+    FLossBasedCongestionController::Reset(InMaxDatagramSize);
+    WindowMax = 0.0;
+    LastWindowMax = 0.0;
+    EpochStart = -1.0;
+    EpochOrigin = 0.0;
+    K = 0.0;
+    RenoWindow = 0.0;
+}
+
+void FCubicCongestionController::OnCongestionAvoidance(double Now, int32 Bytes, const FRttEstimator& Rtt)
+{
+    const double Segment = static_cast<double>(MaxDatagramSize);
+
+    if (EpochStart < 0.0)
+    {
+        EpochStart = Now;
+        RenoWindow = Window;
+
+        if (Window < WindowMax)
+        {
+            K = FMath::Pow((WindowMax - Window) / Segment / C, 1.0 / 3.0);
+            EpochOrigin = WindowMax;
+        }
+        else
+        {
+            K = 0.0;
+            EpochOrigin = Window;
+        }
+    }
+
+    // Cubic target one round trip ahead, W(t) = C * (t - K)^3 + Wmax in segments
+    const double Srtt = Rtt.HasSample() ? Rtt.GetSmoothedRtt() : 0.0;
+    const double T = Now - EpochStart + Srtt;
+    const double Offset = T - K;
+    double Target = EpochOrigin + C * Offset * Offset * Offset * Segment;
+
+    // Reno-friendly region: grow at least as fast as AIMD with the same beta would
+    RenoWindow += 3.0 * (1.0 - Beta) / (1.0 + Beta) * Segment * Bytes / Window;
+    Target = FMath::Clamp(FMath::Max(Target, RenoWindow), Window, Window * 1.5);
+
+    if (Target > Window)
+        Window += (Target - Window) * Bytes / Window;
+    else
+        Window += Segment * Bytes / (100.0 * Window);
+}
+
+void FCubicCongestionController::OnCongestionEvent(double Now)
+{
+    // Fast convergence: yield bandwidth to newer flows when the saturation point keeps dropping
+    WindowMax = Window < LastWindowMax ? Window * (1.0 + Beta) / 2.0 : Window;
+    LastWindowMax = Window;
+    Window *= Beta;
+    EpochStart = -1.0;
+}
+
+void FByteRecordQueue::Push(const uint8* Data, int32 Length, uint8 Tag)
+{
+    // Reclaim the consumed front before growing
+    if (Count == 0)
+    {
+        Storage.Reset();
+        Head = 0;
+    }
+    else if (Head > 0 && Head >= Storage.Num() / 2)
+    {
+        Storage.RemoveAt(0, Head);
+        Head = 0;
+    }
+
+    const int32 Offset = Storage.AddUninitialized(RecordHeaderSize + Length);
+    FMemory::Memcpy(Storage.GetData() + Offset, &Length, sizeof(int32));
+    Storage[Offset + sizeof(int32)] = Tag;
+
+    if (Length > 0)
+        FMemory::Memcpy(Storage.GetData() + Offset + RecordHeaderSize, Data, Length);
+
+    Count++;
+}
+
+bool FByteRecordQueue::Peek(const uint8*& OutData, int32& OutLength, uint8* OutTag) const
+{
+    if (Count == 0)
+        return false;
+
+    FMemory::Memcpy(&OutLength, Storage.GetData() + Head, sizeof(int32));
+    OutData = Storage.GetData() + Head + RecordHeaderSize;
+
+    if (OutTag)
+        *OutTag = Storage[Head + sizeof(int32)];
+
+    return true;
+}
+
+void FByteRecordQueue::Pop()
+{
+    if (Count == 0)
+        return;
+
+    int32 Length = 0;
+    FMemory::Memcpy(&Length, Storage.GetData() + Head, sizeof(int32));
+    Head += RecordHeaderSize + Length;
+    Count--;
+
+    if (Count == 0)
+    {
+        Storage.Reset();
+        Head = 0;
+    }
+}
+
+void FByteRecordQueue::Reset()
+{
+    Storage.Reset();
+    Head = 0;
+    Count = 0;
+}
@@ -1,6 +1,6 @@
 #include "Network/ENetSubsystem.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ServerPackets.h"
 #include "Utils/CRC32C.h"
 #include "Utils/FileLogger.h"
@@ -27,153 +27,122 @@ void UENetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
     UdpClient = MakeUnique<UDPClient>();
 
-    UdpClient->OnDataReceive = [this](UFlatBuffer* Buffer)
+    // Runs on the network thread: decode only, delegates are broadcast from Tick on the game thread
+    UdpClient->OnDataReceive = [this](FFlatBufferView& Buffer)
     {
-        if (Buffer && Buffer->Position == 1)
+        // Every message in a batch carries its own [EPacketType][EServerPackets] prefix
+        while (Buffer.Remaining() >= 3 && !Buffer.HasOverflowed())
         {
-            auto bufferSign = Buffer->ReadSign();
-            auto sign = FCRC32C::Compute(Buffer->Data, Buffer->Capacity);
-
-            if (bufferSign == sign) {
-                do {
-                    if(Buffer->Position > 2)
-                        EPacketType PacketType = static_cast<EPacketType>(Buffer->ReadByte());
-
-                    EServerPackets ServerPacketType = static_cast<EServerPackets>(Buffer->ReadInt16());
-                    //FString PacketName = StaticEnum<EServerPackets>()->GetNameStringByValue(static_cast<int64>(ServerPacketType));
-                    //UE_LOG(LogTemp, Warning, TEXT("UENetSubsystem: Received %s."), *PacketName);
-
-                    switch (ServerPacketType) {
-                        case EServerPackets::CreateEntity:
-                        {
-                            FCreateEntityPacket fCreateEntity = FCreateEntityPacket();
-                            fCreateEntity.Deserialize(Buffer);
-                            OnCreateEntity.Broadcast(fCreateEntity.EntityId, fCreateEntity.Positon, fCreateEntity.Rotator, fCreateEntity.Flags);
-                        }
-                        break;
-                        case EServerPackets::UpdateEntity:
-                        {
-                            FUpdateEntityPacket fUpdateEntity = FUpdateEntityPacket();
-                            fUpdateEntity.Deserialize(Buffer);
-                            OnUpdateEntity.Broadcast(fUpdateEntity);
-                        }
-                        break;
-                        case EServerPackets::RemoveEntity:
-                        {
-                            FRemoveEntityPacket fRemoveEntity = FRemoveEntityPacket();
-                            fRemoveEntity.Deserialize(Buffer);
-                            OnRemoveEntity.Broadcast(fRemoveEntity.EntityId);
-                        }
-                        break;
-                        case EServerPackets::UpdateEntityQuantized:
-                        {
-                            FUpdateEntityQuantizedPacket fUpdateEntityQuantized = FUpdateEntityQuantizedPacket();
-                            fUpdateEntityQuantized.Deserialize(Buffer);
-                            static int32 QuantizedUpdateCount = 0;
-                            QuantizedUpdateCount++;
-                            
-                            if (QuantizedUpdateCount <= 10)
-                            {
-                                ClientFileLog(FString::Printf(TEXT("=== RECEIVED UpdateEntityQuantizedPacket #%d ==="), QuantizedUpdateCount));
-                                ClientFileLog(FString::Printf(TEXT("[CLIENT] EntityId: %d"), fUpdateEntityQuantized.EntityId));
-                                ClientFileLog(FString::Printf(TEXT("[CLIENT] Quantized Position: (%d, %d, %d)"), fUpdateEntityQuantized.QuantizedX, fUpdateEntityQuantized.QuantizedY, fUpdateEntityQuantized.QuantizedZ));
-                                ClientFileLog(FString::Printf(TEXT("[CLIENT] Quadrant: (%d, %d)"), fUpdateEntityQuantized.QuadrantX, fUpdateEntityQuantized.QuadrantY));
-                                ClientFileLog(FString::Printf(TEXT("[CLIENT] Yaw: %f"), fUpdateEntityQuantized.Yaw));
-                                ClientFileLog(FString::Printf(TEXT("[CLIENT] Velocity: %s"), *fUpdateEntityQuantized.Velocity.ToString()));
-                                ClientFileLog(FString::Printf(TEXT("[CLIENT] AnimationState: %d"), fUpdateEntityQuantized.AnimationState));
-                                ClientFileLog(FString::Printf(TEXT("[CLIENT] Flags: %d"), fUpdateEntityQuantized.Flags));
-                            }
-                            
-                            OnUpdateEntityQuantized.Broadcast(fUpdateEntityQuantized);
-                            
-                            if (QuantizedUpdateCount <= 10)
-                            {
-                                ClientFileLog(TEXT("[CLIENT] UpdateEntityQuantized broadcasted to delegates"));
-                            }
-                        }
-                        break;
-                        case EServerPackets::RekeyRequest:
-                        {
-                            FRekeyRequestPacket fRekeyRequest = FRekeyRequestPacket();
-                            fRekeyRequest.Deserialize(Buffer);
-                            OnRekeyRequest.Broadcast(fRekeyRequest.CurrentSequence, fRekeyRequest.NewSalt);
-                        }
-                        break;
-
-                        case EServerPackets::DeltaSync:
-                        {
-                            FDeltaSyncPacket delta = FDeltaSyncPacket();
-                            delta.Deserialize(Buffer);
-
-                            FDeltaUpdateData data;
-                            data.Index = delta.Index;
-                            data.EntitiesMask = static_cast<EEntityDelta>(delta.EntitiesMask);
-                            data.Velocity = Buffer->Read<FVector>();
-                            data.Flags = Buffer->Read<uint32>();
-
-                            if (EnumHasAnyFlags(data.EntitiesMask, EEntityDelta::Position))
-                                data.Positon = Buffer->Read<FVector>();
-                            if (EnumHasAnyFlags(data.EntitiesMask, EEntityDelta::Rotation))
-                                data.Rotator = Buffer->Read<FRotator>();
-                            if (EnumHasAnyFlags(data.EntitiesMask, EEntityDelta::AnimState))
-                                data.AnimationState = static_cast<int32>(Buffer->Read<uint32>());
-
-                            OnDeltaSync.Broadcast(data.Index, static_cast<uint8>(data.EntitiesMask));
-                            OnDeltaUpdate.Broadcast(data);
-                        }
-                        break;
-                    }
-                } while (Buffer->Position < Buffer->Capacity);
-            }
-            else {
-                UE_LOG(LogTemp, Warning, TEXT("UENetSubsystem: Sign %d / %d."), bufferSign, sign);
+            Buffer.ReadByte();
+            EServerPackets ServerPacketType = static_cast<EServerPackets>(Buffer.ReadUInt16());
+            //FString PacketName = StaticEnum<EServerPackets>()->GetNameStringByValue(static_cast<int64>(ServerPacketType));
+            //UE_LOG(LogTemp, Warning, TEXT("UENetSubsystem: Received %s."), *PacketName);
+
+            switch (ServerPacketType) {
+                case EServerPackets::CreateEntity:
+                {
+                    FCreateEntityPacket fCreateEntity = FCreateEntityPacket();
+                    fCreateEntity.Deserialize(Buffer);
+                    QueuePacketEvent(EServerPackets::CreateEntity, fCreateEntity);
+                }
+                break;
+                case EServerPackets::UpdateEntity:
+                {
+                    FUpdateEntityPacket fUpdateEntity = FUpdateEntityPacket();
+                    fUpdateEntity.Deserialize(Buffer);
+                    QueuePacketEvent(EServerPackets::UpdateEntity, fUpdateEntity);
+                }
+                break;
+                case EServerPackets::RemoveEntity:
+                {
+                    FRemoveEntityPacket fRemoveEntity = FRemoveEntityPacket();
+                    fRemoveEntity.Deserialize(Buffer);
+                    QueuePacketEvent(EServerPackets::RemoveEntity, fRemoveEntity);
+                }
+                break;
+                case EServerPackets::UpdateEntityQuantized:
+                {
+                    FUpdateEntityQuantizedPacket fUpdateEntityQuantized = FUpdateEntityQuantizedPacket();
+                    fUpdateEntityQuantized.Deserialize(Buffer);
+                    static int32 QuantizedUpdateCount = 0;
+                    QuantizedUpdateCount++;
+                    
+                    if (QuantizedUpdateCount <= 10)
+                    {
+                        ClientFileLog(FString::Printf(TEXT("=== RECEIVED UpdateEntityQuantizedPacket #%d ==="), QuantizedUpdateCount));
+                        ClientFileLog(FString::Printf(TEXT("[CLIENT] EntityId: %d"), fUpdateEntityQuantized.EntityId));
+                        ClientFileLog(FString::Printf(TEXT("[CLIENT] Quantized Position: (%d, %d, %d)"), fUpdateEntityQuantized.QuantizedX, fUpdateEntityQuantized.QuantizedY, fUpdateEntityQuantized.QuantizedZ));
+                        ClientFileLog(FString::Printf(TEXT("[CLIENT] Quadrant: (%d, %d)"), fUpdateEntityQuantized.QuadrantX, fUpdateEntityQuantized.QuadrantY));
+                        ClientFileLog(FString::Printf(TEXT("[CLIENT] Yaw: %f"), fUpdateEntityQuantized.Yaw));
+                        ClientFileLog(FString::Printf(TEXT("[CLIENT] Velocity: %s"), *fUpdateEntityQuantized.Velocity.ToString()));
+                        ClientFileLog(FString::Printf(TEXT("[CLIENT] AnimationState: %d"), fUpdateEntityQuantized.AnimationState));
+                        ClientFileLog(FString::Printf(TEXT("[CLIENT] Flags: %d"), fUpdateEntityQuantized.Flags));
+                    }
+                    
+                    QueuePacketEvent(EServerPackets::UpdateEntityQuantized, fUpdateEntityQuantized);
+                }
+                break;
+                case EServerPackets::RekeyRequest:
+                {
+                    const int32 Start = Buffer.GetPosition();
+                    FRekeyRequestPacket fRekeyRequest = FRekeyRequestPacket();
+                    fRekeyRequest.Deserialize(Buffer);
+                    QueueRawPacketEvent(EServerPackets::RekeyRequest, Buffer.GetData() + Start, Buffer.GetPosition() - Start);
+                }
+                break;
+
+                case EServerPackets::DeltaSync:
+                {
+                    FDeltaSyncPacket delta = FDeltaSyncPacket();
+                    delta.Deserialize(Buffer);
+
+                    FDeltaUpdateData data;
+                    data.Index = delta.Index;
+                    data.EntitiesMask = static_cast<EEntityDelta>(delta.EntitiesMask);
+                    data.Velocity = Buffer.Read<FVector>();
+                    data.Flags = Buffer.Read<uint32>();
+
+                    if (EnumHasAnyFlags(data.EntitiesMask, EEntityDelta::Position))
+                        data.Positon = Buffer.Read<FVector>();
+                    if (EnumHasAnyFlags(data.EntitiesMask, EEntityDelta::Rotation))
+                        data.Rotator = Buffer.Read<FRotator>();
+                    if (EnumHasAnyFlags(data.EntitiesMask, EEntityDelta::AnimState))
+                        data.AnimationState = static_cast<int32>(Buffer.Read<uint32>());
+
+                    QueuePacketEvent(EServerPackets::DeltaSync, data);
+                }
+                break;
+                default:
+                    // Unknown message, the rest of the batch cannot be framed
+                    return;
             }
         }
     };
 
     UdpClient->OnConnect = [this](int32 clientId)
     {
-        OnConnect.Broadcast(clientId);
-
-        if (!TickHandle.IsValid())
-        {
-            TickHandle = FTSTicker::GetCoreTicker().AddTicker(
-                FTickerDelegate::CreateUObject(this, &UENetSubsystem::Tick),
-                0.0f
-            );
-        }
+        QueueEvent(FNetEvent(ENetEventKind::Connect, 0, clientId));
     };
 
     UdpClient->OnConnectDenied = [this]()
     {
-        OnConnectDenied.Broadcast();
-
-        if (TickHandle.IsValid())
-        {
-            FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
-            TickHandle.Reset();
-        }
+        QueueEvent(FNetEvent(ENetEventKind::ConnectDenied));
     };
 
     UdpClient->OnConnectionError = [this]()
     {
-        OnConnectionError.Broadcast();
-
-        if (TickHandle.IsValid())
-        {
-            FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
-            TickHandle.Reset();
-        }
+        QueueEvent(FNetEvent(ENetEventKind::ConnectionError));
     };
 
     UdpClient->OnDisconnect = [this]()
     {
-        if (TickHandle.IsValid())
-        {
-            FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
-            TickHandle.Reset();
-        }
+        QueueEvent(FNetEvent(ENetEventKind::Disconnect));
     };
+
+    TickHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateUObject(this, &UENetSubsystem::Tick),
+        0.0f
+    );
 }
 
 void UENetSubsystem::Deinitialize()
@@ -188,6 +157,105 @@ void UENetSubsystem::Deinitialize()
         UdpClient->Disconnect();
 
     UdpClient.Reset();
+    NetEvents.Empty();
+}
+
+void UENetSubsystem::QueueEvent(const FNetEvent& Event)
+{
+    // Callbacks raised from the game thread (connect failures, local disconnects) dispatch in place,
+    // after anything the network thread queued before them
+    if (IsInGameThread())
+    {
+        NetEvents.Drain([this](const FNetEvent& Pending) { DispatchEvent(Pending); });
+        DispatchEvent(Event);
+        return;
+    }
+
+    NetEvents.Enqueue(Event);
+}
+
+void UENetSubsystem::QueuePacketEvent(EServerPackets Type)
+{
+    QueueEvent(FNetEvent(ENetEventKind::Packet, static_cast<uint8>(Type)));
+}
+
+void UENetSubsystem::QueueRawPacketEvent(EServerPackets Type, const uint8* Data, int32 Length)
+{
+    FNetEvent Event(ENetEventKind::RawPacket, static_cast<uint8>(Type));
+
+    if (!Event.StoreRaw(Data, Length))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("UENetSubsystem: %d byte message does not fit a network event, dropped"), Length);
+        return;
+    }
+
+    QueueEvent(Event);
+}
+
+void UENetSubsystem::DispatchEvent(const FNetEvent& Event)
+{
+    switch (Event.Kind)
+    {
+        case ENetEventKind::Connect:
+            OnConnect.Broadcast(Event.Value);
+            return;
+        case ENetEventKind::ConnectDenied:
+            OnConnectDenied.Broadcast();
+            return;
+        case ENetEventKind::ConnectionError:
+            OnConnectionError.Broadcast();
+            return;
+        case ENetEventKind::Disconnect:
+            OnDisconnected.Broadcast();
+            return;
+        default:
+            break;
+    }
+
+    switch (static_cast<EServerPackets>(Event.PacketId)) {
+        case EServerPackets::CreateEntity:
+        {
+            const FCreateEntityPacket& fCreateEntity = Event.Get<FCreateEntityPacket>();
+            OnCreateEntity.Broadcast(fCreateEntity.EntityId, fCreateEntity.Positon, fCreateEntity.Rotator, fCreateEntity.Flags);
+        }
+        break;
+        case EServerPackets::UpdateEntity:
+        {
+            const FUpdateEntityPacket& fUpdateEntity = Event.Get<FUpdateEntityPacket>();
+            OnUpdateEntity.Broadcast(fUpdateEntity);
+        }
+        break;
+        case EServerPackets::RemoveEntity:
+        {
+            const FRemoveEntityPacket& fRemoveEntity = Event.Get<FRemoveEntityPacket>();
+            OnRemoveEntity.Broadcast(fRemoveEntity.EntityId);
+        }
+        break;
+        case EServerPackets::UpdateEntityQuantized:
+        {
+            const FUpdateEntityQuantizedPacket& fUpdateEntityQuantized = Event.Get<FUpdateEntityQuantizedPacket>();
+            OnUpdateEntityQuantized.Broadcast(fUpdateEntityQuantized);
+        }
+        break;
+        case EServerPackets::RekeyRequest:
+        {
+            FRekeyRequestPacket fRekeyRequest = FRekeyRequestPacket();
+            FFlatBufferView View = Event.GetRawView();
+            fRekeyRequest.Deserialize(View);
+            OnRekeyRequest.Broadcast(fRekeyRequest.CurrentSequence, fRekeyRequest.NewSalt);
+        }
+        break;
+
+        case EServerPackets::DeltaSync:
+        {
+            const FDeltaUpdateData& data = Event.Get<FDeltaUpdateData>();
+            OnDeltaSync.Broadcast(data.Index, static_cast<uint8>(data.EntitiesMask));
+            OnDeltaUpdate.Broadcast(data);
+        }
+        break;
+        default:
+        break;
+    }
 }
 
 bool UENetSubsystem::Connect(const FString& Host, int32 Port)
@@ -206,6 +274,13 @@ void UENetSubsystem::Disconnect()
 
 bool UENetSubsystem::Tick(float DeltaTime)
 {
+    // One drain per frame replaces a task-graph hop per packet
+    NetEvents.Drain([this](const FNetEvent& Event) { DispatchEvent(Event); });
+
+    // Messages sent this frame, including replies from the handlers above, leave as coalesced datagrams
+    if (UdpClient)
+        UdpClient->FlushOutgoing();
+
     return true;
 }
 
@@ -227,6 +302,12 @@ void UENetSubsystem::SetRetryEnabled(bool bEnabled)
         UdpClient->SetRetryEnabled(bEnabled);
 }
 
+void UENetSubsystem::SetConnectionMigrationEnabled(bool bEnabled)
+{
+    if (UdpClient)
+        UdpClient->SetConnectionMigrationEnabled(bEnabled);
+}
+
 float UENetSubsystem::GetConnectTimeout() const
 {
     return UdpClient ? UdpClient->GetConnectTimeout() : 3.0f;
@@ -242,6 +323,133 @@ bool UENetSubsystem::IsRetryEnabled() const
     return UdpClient ? UdpClient->IsRetryEnabled() : false;
 }
 
+void UENetSubsystem::SetLatencyMode(ENetLatencyMode Mode)
+{
+    if (UdpClient)
+        UdpClient->SetLatencyMode(Mode);
+}
+
+ENetLatencyMode UENetSubsystem::GetLatencyMode() const
+{
+    return UdpClient ? UdpClient->GetLatencyMode() : ENetLatencyMode::Park;
+}
+
+void UENetSubsystem::SetSpinWaitMicroseconds(int32 Microseconds)
+{
+    if (UdpClient)
+        UdpClient->SetSpinWaitMicroseconds(Microseconds);
+}
+
+void UENetSubsystem::SetBatchedIOEnabled(bool bEnabled)
+{
+    if (UdpClient)
+        UdpClient->SetBatchedIOEnabled(bEnabled);
+}
+
+void UENetSubsystem::SetMaxPacketSize(int32 Bytes)
+{
+    if (UdpClient)
+        UdpClient->SetMaxPacketSize(Bytes);
+}
+
+void UENetSubsystem::SetCoalescingEnabled(bool bEnabled)
+{
+    if (UdpClient)
+        UdpClient->SetCoalescingEnabled(bEnabled);
+}
+
+void UENetSubsystem::SetFlushIntervalMs(float Milliseconds)
+{
+    if (UdpClient)
+        UdpClient->SetFlushInterval(Milliseconds / 1000.0f);
+}
+
+void UENetSubsystem::FlushOutgoing()
+{
+    if (UdpClient)
+        UdpClient->FlushOutgoing(true);
+}
+
+void UENetSubsystem::SetReliableTimeoutMs(int32 Milliseconds)
+{
+    if (UdpClient)
+        UdpClient->SetReliableTimeout(Milliseconds / 1000.0f);
+}
+
+void UENetSubsystem::SetMaxRetries(int32 Retries)
+{
+    if (UdpClient)
+        UdpClient->SetMaxRetries(Retries);
+}
+
+float UENetSubsystem::GetRoundTripTimeMs() const
+{
+    return UdpClient ? UdpClient->GetSmoothedRtt() * 1000.0f : 0.0f;
+}
+
+void UENetSubsystem::SetCongestionControl(ECongestionControl Algorithm)
+{
+    if (UdpClient)
+        UdpClient->SetCongestionControl(Algorithm);
+}
+
+void UENetSubsystem::SetPacingEnabled(bool bEnabled)
+{
+    if (UdpClient)
+        UdpClient->SetPacingEnabled(bEnabled);
+}
+
+FNetCongestionStats UENetSubsystem::GetCongestionStats() const
+{
+    return UdpClient ? UdpClient->GetCongestionStats() : FNetCongestionStats();
+}
+
+void UENetSubsystem::SetCompression(bool bEnabled, int32 ThresholdBytes)
+{
+    if (UdpClient)
+        UdpClient->SetCompression(bEnabled, ThresholdBytes);
+}
+
+void UENetSubsystem::SetCompressionLevel(int32 Acceleration, int32 HighCompressionThresholdBytes)
+{
+    if (UdpClient)
+        UdpClient->SetCompressionLevel(Acceleration, HighCompressionThresholdBytes);
+}
+
+float UENetSubsystem::GetCompressionRatio() const
+{
+    return UdpClient ? UdpClient->GetCompressionRatio() : 0.0f;
+}
+
+bool UENetSubsystem::SetCompressionDictionary(const FString& Path)
+{
+    return UdpClient ? UdpClient->SetCompressionDictionary(Path) : false;
+}
+
+void UENetSubsystem::SetStreamCompressionEnabled(bool bEnabled)
+{
+    if (UdpClient)
+        UdpClient->SetStreamCompressionEnabled(bEnabled);
+}
+
+void UENetSubsystem::SetOmitAEADChecksum(bool bEnabled)
+{
+    if (UdpClient)
+        UdpClient->SetOmitAEADChecksum(bEnabled);
+}
+
+void UENetSubsystem::SetAES256GCMEnabled(bool bEnabled)
+{
+    if (UdpClient)
+        UdpClient->SetAES256GCMEnabled(bEnabled);
+}
+
+void UENetSubsystem::SetSessionResumptionEnabled(bool bEnabled)
+{
+    if (UdpClient)
+        UdpClient->SetSessionResumptionEnabled(bEnabled);
+}
+
 void UENetSubsystem::SendEntitySync(FVector Position, FRotator Rotation, int32 AnimID, FVector Velocity, bool IsFalling) const
 {
     static int32 SyncCount = 0;
@@ -256,7 +464,7 @@ void UENetSubsystem::SendEntitySync(FVector Position, FRotator Rotation, int32 A
         ClientFileLog(FString::Printf(TEXT("[CLIENT] AnimID: %d, IsFalling: %s"), AnimID, IsFalling ? TEXT("true") : TEXT("false")));
     }
 
-    UFlatBuffer* syncBuffer = UFlatBuffer::CreateFlatBuffer(42); // Full SyncEntity packet size
+    TFlatBuffer<42> syncBuffer; // Full SyncEntity packet size
     FSyncEntityPacket syncPacket = FSyncEntityPacket();
     syncPacket.Positon = Position;
     syncPacket.Rotator = Rotation;
@@ -271,19 +479,19 @@ void UENetSubsystem::SendEntitySync(FVector Position, FRotator Rotation, int32 A
 
     if (SyncCount <= 5)
     {
-        ClientFileLog(FString::Printf(TEXT("[CLIENT] Before serialization - Buffer capacity: %d"), syncBuffer->GetCapacity()));
+        ClientFileLog(FString::Printf(TEXT("[CLIENT] Before serialization - Buffer capacity: %d"), syncBuffer.GetCapacity()));
     }
 
     syncPacket.Serialize(syncBuffer);
 
-    if (SyncCount <= 5 && syncBuffer)
+    if (SyncCount <= 5)
     {
-        ClientFileLog(FString::Printf(TEXT("[CLIENT] Buffer created with length: %d"), syncBuffer->GetLength()));
-        if (syncBuffer->GetLength() > 0)
+        ClientFileLog(FString::Printf(TEXT("[CLIENT] Buffer created with length: %d"), syncBuffer.GetLength()));
+        if (syncBuffer.GetLength() > 0)
         {
             TArray<uint8> BufferData;
-            BufferData.SetNumUninitialized(FMath::Min(syncBuffer->GetLength(), 10));
-            FMemory::Memcpy(BufferData.GetData(), syncBuffer->GetRawBuffer(), BufferData.Num());
+            BufferData.SetNumUninitialized(FMath::Min(syncBuffer.GetLength(), 10));
+            FMemory::Memcpy(BufferData.GetData(), syncBuffer.GetData(), BufferData.Num());
 
             FString HexData;
             for (int32 i = 0; i < BufferData.Num(); i++)
@@ -356,7 +564,7 @@ void UENetSubsystem::SendEntitySyncQuantized(FVector Position, FRotator Rotation
         ClientFileLog(FString::Printf(TEXT("[CLIENT SEND] 📦 Yaw Only: %f"), Yaw));
     }
 
-    UFlatBuffer* syncBuffer = UFlatBuffer::CreateFlatBuffer(26); // Quantized SyncEntity packet size
+    TFlatBuffer<26> syncBuffer; // Quantized SyncEntity packet size
     FSyncEntityQuantizedPacket syncPacket = FSyncEntityQuantizedPacket();
     syncPacket.QuantizedX = QuantizedX;
     syncPacket.QuantizedY = QuantizedY;
@@ -385,16 +593,16 @@ void UENetSubsystem::SendEntitySyncQuantized(FVector Position, FRotator Rotation
 
     syncPacket.Serialize(syncBuffer);
 
-    if (SyncCount <= 10 && syncBuffer)
+    if (SyncCount <= 10)
     {
-        ClientFileLog(FString::Printf(TEXT("[CLIENT] ✅ Serialization complete - buffer length: %d"), syncBuffer->GetLength()));
+        ClientFileLog(FString::Printf(TEXT("[CLIENT] ✅ Serialization complete - buffer length: %d"), syncBuffer.GetLength()));
 
-        if (syncBuffer->GetLength() > 0)
+        if (syncBuffer.GetLength() > 0)
         {
             // Log all bytes in the buffer for detailed analysis
             TArray<uint8> BufferData;
-            BufferData.SetNumUninitialized(FMath::Min(syncBuffer->GetLength(), 26)); // Full packet
-            FMemory::Memcpy(BufferData.GetData(), syncBuffer->GetRawBuffer(), BufferData.Num());
+            BufferData.SetNumUninitialized(FMath::Min(syncBuffer.GetLength(), 26)); // Full packet
+            FMemory::Memcpy(BufferData.GetData(), syncBuffer.GetData(), BufferData.Num());
 
             ClientFileLog(TEXT("=== SERIALIZED BUFFER ANALYSIS ==="));
             for (int32 i = 0; i < BufferData.Num(); i++)
@@ -0,0 +1,186 @@
+#include "Network/FragmentReassembler.h"
+
+void FFragmentReassembler::Initialize()
+{
+    MessagePool.Initialize(MessageSlotCount, MaxMessageSize);
+    Reset();
+}
+
+void FFragmentReassembler::Reset()
+{
+    for (FPendingMessage& Message : Pending)
+        Message = FPendingMessage();
+
+    if (MessagePool.IsInitialized())
+        MessagePool.Reset();
+}
+
+FFragmentReassembler::FPendingMessage* FFragmentReassembler::Find(uint16 FragmentId)
+{
+    for (FPendingMessage& Message : Pending)
+    {
+        if (Message.Slot != INDEX_NONE && Message.FragmentId == FragmentId)
+            return &Message;
+    }
+
+    return nullptr;
+}
+
+FFragmentReassembler::FPendingMessage* FFragmentReassembler::Begin(uint16 FragmentId, uint32 TotalSize, double Now)
+{
+    FPendingMessage* Free = nullptr;
+    FPendingMessage* Oldest = nullptr;
+
+    for (FPendingMessage& Message : Pending)
+    {
+        if (Message.Slot == INDEX_NONE)
+        {
+            if (!Free)
+                Free = &Message;
+        }
+        else if (!Oldest || Message.LastUpdate < Oldest->LastUpdate)
+        {
+            Oldest = &Message;
+        }
+    }
+
+    int32 Slot = Free ? MessagePool.Acquire() : INDEX_NONE;
+
+    // Every entry busy or the pool pinned by queued messages: evict the stalest partial message
+    if (Slot == INDEX_NONE && Oldest)
+    {
+        Dropped++;
+        Discard(*Oldest);
+
+        if (!Free)
+            Free = Oldest;
+
+        Slot = MessagePool.Acquire();
+    }
+
+    if (Slot == INDEX_NONE)
+        return nullptr;
+
+    *Free = FPendingMessage();
+    Free->Slot = Slot;
+    Free->FragmentId = FragmentId;
+    Free->TotalSize = TotalSize;
+    Free->LastUpdate = Now;
+
+    return Free;
+}
+
+void FFragmentReassembler::Discard(FPendingMessage& Message)
+{
+    if (Message.Slot != INDEX_NONE)
+        MessagePool.Release(Message.Slot);
+
+    Message = FPendingMessage();
+}
+
+void FFragmentReassembler::Expire(double Now)
+{
+    for (FPendingMessage& Message : Pending)
+    {
+        if (Message.Slot != INDEX_NONE && Now - Message.LastUpdate > FragmentTimeout)
+        {
+            Expired++;
+            Discard(Message);
+        }
+    }
+}
+
+bool FFragmentReassembler::Add(uint16 FragmentId, uint32 Offset, uint32 TotalSize, const uint8* Chunk, int32 Length, double Now, FPooledPacket& OutMessage)
+{
+    Expire(Now);
+
+    if (!MessagePool.IsInitialized() || Length <= 0 || TotalSize == 0 ||
+        TotalSize > static_cast<uint32>(MessagePool.GetSlotSize()) || Offset + Length > TotalSize)
+    {
+        Dropped++;
+        return false;
+    }
+
+    FPendingMessage* Message = Find(FragmentId);
+
+    if (Message && Message->TotalSize != TotalSize)
+    {
+        // Id wrapped onto a stale partial message
+        Discard(*Message);
+        Message = nullptr;
+    }
+
+    if (!Message)
+        Message = Begin(FragmentId, TotalSize, Now);
+
+    if (!Message)
+    {
+        Dropped++;
+        return false;
+    }
+
+    // All fragments but the last carry exactly ChunkSize bytes, the last one completes TotalSize
+    const bool bFinal = Offset + Length == TotalSize;
+
+    if (bFinal)
+    {
+        if (Message->FinalOffset != INDEX_NONE)
+            return false;
+
+        Message->FinalOffset = static_cast<int32>(Offset);
+    }
+    else
+    {
+        if (Message->ChunkSize == 0)
+            Message->ChunkSize = Length;
+
+        const int32 Index = static_cast<int32>(Offset) / Message->ChunkSize;
+
+        if (Length != Message->ChunkSize || Offset % Message->ChunkSize != 0 || Index >= MaxFragments)
+        {
+            Dropped++;
+            Discard(*Message);
+            return false;
+        }
+
+        const uint64 Bit = 1ull << (Index & 63);
+
+        if (Message->Received[Index >> 6] & Bit)
+            return false;
+
+        Message->Received[Index >> 6] |= Bit;
+        Message->ChunksReceived++;
+    }
+
+    FMemory::Memcpy(MessagePool.GetData(Message->Slot) + Offset, Chunk, Length);
+    Message->LastUpdate = Now;
+
+    if (Message->FinalOffset == INDEX_NONE)
+        return false;
+
+    if (Message->FinalOffset > 0)
+    {
+        if (Message->ChunkSize == 0)
+            return false;
+
+        if (Message->FinalOffset % Message->ChunkSize != 0)
+        {
+            Dropped++;
+            Discard(*Message);
+            return false;
+        }
+
+        if (Message->ChunksReceived < Message->FinalOffset / Message->ChunkSize)
+            return false;
+    }
+
+    OutMessage.Slot = Message->Slot;
+    OutMessage.Length = static_cast<int32>(Message->TotalSize);
+    OutMessage.bReassembled = true;
+
+    // Ownership of the slot moves to the caller
+    *Message = FPendingMessage();
+    Completed++;
+
+    return true;
+}
@@ -0,0 +1,431 @@
+#include "Network/LinuxUdpBatchSocket.h"
+#include "IPAddress.h"
+
+#if PLATFORM_LINUX
+THIRD_PARTY_INCLUDES_START
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+THIRD_PARTY_INCLUDES_END
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+namespace
+{
+    // Kernel limits for a single GSO send (UDP_MAX_SEGMENTS, IP max payload)
+    constexpr int32 MaxGSOSegments = 64;
+    constexpr int32 MaxGSOBytes = 65507;
+
+    // GRO hands back up to 64 KB of coalesced segments per message
+    constexpr int32 GROBufferSize = 65536;
+    constexpr int32 GROBatch = FLinuxUdpBatchSocket::MaxReceivePackets / MaxGSOSegments;
+
+    constexpr int32 SendStagingSize = FLinuxUdpBatchSocket::MaxBatch * FPacketBufferPool::DefaultSlotSize;
+}
+
+struct FLinuxUdpBatchSocket::FBatchState
+{
+    mmsghdr RecvHeaders[MaxBatch];
+    iovec RecvIov[MaxBatch];
+    int32 RecvSlots[MaxBatch];
+    alignas(cmsghdr) uint8 RecvControl[MaxBatch][CMSG_SPACE(sizeof(int))];
+
+    TArray<uint8> GROStaging;
+
+    mmsghdr SendHeaders[MaxBatch];
+    iovec SendIov[MaxBatch];
+    alignas(cmsghdr) uint8 SendControl[MaxBatch][CMSG_SPACE(sizeof(uint16))];
+};
+
+FLinuxUdpBatchSocket::FLinuxUdpBatchSocket() = default;
+
+FLinuxUdpBatchSocket::~FLinuxUdpBatchSocket()
+{
+    Close();
+}
+
+bool FLinuxUdpBatchSocket::Open(const FInternetAddr& Remote, int32 ReceiveBufferSize)
+{
+    Close();
+
+    const TArray<uint8> RawIp = Remote.GetRawIp();
+    sockaddr_storage Address = {};
+    socklen_t AddressLength = 0;
+
+    if (RawIp.Num() == 4)
+    {
+        sockaddr_in* In4 = reinterpret_cast<sockaddr_in*>(&Address);
+        In4->sin_family = AF_INET;
+        In4->sin_port = htons(static_cast<uint16>(Remote.GetPort()));
+        FMemory::Memcpy(&In4->sin_addr, RawIp.GetData(), 4);
+        AddressLength = sizeof(sockaddr_in);
+    }
+    else if (RawIp.Num() == 16)
+    {
+        sockaddr_in6* In6 = reinterpret_cast<sockaddr_in6*>(&Address);
+        In6->sin6_family = AF_INET6;
+        In6->sin6_port = htons(static_cast<uint16>(Remote.GetPort()));
+        FMemory::Memcpy(&In6->sin6_addr, RawIp.GetData(), 16);
+        AddressLength = sizeof(sockaddr_in6);
+    }
+    else
+    {
+        return false;
+    }
+
+    const int32 NewFd = socket(Address.ss_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_UDP);
+
+    if (NewFd < 0)
+        return false;
+
+    if (ReceiveBufferSize > 0)
+        setsockopt(NewFd, SOL_SOCKET, SO_RCVBUF, &ReceiveBufferSize, sizeof(ReceiveBufferSize));
+
+    if (connect(NewFd, reinterpret_cast<sockaddr*>(&Address), AddressLength) != 0)
+    {
+        close(NewFd);
+        return false;
+    }
+
+    int Enable = 1;
+    bGRO = setsockopt(NewFd, SOL_UDP, UDP_GRO, &Enable, sizeof(Enable)) == 0;
+
+    int SegmentSize = 0;
+    socklen_t OptionLength = sizeof(SegmentSize);
+    bGSO = getsockopt(NewFd, SOL_UDP, UDP_SEGMENT, &SegmentSize, &OptionLength) == 0;
+
+    State = MakeUnique<FBatchState>();
+
+    if (bGRO)
+        State->GROStaging.SetNumUninitialized(GROBatch * GROBufferSize);
+
+    SendStaging.SetNumUninitialized(SendStagingSize);
+    SendCount = 0;
+    SendBytes = 0;
+    Fd = NewFd;
+
+    return true;
+}
+
+void FLinuxUdpBatchSocket::Close()
+{
+    if (Fd >= 0)
+    {
+        close(Fd);
+        Fd = -1;
+    }
+
+    SendCount = 0;
+    SendBytes = 0;
+    bGSO = false;
+    bGRO = false;
+}
+
+int32 FLinuxUdpBatchSocket::ReceiveBatch(FPacketBufferPool& Pool, FPooledPacket* OutPackets, int32 MaxPackets, uint64& OutDropped)
+{
+    if (Fd < 0 || MaxPackets <= 0)
+        return 0;
+
+    return bGRO ? ReceiveCoalesced(Pool, OutPackets, MaxPackets, OutDropped)
+                : ReceiveDirect(Pool, OutPackets, MaxPackets, OutDropped);
+}
+
+int32 FLinuxUdpBatchSocket::ReceiveDirect(FPacketBufferPool& Pool, FPooledPacket* OutPackets, int32 MaxPackets, uint64& OutDropped)
+{
+    FBatchState& S = *State;
+    const int32 SlotSize = Pool.GetSlotSize();
+    const int32 Wanted = FMath::Min(FMath::Min(MaxPackets, static_cast<int32>(MaxBatch)), Pool.GetFreeCount());
+
+    if (Wanted <= 0)
+    {
+        // Pool is full: pull one datagram into scratch so the socket keeps draining
+        uint8 Scratch[FPacketBufferPool::DefaultSlotSize];
+
+        if (recv(Fd, Scratch, sizeof(Scratch), MSG_DONTWAIT) >= 0)
+            OutDropped++;
+
+        return 0;
+    }
+
+    for (int32 i = 0; i < Wanted; i++)
+    {
+        S.RecvSlots[i] = Pool.Acquire();
+        S.RecvIov[i].iov_base = Pool.GetData(S.RecvSlots[i]);
+        S.RecvIov[i].iov_len = SlotSize;
+
+        msghdr& Header = S.RecvHeaders[i].msg_hdr;
+        FMemory::Memzero(Header);
+        Header.msg_iov = &S.RecvIov[i];
+        Header.msg_iovlen = 1;
+    }
+
+    const int32 Received = recvmmsg(Fd, S.RecvHeaders, Wanted, MSG_DONTWAIT, nullptr);
+    int32 Count = 0;
+
+    for (int32 i = 0; i < Wanted; i++)
+    {
+        if (i < Received && (S.RecvHeaders[i].msg_hdr.msg_flags & MSG_TRUNC) == 0)
+        {
+            OutPackets[Count].Slot = S.RecvSlots[i];
+            OutPackets[Count].Length = static_cast<int32>(S.RecvHeaders[i].msg_len);
+            Count++;
+        }
+        else
+        {
+            if (i < Received)
+                OutDropped++;
+
+            Pool.Release(S.RecvSlots[i]);
+        }
+    }
+
+    return Count;
+}
+
+int32 FLinuxUdpBatchSocket::ReceiveCoalesced(FPacketBufferPool& Pool, FPooledPacket* OutPackets, int32 MaxPackets, uint64& OutDropped)
+{
+    FBatchState& S = *State;
+    const int32 SlotSize = Pool.GetSlotSize();
+
+    // Each GRO buffer can expand into up to MaxGSOSegments datagrams, never receive more than fits
+    const int32 Wanted = FMath::Clamp(MaxPackets / MaxGSOSegments, 1, GROBatch);
+
+    for (int32 i = 0; i < Wanted; i++)
+    {
+        S.RecvIov[i].iov_base = S.GROStaging.GetData() + static_cast<SIZE_T>(i) * GROBufferSize;
+        S.RecvIov[i].iov_len = GROBufferSize;
+
+        msghdr& Header = S.RecvHeaders[i].msg_hdr;
+        FMemory::Memzero(Header);
+        Header.msg_iov = &S.RecvIov[i];
+        Header.msg_iovlen = 1;
+        Header.msg_control = S.RecvControl[i];
+        Header.msg_controllen = sizeof(S.RecvControl[i]);
+    }
+
+    const int32 Received = recvmmsg(Fd, S.RecvHeaders, Wanted, MSG_DONTWAIT, nullptr);
+    int32 Count = 0;
+
+    for (int32 i = 0; i < Received; i++)
+    {
+        msghdr& Header = S.RecvHeaders[i].msg_hdr;
+        const uint8* Data = static_cast<const uint8*>(S.RecvIov[i].iov_base);
+        const int32 Length = static_cast<int32>(S.RecvHeaders[i].msg_len);
+        int32 SegmentSize = Length;
+
+        for (cmsghdr* Control = CMSG_FIRSTHDR(&Header); Control; Control = CMSG_NXTHDR(&Header, Control))
+        {
+            if (Control->cmsg_level == SOL_UDP && Control->cmsg_type == UDP_GRO)
+            {
+                int GROSize = 0;
+                FMemory::Memcpy(&GROSize, CMSG_DATA(Control), sizeof(GROSize));
+
+                if (GROSize > 0)
+                    SegmentSize = GROSize;
+            }
+        }
+
+        if (Header.msg_flags & MSG_TRUNC)
+        {
+            OutDropped++;
+            continue;
+        }
+
+        for (int32 Offset = 0; Offset < Length; Offset += SegmentSize)
+        {
+            const int32 SegmentLength = FMath::Min(SegmentSize, Length - Offset);
+            const int32 Slot = (Count < MaxPackets && SegmentLength <= SlotSize) ? Pool.Acquire() : INDEX_NONE;
+
+            if (Slot == INDEX_NONE)
+            {
+                OutDropped++;
+                continue;
+            }
+
+            FMemory::Memcpy(Pool.GetData(Slot), Data + Offset, SegmentLength);
+            OutPackets[Count].Slot = Slot;
+            OutPackets[Count].Length = SegmentLength;
+            Count++;
+        }
+    }
+
+    return Count;
+}
+
+int32 FLinuxUdpBatchSocket::Send(const uint8* Data, int32 Length)
+{
+    if (Fd < 0)
+        return -1;
+
+    const ssize_t Sent = send(Fd, Data, Length, MSG_DONTWAIT | MSG_NOSIGNAL);
+    return Sent < 0 ? -1 : static_cast<int32>(Sent);
+}
+
+void FLinuxUdpBatchSocket::QueueSend(const uint8* Data, int32 Length)
+{
+    if (Fd < 0 || Length <= 0)
+        return;
+
+    if (Length > SendStagingSize)
+    {
+        Send(Data, Length);
+        return;
+    }
+
+    if (SendCount == MaxBatch || SendBytes + Length > SendStagingSize)
+        Flush();
+
+    FMemory::Memcpy(SendStaging.GetData() + SendBytes, Data, Length);
+    SendLengths[SendCount++] = Length;
+    SendBytes += Length;
+}
+
+int32 FLinuxUdpBatchSocket::Flush()
+{
+    if (Fd < 0 || SendCount == 0)
+        return 0;
+
+    int32 Sent = SendQueued(bGSO);
+
+    if (Sent < 0 && bGSO && errno == EIO)
+    {
+        // NIC or route rejected segmentation offload, stay on plain sendmmsg from now on
+        bGSO = false;
+        Sent = SendQueued(false);
+    }
+
+    SendCount = 0;
+    SendBytes = 0;
+
+    return Sent;
+}
+
+int32 FLinuxUdpBatchSocket::SendQueued(bool bAllowGSO)
+{
+    FBatchState& S = *State;
+    uint8* Cursor = SendStaging.GetData();
+    int32 MessageCount = 0;
+    int32 Index = 0;
+
+    while (Index < SendCount)
+    {
+        const int32 SegmentSize = SendLengths[Index];
+        int32 Segments = 1;
+        int32 Bytes = SegmentSize;
+
+        // A GSO run is N equal-sized datagrams, only the last may be shorter
+        if (bAllowGSO)
+        {
+            while (Index + Segments < SendCount && Segments < MaxGSOSegments)
+            {
+                const int32 Next = SendLengths[Index + Segments];
+
+                if (Next > SegmentSize || Bytes + Next > MaxGSOBytes)
+                    break;
+
+                Bytes += Next;
+                Segments++;
+
+                if (Next < SegmentSize)
+                    break;
+            }
+        }
+
+        S.SendIov[MessageCount].iov_base = Cursor;
+        S.SendIov[MessageCount].iov_len = Bytes;
+
+        msghdr& Header = S.SendHeaders[MessageCount].msg_hdr;
+        FMemory::Memzero(Header);
+        Header.msg_iov = &S.SendIov[MessageCount];
+        Header.msg_iovlen = 1;
+
+        if (Segments > 1)
+        {
+            Header.msg_control = S.SendControl[MessageCount];
+            Header.msg_controllen = sizeof(S.SendControl[MessageCount]);
+
+            cmsghdr* Control = CMSG_FIRSTHDR(&Header);
+            Control->cmsg_level = SOL_UDP;
+            Control->cmsg_type = UDP_SEGMENT;
+            Control->cmsg_len = CMSG_LEN(sizeof(uint16));
+
+            const uint16 GSOSize = static_cast<uint16>(SegmentSize);
+            FMemory::Memcpy(CMSG_DATA(Control), &GSOSize, sizeof(GSOSize));
+        }
+
+        Cursor += Bytes;
+        Index += Segments;
+        MessageCount++;
+    }
+
+    int32 Offset = 0;
+    int32 Sent = 0;
+
+    while (Offset < MessageCount)
+    {
+        const int32 Result = sendmmsg(Fd, S.SendHeaders + Offset, MessageCount - Offset, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+        if (Result <= 0)
+            return Offset == 0 ? -1 : Sent;
+
+        for (int32 i = Offset; i < Offset + Result; i++)
+            Sent += static_cast<int32>(S.SendHeaders[i].msg_len);
+
+        Offset += Result;
+    }
+
+    return Sent;
+}
+
+bool FLinuxUdpBatchSocket::HasPendingData() const
+{
+    return Wait(0.0);
+}
+
+bool FLinuxUdpBatchSocket::Wait(double TimeoutSeconds) const
+{
+    if (Fd < 0)
+        return false;
+
+    pollfd Descriptor = {};
+    Descriptor.fd = Fd;
+    Descriptor.events = POLLIN;
+
+    const int TimeoutMs = TimeoutSeconds <= 0.0 ? 0 : FMath::Max(1, FMath::CeilToInt(TimeoutSeconds * 1000.0));
+    return poll(&Descriptor, 1, TimeoutMs) > 0 && (Descriptor.revents & (POLLIN | POLLERR)) != 0;
+}
+
+#else
+
+struct FLinuxUdpBatchSocket::FBatchState
+{
+};
+
+FLinuxUdpBatchSocket::FLinuxUdpBatchSocket() = default;
+FLinuxUdpBatchSocket::~FLinuxUdpBatchSocket() = default;
+
+bool FLinuxUdpBatchSocket::Open(const FInternetAddr& Remote, int32 ReceiveBufferSize) { return false; }
+void FLinuxUdpBatchSocket::Close() {}
+int32 FLinuxUdpBatchSocket::ReceiveBatch(FPacketBufferPool& Pool, FPooledPacket* OutPackets, int32 MaxPackets, uint64& OutDropped) { return 0; }
+int32 FLinuxUdpBatchSocket::ReceiveDirect(FPacketBufferPool& Pool, FPooledPacket* OutPackets, int32 MaxPackets, uint64& OutDropped) { return 0; }
+int32 FLinuxUdpBatchSocket::ReceiveCoalesced(FPacketBufferPool& Pool, FPooledPacket* OutPackets, int32 MaxPackets, uint64& OutDropped) { return 0; }
+int32 FLinuxUdpBatchSocket::Send(const uint8* Data, int32 Length) { return -1; }
+void FLinuxUdpBatchSocket::QueueSend(const uint8* Data, int32 Length) {}
+int32 FLinuxUdpBatchSocket::Flush() { return 0; }
+int32 FLinuxUdpBatchSocket::SendQueued(bool bAllowGSO) { return 0; }
+bool FLinuxUdpBatchSocket::HasPendingData() const { return false; }
+bool FLinuxUdpBatchSocket::Wait(double TimeoutSeconds) const { return false; }
+
+#endif
@@ -0,0 +1,26 @@
+#include "Network/NetEventQueue.h"
+
+void FNetEventQueue::Enqueue(const FNetEvent& Event)
+{
+    Enqueued.fetch_add(1, std::memory_order_relaxed);
+
+    // Once spilled, keep spilling until the game thread catches up so ordering is preserved
+    if (SpilledCount.load(std::memory_order_acquire) == 0 && Ring.Enqueue(Event))
+        return;
+
+    if (Overflowed.fetch_add(1, std::memory_order_relaxed) == 0)
+        UE_LOG(LogTemp, Warning, TEXT("FNetEventQueue: ring full, spilling network events until the game thread catches up"));
+
+    SpilledCount.fetch_add(1, std::memory_order_release);
+    Overflow.Enqueue(Event);
+}
+
+void FNetEventQueue::Empty()
+{
+    Ring.Empty();
+
+    FNetEvent Spilled;
+
+    while (Overflow.Dequeue(Spilled))
+        SpilledCount.fetch_sub(1, std::memory_order_release);
+}
@@ -0,0 +1,50 @@
+#include "Network/PacketBufferPool.h"
+
+void FPacketBufferPool::Initialize(int32 InSlotCount, int32 InSlotSize)
+{
+    check(InSlotCount > 0 && InSlotSize > 0);
+
+    const int32 AlignedSlotSize = Align(InSlotSize, 64);
+
+    if (SlotCount != InSlotCount || SlotSize != AlignedSlotSize)
+    {
+        SlotSize = AlignedSlotSize;
+        SlotCount = InSlotCount;
+        Slab.SetNumUninitialized(SlotSize * SlotCount);
+        FreeSlots.SetNumUninitialized(SlotCount);
+        InUse.Init(false, SlotCount);
+        Allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Reset();
+}
+
+void FPacketBufferPool::Reset()
+{
+    for (int32 i = 0; i < SlotCount; ++i)
+    {
+        FreeSlots[i] = SlotCount - 1 - i;
+        InUse[i] = false;
+    }
+
+    FreeCount = SlotCount;
+}
+
+int32 FPacketBufferPool::Acquire()
+{
+    if (FreeCount == 0)
+        return INDEX_NONE;
+
+    const int32 Slot = FreeSlots[--FreeCount];
+    InUse[Slot] = true;
+    return Slot;
+}
+
+void FPacketBufferPool::Release(int32 Slot)
+{
+    if (Slot < 0 || Slot >= SlotCount || !InUse[Slot])
+        return;
+
+    InUse[Slot] = false;
+    FreeSlots[FreeCount++] = Slot;
+}
@@ -0,0 +1,108 @@
+#include "Network/ReliableReceiveWindow.h"
+
+void FReliableReceiveWindow::Reset()
+{
+    // The handles point into pools that are reset alongside, nothing to release here
+    for (FPooledPacket& Slot : Slots)
+        Slot = FPooledPacket();
+
+    FMemory::Memzero(Present, sizeof(Present));
+    Count = 0;
+}
+
+FReliableReceiveWindow::EInsertResult FReliableReceiveWindow::Insert(uint64 Expected, uint64 Sequence, const FPooledPacket& Packet)
+{
+    // Farther than the window reaches: dropped unacknowledged, the sender will resend it
+    if (Sequence - Expected >= static_cast<uint64>(Capacity))
+        return EInsertResult::TooFarAhead;
+
+    if (Contains(Sequence))
+        return EInsertResult::Duplicate;
+
+    const uint64 Index = Sequence & Mask;
+    Slots[Index] = Packet;
+    Present[Index >> 6] |= 1ull << (Index & 63);
+    Count++;
+
+    return EInsertResult::Stored;
+}
+
+bool FReliableReceiveWindow::Take(uint64 Sequence, FPooledPacket& OutPacket)
+{
+    if (!Contains(Sequence))
+        return false;
+
+    const uint64 Index = Sequence & Mask;
+    OutPacket = Slots[Index];
+    Slots[Index] = FPooledPacket();
+    Present[Index >> 6] &= ~(1ull << (Index & 63));
+    Count--;
+
+    return true;
+}
+
+// Stitches 64 bits out of a circular bitmap, starting mid-word when First is unaligned
+template<int32 Capacity>
+static uint64 ReadCircularBits(const uint64 (&Present)[Capacity / 64], uint64 First)
+{
+    constexpr int32 Words = Capacity / 64;
+    const uint64 Index = First & (Capacity - 1);
+    const int32 Word = static_cast<int32>(Index >> 6);
+    const int32 Shift = static_cast<int32>(Index & 63);
+
+    uint64 Bits = Present[Word] >> Shift;
+
+    if (Shift != 0)
+        Bits |= Present[(Word + 1) % Words] << (64 - Shift);
+
+    return Bits;
+}
+
+uint64 FReliableReceiveWindow::GetPresenceMask(uint64 First) const
+{
+    if (Count == 0)
+        return 0;
+
+    return ReadCircularBits<Capacity>(Present, First);
+}
+
+void FReliableSequenceTracker::Reset()
+{
+    FMemory::Memzero(Present, sizeof(Present));
+    Cumulative = 0;
+    Ahead = 0;
+}
+
+void FReliableSequenceTracker::Mark(uint64 Sequence)
+{
+    if (Contains(Sequence) || !IsWithinWindow(Sequence))
+        return;
+
+    uint64 Index = Sequence & Mask;
+    Present[Index >> 6] |= 1ull << (Index & 63);
+    Ahead++;
+
+    // Slide the cumulative point over the run that just became contiguous, clearing its bits
+    // so the slots are free for the sequences Capacity further on
+    for (;;)
+    {
+        Index = (Cumulative + 1) & Mask;
+        uint64& Word = Present[Index >> 6];
+        const uint64 Bit = 1ull << (Index & 63);
+
+        if ((Word & Bit) == 0)
+            break;
+
+        Word &= ~Bit;
+        Cumulative++;
+        Ahead--;
+    }
+}
+
+uint64 FReliableSequenceTracker::GetPresenceMask(uint64 First) const
+{
+    if (Ahead == 0)
+        return 0;
+
+    return ReadCircularBits<Capacity>(Present, First);
+}
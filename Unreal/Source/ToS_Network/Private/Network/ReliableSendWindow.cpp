@@ -0,0 +1,166 @@
+#include "Network/ReliableSendWindow.h"
+
+FReliableSendWindow::FReliableSendWindow(int32 InitialCapacity)
+{
+    const int32 Capacity = FMath::RoundUpToPowerOfTwo(FMath::Max(InitialCapacity, 2));
+    Slots.SetNum(Capacity);
+    Mask = Capacity - 1;
+}
+
+void FReliableSendWindow::Reset()
+{
+    for (uint64 Sequence : Heap)
+        Slots[Sequence & Mask] = FEntry();
+
+    Heap.Reset();
+    Base = 0;
+    Next = 0;
+    BytesInFlight = 0;
+}
+
+FReliableSendWindow::FEntry& FReliableSendWindow::Add(uint64 Sequence, FSendBufferRef Buffer, double SentTime, double Deadline)
+{
+    // Senders on different threads may hand their sequences in slightly out of order
+    const uint64 NewBase = Heap.Num() > 0 ? FMath::Min(Base, Sequence) : Sequence;
+    const uint64 NewNext = Heap.Num() > 0 ? FMath::Max(Next, Sequence + 1) : Sequence + 1;
+
+    if (NewNext - NewBase > static_cast<uint64>(Slots.Num()))
+        Grow(NewNext - NewBase);
+
+    Base = NewBase;
+    Next = NewNext;
+
+    FEntry& Entry = Slots[Sequence & Mask];
+    check(!Entry.bInUse);
+
+    Entry.Buffer = MoveTemp(Buffer);
+    BytesInFlight += Entry.Buffer.Num();
+    Entry.Sequence = Sequence;
+    Entry.SentTime = SentTime;
+    Entry.Deadline = Deadline;
+    Entry.RetryCount = 0;
+    Entry.SackSkips = 0;
+    Entry.bRetransmitted = false;
+    Entry.bInUse = true;
+    Entry.HeapIndex = Heap.Add(Sequence);
+    SiftUp(Entry.HeapIndex);
+
+    return Entry;
+}
+
+bool FReliableSendWindow::Remove(uint64 Sequence)
+{
+    FEntry* Entry = Find(Sequence);
+
+    if (!Entry)
+        return false;
+
+    const int32 Index = Entry->HeapIndex;
+    const int32 Last = Heap.Num() - 1;
+
+    if (Index != Last)
+    {
+        HeapSwap(Index, Last);
+        Heap.Pop();
+
+        SiftDown(Index);
+        SiftUp(Index);
+    }
+    else
+    {
+        Heap.Pop();
+    }
+
+    BytesInFlight -= Entry->Buffer.Num();
+    Entry->Buffer.Reset();
+    Entry->bInUse = false;
+    Entry->HeapIndex = INDEX_NONE;
+
+    // Slide the window past everything already acknowledged
+    if (Heap.Num() == 0)
+    {
+        Base = Next;
+    }
+    else
+    {
+        while (Base < Next && !(Slots[Base & Mask].bInUse && Slots[Base & Mask].Sequence == Base))
+            Base++;
+    }
+
+    return true;
+}
+
+void FReliableSendWindow::Reschedule(FEntry& Entry, double Deadline)
+{
+    const double Previous = Entry.Deadline;
+    Entry.Deadline = Deadline;
+
+    if (Deadline < Previous)
+        SiftUp(Entry.HeapIndex);
+    else
+        SiftDown(Entry.HeapIndex);
+}
+
+void FReliableSendWindow::Grow(uint64 RequiredSpan)
+{
+    int32 Capacity = Slots.Num();
+
+    while (static_cast<uint64>(Capacity) < RequiredSpan)
+        Capacity *= 2;
+
+    TArray<FEntry> Grown;
+    Grown.SetNum(Capacity);
+
+    const uint64 GrownMask = Capacity - 1;
+
+    for (uint64 Sequence : Heap)
+        Grown[Sequence & GrownMask] = MoveTemp(Slots[Sequence & Mask]);
+
+    Slots = MoveTemp(Grown);
+    Mask = GrownMask;
+}
+
+void FReliableSendWindow::SiftUp(int32 Index)
+{
+    while (Index > 0)
+    {
+        const int32 Parent = (Index - 1) / 2;
+
+        if (!HeapLess(Index, Parent))
+            break;
+
+        HeapSwap(Index, Parent);
+        Index = Parent;
+    }
+}
+
+void FReliableSendWindow::SiftDown(int32 Index)
+{
+    const int32 Count = Heap.Num();
+
+    for (;;)
+    {
+        const int32 Left = Index * 2 + 1;
+        const int32 Right = Left + 1;
+        int32 Smallest = Index;
+
+        if (Left < Count && HeapLess(Left, Smallest))
+            Smallest = Left;
+
+        if (Right < Count && HeapLess(Right, Smallest))
+            Smallest = Right;
+
+        if (Smallest == Index)
+            break;
+
+        HeapSwap(Index, Smallest);
+        Index = Smallest;
+    }
+}
+
+void FReliableSendWindow::HeapSwap(int32 A, int32 B)
+{
+    Swap(Heap[A], Heap[B]);
+    Slots[Heap[A] & Mask].HeapIndex = A;
+    Slots[Heap[B] & Mask].HeapIndex = B;
+}
@@ -52,48 +52,135 @@ bool FSecureSession::InitializeAsClient(const TArray<uint8>& ClientPrivateKey, c
     if (crypto_scalarmult_curve25519(SharedSecret, ClientPrivateKey.GetData(), ServerPublicKey.GetData()) != 0)
         return false;
 
+    static constexpr char Info[] = "ToS-UE5 v1";
+    uint8 OKM[64];
+    DeriveKeyMaterial(SharedSecret, 32, Salt.GetData(), 16, reinterpret_cast<const uint8*>(Info), sizeof(Info) - 1, OKM, sizeof(OKM));
+    sodium_memzero(SharedSecret, sizeof(SharedSecret));
+
+    ApplyKeyMaterial(OKM, Salt.GetData(), InConnectionId);
+    return true;
+}
+
+bool FSecureSession::InitializeFromResumption(const uint8* ResumptionSecret, const uint8* ResumeNonce, const TArray<uint8>& Salt, uint32 InConnectionId)
+{
+    if (Salt.Num() != 16)
+        return false;
+
+    // The server mixes its fresh salt with our fresh nonce, neither side can replay the other into old keys
+    static constexpr char ResumeInfo[] = "ToS-UE5 v1 resume";
+    uint8 Info[sizeof(ResumeInfo) - 1 + ResumeNonceSize];
+    FMemory::Memcpy(Info, ResumeInfo, sizeof(ResumeInfo) - 1);
+    FMemory::Memcpy(Info + sizeof(ResumeInfo) - 1, ResumeNonce, ResumeNonceSize);
+
+    uint8 OKM[64];
+    DeriveKeyMaterial(ResumptionSecret, ResumptionSecretSize, Salt.GetData(), 16, Info, sizeof(Info), OKM, sizeof(OKM));
+
+    ApplyKeyMaterial(OKM, Salt.GetData(), InConnectionId);
+    return true;
+}
+
+void FSecureSession::DeriveResumptionSecret(uint8* Secret) const
+{
+    static constexpr char ResumptionInfo[] = "ToS-UE5 v1 resumption";
+
+    uint8 IKM[64];
+    FMemory::Memcpy(IKM, TxKey, 32);        // Client->Server
+    FMemory::Memcpy(IKM + 32, RxKey, 32);   // Server->Client
+
+    DeriveKeyMaterial(IKM, sizeof(IKM), SessionSalt, sizeof(SessionSalt), reinterpret_cast<const uint8*>(ResumptionInfo),
+        sizeof(ResumptionInfo) - 1, Secret, ResumptionSecretSize);
+}
+
+void FSecureSession::DeriveKeyMaterial(const uint8* IKM, int32 IKMLength, const uint8* Salt, int32 SaltLength,
+                                       const uint8* Info, int32 InfoLength, uint8* OKM, int32 OKMLength)
+{
+    // HKDF-SHA256 (RFC 5869), the same derivation the server runs through BouncyCastle
     uint8 PRK[32];
     crypto_auth_hmacsha256_state state;
-    crypto_auth_hmacsha256_init(&state, Salt.GetData(), 16);
-    crypto_auth_hmacsha256_update(&state, SharedSecret, 32);
+    crypto_auth_hmacsha256_init(&state, Salt, SaltLength);
+    crypto_auth_hmacsha256_update(&state, IKM, IKMLength);
     crypto_auth_hmacsha256_final(&state, PRK);
 
-    const char* Info = "ToS-UE5 v1";
-    uint8 OKM[64];
     uint8 T[32];
 
-    crypto_auth_hmacsha256_init(&state, PRK, 32);
-    crypto_auth_hmacsha256_update(&state, (const uint8*)Info, strlen(Info));
-    crypto_auth_hmacsha256_update(&state, (const uint8*)"\x01", 1);
-    crypto_auth_hmacsha256_final(&state, T);
-    FMemory::Memcpy(OKM, T, 32);
+    for (uint8 Block = 1; OKMLength > 0; Block++)
+    {
+        crypto_auth_hmacsha256_init(&state, PRK, 32);
+
+        if (Block > 1)
+            crypto_auth_hmacsha256_update(&state, T, 32);
+
+        crypto_auth_hmacsha256_update(&state, Info, InfoLength);
+        crypto_auth_hmacsha256_update(&state, &Block, 1);
+        crypto_auth_hmacsha256_final(&state, T);
 
-    crypto_auth_hmacsha256_init(&state, PRK, 32);
-    crypto_auth_hmacsha256_update(&state, T, 32);
-    crypto_auth_hmacsha256_update(&state, (const uint8*)Info, strlen(Info));
-    crypto_auth_hmacsha256_update(&state, (const uint8*)"\x02", 1);
-    crypto_auth_hmacsha256_final(&state, T);
-    FMemory::Memcpy(OKM + 32, T, 32);
+        const int32 Length = FMath::Min(OKMLength, 32);
+        FMemory::Memcpy(OKM, T, Length);
+        OKM += Length;
+        OKMLength -= Length;
+    }
+
+    sodium_memzero(PRK, sizeof(PRK));
+    sodium_memzero(T, sizeof(T));
+}
 
+void FSecureSession::ApplyKeyMaterial(const uint8* OKM, const uint8* Salt, uint32 InConnectionId)
+{
     FMemory::Memcpy(TxKey, OKM + 32, 32);
     FMemory::Memcpy(RxKey, OKM, 32);
 
-    FMemory::Memcpy(SessionSalt, Salt.GetData(), 16);
+    FMemory::Memcpy(SessionSalt, Salt, 16);
 
     ConnectionId = InConnectionId;
     SeqTx = 0;
     SeqRx = 0;
     ReplayWindow = 0;
     HighestSeqReceived = 0;
+    Options = ESessionOptions::None;
+    CompressionRatio = 0.0f;
+    CompressionSkipped = 0;
+    Dictionary = nullptr;
+}
 
-    return true;
+void FSecureSession::SetOptions(ESessionOptions InOptions)
+{
+    Options = InOptions;
+
+    if (IsAES256GCM())
+    {
+        crypto_aead_aes256gcm_beforenm(&TxAESState, TxKey);
+        crypto_aead_aes256gcm_beforenm(&RxAESState, RxKey);
+    }
+}
+
+int FSecureSession::Seal(uint8* Ciphertext, uint8* Tag, const uint8* Plaintext, int32 Length, const uint8* AAD, int32 AADLength, const uint8* Nonce) const
+{
+    unsigned long long TagLength = 0;
+
+    if (IsAES256GCM())
+        return crypto_aead_aes256gcm_encrypt_detached_afternm(Ciphertext, Tag, &TagLength, Plaintext, Length, AAD, AADLength, nullptr, Nonce, &TxAESState);
+
+    return crypto_aead_chacha20poly1305_ietf_encrypt_detached(Ciphertext, Tag, &TagLength, Plaintext, Length, AAD, AADLength, nullptr, Nonce, TxKey);
+}
+
+int FSecureSession::Open(uint8* Plaintext, const uint8* Ciphertext, int32 Length, const uint8* Tag, const uint8* AAD, int32 AADLength, const uint8* Nonce) const
+{
+    if (IsAES256GCM())
+        return crypto_aead_aes256gcm_decrypt_detached_afternm(Plaintext, nullptr, Ciphertext, Length, Tag, AAD, AADLength, Nonce, &RxAESState);
+
+    return crypto_aead_chacha20poly1305_ietf_decrypt_detached(Plaintext, nullptr, Ciphertext, Length, Tag, AAD, AADLength, Nonce, RxKey);
 }
 
 void FSecureSession::GenerateNonce(uint64 Sequence, TArray<uint8>& Nonce) const
 {
-    Nonce.SetNumUninitialized(12);
-    FMemory::Memcpy(Nonce.GetData(), &ConnectionId, 4);
-    FMemory::Memcpy(Nonce.GetData() + 4, &Sequence, 8);
+    Nonce.SetNumUninitialized(NonceSize);
+    GenerateNonce(Sequence, Nonce.GetData());
+}
+
+void FSecureSession::GenerateNonce(uint64 Sequence, uint8* Nonce) const
+{
+    FMemory::Memcpy(Nonce, &ConnectionId, 4);
+    FMemory::Memcpy(Nonce + 4, &Sequence, 8);
 }
 
 bool FSecureSession::EncryptPayload(const TArray<uint8>& Plaintext, const TArray<uint8>& AAD, TArray<uint8>& Ciphertext)
@@ -109,16 +196,10 @@ bool FSecureSession::EncryptPayload(const TArray<uint8>& Plaintext, const TArray
 
 
 
-    Ciphertext.SetNumUninitialized(Plaintext.Num() + crypto_aead_chacha20poly1305_ietf_ABYTES);
+    Ciphertext.SetNumUninitialized(Plaintext.Num() + TagSize);
 
-    unsigned long long CiphertextLen;
-    int Result = crypto_aead_chacha20poly1305_ietf_encrypt(
-        Ciphertext.GetData(), &CiphertextLen,
-        Plaintext.GetData(), Plaintext.Num(),
-        AAD.GetData(), AAD.Num(),
-        nullptr,
-        Nonce.GetData(), TxKey
-    );
+    int Result = Seal(Ciphertext.GetData(), Ciphertext.GetData() + Plaintext.Num(), Plaintext.GetData(), Plaintext.Num(),
+                      AAD.GetData(), AAD.Num(), Nonce.GetData());
 
     if (Result != 0)
     {
@@ -126,8 +207,6 @@ bool FSecureSession::EncryptPayload(const TArray<uint8>& Plaintext, const TArray
         return false;
     }
 
-    Ciphertext.SetNum(CiphertextLen);
-
     SeqTx++;
 
     // Log TxKey to file (only once)
@@ -142,84 +221,67 @@ bool FSecureSession::EncryptPayload(const TArray<uint8>& Plaintext, const TArray
     return true;
 }
 
-bool FSecureSession::EncryptPayloadWithCompression(const TArray<uint8>& Plaintext, const TArray<uint8>& AAD, TArray<uint8>& Result, bool& bWasCompressed)
+bool FSecureSession::EncryptInPlace(uint8* Data, int32 Length, const uint8* AAD, int32 AADLength, int32& CiphertextLength)
 {
-    bWasCompressed = false;
+    uint8 Nonce[NonceSize] = {};
+    GenerateNonce(SeqTx, Nonce);
 
-    TArray<uint8> Encrypted;
+    // Detached mode keeps the ciphertext over the plaintext and lets the tag land right after it
+    const int Result = Seal(Data, Data + Length, Data, Length, AAD, AADLength, Nonce);
 
-    if (!EncryptPayload(Plaintext, AAD, Encrypted))
+    if (Result != 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("[CRYPTO] Encrypt failed with result: %d"), Result);
         return false;
+    }
+
+    CiphertextLength = Length + TagSize;
+    SeqTx++;
+
+    return true;
+}
 
-    if (Encrypted.Num() > 512)
+bool FSecureSession::EncryptPayloadWithCompression(const TArray<uint8>& Plaintext, FPacketHeader& Header, TArray<uint8>& Result)
+{
+    if (ShouldCompress(Plaintext.Num()))
     {
         TArray<uint8> Compressed;
-        Compressed.SetNumUninitialized(Encrypted.Num() + 1024);
+        Compressed.SetNumUninitialized(Plaintext.Num());
 
-        int32 CompressedLength = FLZ4::Compress(Encrypted.GetData(), Encrypted.Num(), Compressed.GetData(), Compressed.Num());
+        const int32 CompressedLength = Compress(Plaintext.GetData(), Plaintext.Num(), Compressed.GetData(), Compressed.Num(),
+                                                GetChannelKind(Header.Channel) != EPacketChannel::Unreliable);
 
-        if (CompressedLength > 0 && CompressedLength < Encrypted.Num())
+        if (CompressedLength > 0)
         {
-            bWasCompressed = true;
-            Result.SetNumUninitialized(CompressedLength);
-            FMemory::Memcpy(Result.GetData(), Compressed.GetData(), CompressedLength);
-            return true;
+            // The flag has to be in place before the AAD is taken
+            Compressed.SetNum(CompressedLength);
+            Header.Flags |= EPacketHeaderFlags::Compressed;
+            return EncryptPayload(Compressed, Header.GetAAD(), Result);
         }
     }
 
-    Result = MoveTemp(Encrypted);
-    return true;
+    return EncryptPayload(Plaintext, Header.GetAAD(), Result);
 }
 
-bool FSecureSession::EncryptPayloadWithSequence(const TArray<uint8>& Plaintext, const TArray<uint8>& AAD, uint64 Sequence, TArray<uint8>& Result, bool& bWasCompressed)
+bool FSecureSession::EncryptPayloadWithSequence(const TArray<uint8>& Plaintext, FPacketHeader& Header, uint64 Sequence, TArray<uint8>& Result)
 {
-    bWasCompressed = false;
-
-    // Use specific sequence instead of internal SeqTx
-    TArray<uint8> Nonce;
-    GenerateNonce(Sequence, Nonce);
-
-    TArray<uint8> Encrypted;
-    Encrypted.SetNumUninitialized(Plaintext.Num() + crypto_aead_chacha20poly1305_ietf_ABYTES);
-
-    unsigned long long CiphertextLen;
-    int EncryptResult = crypto_aead_chacha20poly1305_ietf_encrypt(
-        Encrypted.GetData(), &CiphertextLen,
-        Plaintext.GetData(), Plaintext.Num(),
-        AAD.GetData(), AAD.Num(),
-        nullptr,
-        Nonce.GetData(), TxKey
-    );
-
-    if (EncryptResult != 0)
-    {
-        UE_LOG(LogTemp, Error, TEXT("[CRYPTO] Encrypt failed with result: %d"), EncryptResult);
-        return false;
-    }
-
-    Encrypted.SetNum(CiphertextLen);
-
-    // Increment SeqTx to keep crypto sequence in sync
-    SeqTx++;
-
-    if (Encrypted.Num() > 512)
+    if (ShouldCompress(Plaintext.Num()))
     {
         TArray<uint8> Compressed;
-        Compressed.SetNumUninitialized(Encrypted.Num() + 1024);
+        Compressed.SetNumUninitialized(Plaintext.Num());
 
-        int32 CompressedLength = FLZ4::Compress(Encrypted.GetData(), Encrypted.Num(), Compressed.GetData(), Compressed.Num());
+        const int32 CompressedLength = Compress(Plaintext.GetData(), Plaintext.Num(), Compressed.GetData(), Compressed.Num(),
+                                                GetChannelKind(Header.Channel) != EPacketChannel::Unreliable);
 
-        if (CompressedLength > 0 && CompressedLength < Encrypted.Num())
+        if (CompressedLength > 0)
         {
-            bWasCompressed = true;
-            Result.SetNumUninitialized(CompressedLength);
-            FMemory::Memcpy(Result.GetData(), Compressed.GetData(), CompressedLength);
-            return true;
+            Compressed.SetNum(CompressedLength);
+            Header.Flags |= EPacketHeaderFlags::Compressed;
+            return EncryptPayloadWithSpecificSequence(Compressed, Header.GetAAD(), Sequence, Result);
         }
     }
 
-    Result = MoveTemp(Encrypted);
-    return true;
+    return EncryptPayloadWithSpecificSequence(Plaintext, Header.GetAAD(), Sequence, Result);
 }
 
 bool FSecureSession::EncryptPayloadWithSpecificSequence(const TArray<uint8>& Plaintext, const TArray<uint8>& AAD, uint64 Sequence, TArray<uint8>& Ciphertext)
@@ -228,16 +290,10 @@ bool FSecureSession::EncryptPayloadWithSpecificSequence(const TArray<uint8>& Pla
     TArray<uint8> Nonce;
     GenerateNonce(Sequence, Nonce);
 
-    Ciphertext.SetNumUninitialized(Plaintext.Num() + crypto_aead_chacha20poly1305_ietf_ABYTES);
+    Ciphertext.SetNumUninitialized(Plaintext.Num() + TagSize);
 
-    unsigned long long CiphertextLen;
-    int Result = crypto_aead_chacha20poly1305_ietf_encrypt(
-        Ciphertext.GetData(), &CiphertextLen,
-        Plaintext.GetData(), Plaintext.Num(),
-        AAD.GetData(), AAD.Num(),
-        nullptr,
-        Nonce.GetData(), TxKey
-    );
+    int Result = Seal(Ciphertext.GetData(), Ciphertext.GetData() + Plaintext.Num(), Plaintext.GetData(), Plaintext.Num(),
+                      AAD.GetData(), AAD.Num(), Nonce.GetData());
 
     if (Result != 0)
     {
@@ -245,8 +301,6 @@ bool FSecureSession::EncryptPayloadWithSpecificSequence(const TArray<uint8>& Pla
         return false;
     }
 
-    Ciphertext.SetNum(CiphertextLen);
-
     // Increment SeqTx to keep crypto sequence in sync
     SeqTx++;
     return true;
@@ -254,29 +308,63 @@ bool FSecureSession::EncryptPayloadWithSpecificSequence(const TArray<uint8>& Pla
 
 bool FSecureSession::DecryptPayload(const TArray<uint8>& Ciphertext, const TArray<uint8>& AAD, uint64 Sequence, TArray<uint8>& Plaintext)
 {
-    if (!IsSequenceValid(Sequence))
-    {
-        UE_LOG(LogTemp, Warning, TEXT("[CRYPTO] Decrypt - Replay attack detected! Sequence: %llu"), Sequence);
+    if (Ciphertext.Num() < TagSize)
+        return false;
+
+    Plaintext.SetNumUninitialized(Ciphertext.Num() - TagSize);
+
+    int32 PlaintextLen = 0;
+
+    if (!DecryptPayload(Ciphertext.GetData(), Ciphertext.Num(), AAD.GetData(), AAD.Num(), Sequence, Plaintext.GetData(), Plaintext.Num(), PlaintextLen))
         return false;
+
+    Plaintext.SetNum(PlaintextLen);
+    return true;
+}
+
+bool FSecureSession::DecryptPayloadWithDecompression(const TArray<uint8>& Data, const TArray<uint8>& AAD, uint64 Sequence, bool bIsCompressed, TArray<uint8>& Plaintext)
+{
+    if (bIsCompressed)
+    {
+        TArray<uint8> Decrypted;
+
+        if (!DecryptPayload(Data, AAD, Sequence, Decrypted))
+            return false;
+
+        Plaintext.SetNumUninitialized(MaxDecompressedSize);
+
+        const int32 DecompressedLength = Decompress(Decrypted.GetData(), Decrypted.Num(), Plaintext.GetData(), Plaintext.Num());
+        if (DecompressedLength <= 0)
+            return false;
+
+        Plaintext.SetNum(DecompressedLength);
+        return true;
     }
+    else
+    {
+        return DecryptPayload(Data, AAD, Sequence, Plaintext);
+    }
+}
 
-    TArray<uint8> Nonce;
-    Nonce.SetNumUninitialized(12);
-    FMemory::Memcpy(Nonce.GetData(), &ConnectionId, 4);
-    FMemory::Memcpy(Nonce.GetData() + 4, &Sequence, 8);
+bool FSecureSession::DecryptPayload(const uint8* Ciphertext, int32 CiphertextLength, const uint8* AAD, int32 AADLength, uint64 Sequence,
+                                    uint8* Plaintext, int32 PlaintextCapacity, int32& PlaintextLength)
+{
+    PlaintextLength = 0;
 
+    if (CiphertextLength < TagSize || PlaintextCapacity < CiphertextLength - TagSize)
+        return false;
 
+    if (!IsSequenceValid(Sequence))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[CRYPTO] Decrypt - Replay attack detected! Sequence: %llu"), Sequence);
+        return false;
+    }
 
-    Plaintext.SetNumUninitialized(Ciphertext.Num() - crypto_aead_chacha20poly1305_ietf_ABYTES);
+    uint8 Nonce[NonceSize];
+    GenerateNonce(Sequence, Nonce);
 
-    unsigned long long PlaintextLen;
-    int Result = crypto_aead_chacha20poly1305_ietf_decrypt(
-        Plaintext.GetData(), &PlaintextLen,
-        nullptr,
-        Ciphertext.GetData(), Ciphertext.Num(),
-        AAD.GetData(), AAD.Num(),
-        Nonce.GetData(), RxKey
-    );
+    const int32 Length = CiphertextLength - TagSize;
+    int Result = Open(Plaintext, Ciphertext, Length, Ciphertext + Length, AAD, AADLength, Nonce);
 
     if (Result != 0)
     {
@@ -284,30 +372,90 @@ bool FSecureSession::DecryptPayload(const TArray<uint8>& Ciphertext, const TArra
         return false;
     }
 
-    Plaintext.SetNum(PlaintextLen);
+    PlaintextLength = Length;
 
     UpdateReplayWindow(Sequence);
     return true;
 }
 
-bool FSecureSession::DecryptPayloadWithDecompression(const TArray<uint8>& Data, const TArray<uint8>& AAD, uint64 Sequence, bool bIsCompressed, TArray<uint8>& Plaintext)
+bool FSecureSession::DecryptPayloadWithDecompression(const uint8* Data, int32 DataLength, const uint8* AAD, int32 AADLength, uint64 Sequence, bool bIsCompressed,
+                                                     uint8* Scratch, int32 ScratchCapacity, uint8* Plaintext, int32 PlaintextCapacity, int32& PlaintextLength)
 {
     if (bIsCompressed)
     {
-        TArray<uint8> Decompressed;
-        Decompressed.SetNumUninitialized(Data.Num() * 4);
+        // The compressed plaintext is authenticated first, only then handed to the decompressor
+        int32 DecryptedLength = 0;
 
-        int32 DecompressedLength = FLZ4::Decompress(Data.GetData(), Data.Num(), Decompressed.GetData(), Decompressed.Num());
-        if (DecompressedLength <= 0)
+        if (!DecryptPayload(Data, DataLength, AAD, AADLength, Sequence, Scratch, ScratchCapacity, DecryptedLength))
             return false;
 
-        Decompressed.SetNum(DecompressedLength);
-        return DecryptPayload(Decompressed, AAD, Sequence, Plaintext);
-    }
-    else
-    {
-        return DecryptPayload(Data, AAD, Sequence, Plaintext);
+        PlaintextLength = Decompress(Scratch, DecryptedLength, Plaintext, PlaintextCapacity);
+        return PlaintextLength > 0;
     }
+
+    return DecryptPayload(Data, DataLength, AAD, AADLength, Sequence, Plaintext, PlaintextCapacity, PlaintextLength);
+}
+
+void FSecureSession::SetCompression(bool bEnabled, int32 Threshold)
+{
+    bCompressionEnabled = bEnabled;
+    CompressionThreshold = FMath::Max(1, Threshold);
+}
+
+bool FSecureSession::ShouldCompress(int32 Length)
+{
+    const int32 Threshold = Dictionary ? FMath::Min(CompressionThreshold, DictionaryCompressionThreshold) : CompressionThreshold;
+
+    if (!bCompressionEnabled || Length < Threshold)
+        return false;
+
+    // Traffic has been incompressible so far, only probe every so often
+    if (CompressionRatio >= IncompressibleRatio && ++CompressionSkipped < CompressionProbeInterval)
+        return false;
+
+    CompressionSkipped = 0;
+    return true;
+}
+
+void FSecureSession::SetCompressionLevel(int32 Acceleration, int32 HighThreshold)
+{
+    CompressionAcceleration = FMath::Clamp(Acceleration, 1, FLZ4Level::MaxAcceleration);
+    HighCompressionThreshold = FMath::Max(0, HighThreshold);
+}
+
+int32 FSecureSession::Compress(const uint8* Data, int32 Length, uint8* Out, int32 OutCapacity, bool bReliable)
+{
+    // Capped below the input so LZ4 gives up as soon as the result cannot be smaller
+    const int32 Capacity = FMath::Min(OutCapacity, Length - 1);
+
+    // Both the send path and the network thread compress through here, each on its own thread's LZ4 state
+    const FLZ4Level Level = bReliable && HighCompressionThreshold > 0 && Length >= HighCompressionThreshold
+        ? FLZ4Level::High()
+        : FLZ4Level::Fast(CompressionAcceleration);
+
+    int32 CompressedLength = Dictionary
+        ? FLZ4::CompressWithDictionary(Data, Length, Out, Capacity, *Dictionary, Level)
+        : FLZ4::Compress(Data, Length, Out, Capacity, Level);
+
+    if (CompressedLength <= 0 || CompressedLength >= Length)
+        CompressedLength = 0;
+
+    const float Sample = CompressedLength > 0 ? static_cast<float>(CompressedLength) / Length : 1.0f;
+    CompressionRatio = CompressionRatio > 0.0f ? CompressionRatio + (Sample - CompressionRatio) * CompressionRatioGain : Sample;
+
+    return CompressedLength;
+}
+
+int32 FSecureSession::Decompress(const uint8* Data, int32 Length, uint8* Out, int32 OutCapacity) const
+{
+    return Dictionary
+        ? FLZ4::DecompressWithDictionary(Data, Length, Out, OutCapacity, *Dictionary)
+        : FLZ4::Decompress(Data, Length, Out, OutCapacity);
+}
+
+uint32 FSecureSession::GetDictionaryId() const
+{
+    return Dictionary ? Dictionary->GetId() : 0;
 }
 
 bool FSecureSession::IsSequenceValid(uint64 Sequence) const
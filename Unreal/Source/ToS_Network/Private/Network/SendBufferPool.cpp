@@ -0,0 +1,126 @@
+#include "Network/SendBufferPool.h"
+
+FSendBufferRef::FSendBufferRef(const FSendBufferRef& Other)
+    : Buffer(Other.Buffer)
+{
+    if (Buffer)
+        Buffer->RefCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+FSendBufferRef& FSendBufferRef::operator=(const FSendBufferRef& Other)
+{
+    if (Buffer != Other.Buffer)
+    {
+        Reset();
+        Buffer = Other.Buffer;
+
+        if (Buffer)
+            Buffer->RefCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return *this;
+}
+
+FSendBufferRef& FSendBufferRef::operator=(FSendBufferRef&& Other)
+{
+    if (this != &Other)
+    {
+        Reset();
+        Buffer = Other.Buffer;
+        Other.Buffer = nullptr;
+    }
+
+    return *this;
+}
+
+void FSendBufferRef::Reset()
+{
+    if (!Buffer)
+        return;
+
+    // acq_rel so the writes of every previous holder happen before the buffer is reused
+    if (Buffer->RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        Buffer->Owner->Release(Buffer);
+
+    Buffer = nullptr;
+}
+
+FSendBufferPool::~FSendBufferPool()
+{
+    for (FSendBuffer* Buffer : Buffers)
+        delete Buffer;
+}
+
+void FSendBufferPool::Reserve(int32 Count)
+{
+    FScopeLock ScopeLock(&Lock);
+
+    while (Buffers.Num() < Count)
+        FreeBuffers.Add(Allocate());
+}
+
+FSendBufferRef FSendBufferPool::Acquire()
+{
+    FSendBuffer* Buffer = nullptr;
+
+    {
+        FScopeLock ScopeLock(&Lock);
+        Buffer = FreeBuffers.Num() > 0 ? FreeBuffers.Pop() : Allocate();
+    }
+
+    Buffer->RefCount.store(1, std::memory_order_relaxed);
+    Buffer->Length = 0;
+    return FSendBufferRef(Buffer);
+}
+
+void FSendBufferPool::Release(FSendBuffer* Buffer)
+{
+    FScopeLock ScopeLock(&Lock);
+    FreeBuffers.Add(Buffer);
+}
+
+FSendBuffer* FSendBufferPool::Allocate()
+{
+    // Caller holds Lock
+    FSendBuffer* Buffer = new FSendBuffer();
+    Buffer->Owner = this;
+    Buffers.Add(Buffer);
+    Allocations.fetch_add(1, std::memory_order_relaxed);
+    return Buffer;
+}
+
+void FSendBufferQueue::Push(FSendBufferRef Buffer)
+{
+    // Reclaim the consumed front before growing
+    if (Head > 0 && Head >= Items.Num() / 2)
+    {
+        Items.RemoveAt(0, Head);
+        Head = 0;
+    }
+
+    QueuedBytes += Buffer.Num();
+    Items.Add(MoveTemp(Buffer));
+}
+
+void FSendBufferQueue::Pop()
+{
+    if (IsEmpty())
+        return;
+
+    QueuedBytes -= Items[Head].Num();
+    Items[Head].Reset();
+    Head++;
+
+    if (Head == Items.Num())
+    {
+        Items.Reset();
+        Head = 0;
+    }
+}
+
+void FSendBufferQueue::Reset()
+{
+    Items.Reset();
+    Head = 0;
+    QueuedBytes = 0;
+}
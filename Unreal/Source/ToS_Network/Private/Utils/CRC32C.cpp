@@ -1,178 +1,289 @@
 #include "Utils/CRC32C.h"
 
-#if PLATFORM_WINDOWS || PLATFORM_LINUX
-#include <immintrin.h> // SSE4.2
+#if PLATFORM_CPU_X86_FAMILY && PLATFORM_64BITS
+#define CRC32C_X86 1
+#include <immintrin.h> // SSE4.2, PCLMULQDQ
+#if PLATFORM_WINDOWS
+#include <intrin.h>
+#endif
+#else
+#define CRC32C_X86 0
 #endif
 
-#if PLATFORM_MAC || PLATFORM_IOS
+#if PLATFORM_CPU_ARM_FAMILY && defined(__ARM_FEATURE_CRC32)
+#define CRC32C_ARM 1
 #include <arm_acle.h>
+#else
+#define CRC32C_ARM 0
 #endif
 
-uint32 FCRC32C::Table[16 * 256] = { 0 };
-bool FCRC32C::bTableInitialized = false;
+// GCC and Clang only emit the instructions inside functions that ask for them, MSVC always does
+#if defined(__clang__) || defined(__GNUC__)
+#define CRC32C_TARGET(Features) __attribute__((target(Features)))
+#else
+#define CRC32C_TARGET(Features)
+#endif
 
-void FCRC32C::InitializeTable()
+namespace
 {
-    if (bTableInitialized)
-        return;
+    constexpr uint32 Polynomial = 0x82F63B78u;
+
+    struct FCRC32CTable
+    {
+        uint32 Entries[16 * 256];
+    };
 
-    for (uint32 i = 0; i < 256; i++)
+    // Slicing-by-16: slice t advances a byte through t further zero bytes. Each slice is derived from the
+    // previous one, which keeps the compile-time evaluation short.
+    constexpr FCRC32CTable MakeTable()
     {
-        uint32 res = i;
-        for (int t = 0; t < 16; t++)
+        FCRC32CTable Table{};
+
+        for (uint32 i = 0; i < 256; i++)
+        {
+            uint32 Res = i;
+
+            for (int32 k = 0; k < 8; k++)
+                Res = (Res & 1) ? (Polynomial ^ (Res >> 1)) : (Res >> 1);
+
+            Table.Entries[i] = Res;
+        }
+
+        for (int32 t = 1; t < 16; t++)
         {
-            for (int k = 0; k < 8; k++)
-                res = (res & 1) ? (Polynomial ^ (res >> 1)) : (res >> 1);
-            Table[t * 256 + i] = res;
+            for (uint32 i = 0; i < 256; i++)
+            {
+                const uint32 Previous = Table.Entries[(t - 1) * 256 + i];
+                Table.Entries[t * 256 + i] = (Previous >> 8) ^ Table.Entries[Previous & 0xFF];
+            }
         }
+
+        return Table;
     }
 
-    bTableInitialized = true;
-}
+    constexpr FCRC32CTable Table = MakeTable();
 
-bool FCRC32C::HasSSE42()
-{
-#if PLATFORM_WINDOWS
-    int CPUInfo[4] = { -1 };
-    __cpuid(CPUInfo, 1);
-    return (CPUInfo[2] & (1 << 20)) != 0;
-#elif PLATFORM_LINUX || PLATFORM_MAC
-    return __builtin_cpu_supports("sse4.2");
-#else
-    return false;
-#endif
-}
+    // A * B mod P, with polynomials bit-reflected the way the CRC register holds them (x^0 in the top bit)
+    constexpr uint32 MultiplyModP(uint32 A, uint32 B)
+    {
+        uint32 Product = 0;
 
-bool FCRC32C::HasARMCRC()
-{
-#if PLATFORM_MAC || PLATFORM_IOS
-    return true;
-#else
-    return false;
-#endif
-}
+        for (int32 i = 0; i < 32; i++)
+        {
+            if (A & (0x80000000u >> i))
+                Product ^= B;
 
-uint32 FCRC32C::Compute(const uint8* Data, int32 Length)
-{
-    uint32 crcLocal = 0xFFFFFFFFu;
+            B = (B & 1) ? (Polynomial ^ (B >> 1)) : (B >> 1);
+        }
 
-    if (HasSSE42())
-    {
-        return ComputeSSE42(Data, Length, crcLocal) ^ 0xFFFFFFFFu;
+        return Product;
     }
-    else if (HasARMCRC())
-    {
-        return ComputeARMCRC(Data, Length, crcLocal) ^ 0xFFFFFFFFu;
-    }
-    else
+
+    constexpr uint32 PowXModP(uint64 Exponent)
     {
-        InitializeTable();
-        return ComputeFallback(Data, Length, crcLocal) ^ 0xFFFFFFFFu;
-    }
-}
+        uint32 Result = 0x80000000u;
+        uint32 Square = 0x40000000u;
 
-uint32 FCRC32C::ComputeSSE42(const uint8* Data, int32 Length, uint32 crcLocal)
-{
-#if PLATFORM_WINDOWS || PLATFORM_LINUX
-    const uint8* p = Data;
-    int remaining = Length;
+        for (; Exponent != 0; Exponent >>= 1)
+        {
+            if (Exponent & 1)
+                Result = MultiplyModP(Result, Square);
 
-    uint64 crcLocal64 = crcLocal; // Correo aqui
+            Square = MultiplyModP(Square, Square);
+        }
 
-    while (remaining >= 8)
-    {
-        crcLocal64 = _mm_crc32_u64(crcLocal64, *(const uint64*)p);
-        p += 8;
-        remaining -= 8;
+        return Result;
     }
 
-    crcLocal = (uint32)crcLocal64;
-
-    while (remaining--)
+    FORCEINLINE uint64 Load64(const uint8* Data)
     {
-        crcLocal = _mm_crc32_u8(crcLocal, *p++);
+        uint64 Value;
+        FMemory::Memcpy(&Value, Data, sizeof(Value));
+        return Value;
     }
 
-    return crcLocal;
-#else
-    return ComputeFallback(Data, Length, crcLocal);
-#endif
-}
+#if CRC32C_X86
+    CRC32C_TARGET("sse4.2")
+    uint32 UpdateBytesSSE42(uint32 State, const uint8* Data, int32 Length)
+    {
+        uint64 State64 = State;
 
-uint32 FCRC32C::ComputeARMCRC(const uint8* Data, int32 Length, uint32 crcLocal)
-{
-#if PLATFORM_MAC || PLATFORM_IOS
-    const uint8* p = Data;
-    int remaining = Length;
+        for (; Length >= 8; Data += 8, Length -= 8)
+            State64 = _mm_crc32_u64(State64, Load64(Data));
 
-    uint64 crcLocal64 = crcLocal; // Correo aqui
+        State = static_cast<uint32>(State64);
 
-    while (remaining >= 8)
-    {
-        crcLocal64 = __crc32cd(crcLocal64, *(const uint64*)p);
-        p += 8;
-        remaining -= 8;
+        while (Length--)
+            State = _mm_crc32_u8(State, *Data++);
+
+        return State;
     }
 
-    crcLocal = (uint32)crcLocal64;
+    // Carry-less multiplication shifts a register across the streams that follow it. The product of two
+    // reflected 32-bit values comes out one bit short of the 64-bit layout crc32q reads, hence 33 rather than 32.
+    struct FFoldConstants
+    {
+        uint64 Stream0;
+        uint64 Stream1;
+    };
 
-    while (remaining >= 4)
+    constexpr FFoldConstants MakeFoldConstants(int32 Stride)
     {
-        crcLocal = __crc32cw(crcLocal, *(const uint32*)p);
-        p += 4;
-        remaining -= 4;
+        return { PowXModP(2 * 8 * static_cast<uint64>(Stride) - 33), PowXModP(8 * static_cast<uint64>(Stride) - 33) };
     }
 
-    while (remaining--)
+    // Three crc32q chains at once keep the instruction's pipeline full (latency 3, throughput 1) where one
+    // dependent chain leaves it two thirds idle. Each round covers three adjacent Stride-byte streams; the
+    // first two are folded into the last 8 bytes of the third, which crc32q then reduces with it.
+    CRC32C_TARGET("sse4.2,pclmul")
+    uint64 UpdateStreams(uint64 State, const uint8*& Data, int32& Length, int32 Stride, FFoldConstants Constants)
     {
-        crcLocal = __crc32cb(crcLocal, *p++);
+        const __m128i Fold = _mm_set_epi64x(static_cast<int64>(Constants.Stream1), static_cast<int64>(Constants.Stream0));
+
+        for (; Length >= 3 * Stride; Data += 3 * Stride, Length -= 3 * Stride)
+        {
+            uint64 State1 = 0;
+            uint64 State2 = 0;
+            const uint8* Last = Data + Stride - 8;
+            const uint8* P = Data;
+
+            for (; P < Last; P += 8)
+            {
+                State = _mm_crc32_u64(State, Load64(P));
+                State1 = _mm_crc32_u64(State1, Load64(P + Stride));
+                State2 = _mm_crc32_u64(State2, Load64(P + 2 * Stride));
+            }
+
+            State = _mm_crc32_u64(State, Load64(P));
+            State1 = _mm_crc32_u64(State1, Load64(P + Stride));
+
+            const __m128i Folded = _mm_xor_si128(
+                _mm_clmulepi64_si128(_mm_cvtsi64_si128(static_cast<int64>(State)), Fold, 0x00),
+                _mm_clmulepi64_si128(_mm_cvtsi64_si128(static_cast<int64>(State1)), Fold, 0x10));
+
+            State = _mm_crc32_u64(State2, Load64(P + 2 * Stride) ^ static_cast<uint64>(_mm_cvtsi128_si64(Folded)));
+        }
+
+        return State;
     }
 
-    return crcLocal;
+    constexpr int32 LongStride = 1024;
+    constexpr int32 ShortStride = 128;
+    constexpr FFoldConstants LongFold = MakeFoldConstants(LongStride);
+    constexpr FFoldConstants ShortFold = MakeFoldConstants(ShortStride);
+
+    void DetectX86(bool& bSSE42, bool& bPCLMUL)
+    {
+#if PLATFORM_WINDOWS
+        int CPUInfo[4] = { -1 };
+        __cpuid(CPUInfo, 1);
+        bSSE42 = (CPUInfo[2] & (1 << 20)) != 0;
+        bPCLMUL = (CPUInfo[2] & (1 << 1)) != 0;
 #else
-    return ComputeFallback(Data, Length, crcLocal);
+        bSSE42 = __builtin_cpu_supports("sse4.2");
+        bPCLMUL = __builtin_cpu_supports("pclmul");
+#endif
+    }
 #endif
 }
 
-uint32 FCRC32C::ComputeFallback(const uint8* Data, int32 Length, uint32 crcLocal)
+std::atomic<FCRC32C::FKernel> FCRC32C::Kernel{ &FCRC32C::ResolveAndUpdate };
+
+FCRC32C::FKernel FCRC32C::Resolve()
 {
-    int offset = 0;
-    int remaining = Length;
+#if CRC32C_X86
+    bool bSSE42 = false;
+    bool bPCLMUL = false;
+    DetectX86(bSSE42, bPCLMUL);
+
+    if (bSSE42)
+        return bPCLMUL ? &UpdateSSE42Interleaved : &UpdateSSE42;
+#elif CRC32C_ARM
+    return &UpdateARMCRC;
+#endif
 
-    while (remaining >= 16)
-    {
-        const uint8* current = Data + offset;
+    return &UpdateFallback;
+}
 
-        uint32 a = Table[(3 * 256) + current[12]]
-            ^ Table[(2 * 256) + current[13]]
-            ^ Table[(1 * 256) + current[14]]
-            ^ Table[(0 * 256) + current[15]];
+uint32 FCRC32C::ResolveAndUpdate(uint32 State, const uint8* Data, int32 Length)
+{
+    // Racing first calls resolve to the same kernel, whichever store lands last is as good as the other
+    const FKernel Resolved = Resolve();
+    Kernel.store(Resolved, std::memory_order_relaxed);
+    return Resolved(State, Data, Length);
+}
 
-        uint32 b = Table[(7 * 256) + current[8]]
-            ^ Table[(6 * 256) + current[9]]
-            ^ Table[(5 * 256) + current[10]]
-            ^ Table[(4 * 256) + current[11]];
+uint32 FCRC32C::UpdateSSE42(uint32 State, const uint8* Data, int32 Length)
+{
+#if CRC32C_X86
+    return UpdateBytesSSE42(State, Data, Length);
+#else
+    return UpdateFallback(State, Data, Length);
+#endif
+}
 
-        uint32 c = Table[(11 * 256) + current[4]]
-            ^ Table[(10 * 256) + current[5]]
-            ^ Table[(9 * 256) + current[6]]
-            ^ Table[(8 * 256) + current[7]];
+uint32 FCRC32C::UpdateSSE42Interleaved(uint32 State, const uint8* Data, int32 Length)
+{
+#if CRC32C_X86
+    // Packet-sized buffers never fill a round, skip straight to the single chain
+    if (Length < 3 * ShortStride)
+        return UpdateBytesSSE42(State, Data, Length);
+
+    uint64 State64 = State;
+    State64 = UpdateStreams(State64, Data, Length, LongStride, LongFold);
+    State64 = UpdateStreams(State64, Data, Length, ShortStride, ShortFold);
+    return UpdateBytesSSE42(static_cast<uint32>(State64), Data, Length);
+#else
+    return UpdateFallback(State, Data, Length);
+#endif
+}
 
-        uint32 d = Table[(15 * 256) + ((uint8)crcLocal ^ current[0])]
-            ^ Table[(14 * 256) + ((uint8)(crcLocal >> 8) ^ current[1])]
-            ^ Table[(13 * 256) + ((uint8)(crcLocal >> 16) ^ current[2])]
-            ^ Table[(12 * 256) + ((crcLocal >> 24) ^ current[3])];
+uint32 FCRC32C::UpdateARMCRC(uint32 State, const uint8* Data, int32 Length)
+{
+#if CRC32C_ARM
+    for (; Length >= 8; Data += 8, Length -= 8)
+        State = __crc32cd(State, Load64(Data));
 
-        crcLocal = d ^ c ^ b ^ a;
+    while (Length--)
+        State = __crc32cb(State, *Data++);
 
-        offset += 16;
-        remaining -= 16;
-    }
+    return State;
+#else
+    return UpdateFallback(State, Data, Length);
+#endif
+}
+
+uint32 FCRC32C::UpdateFallback(uint32 State, const uint8* Data, int32 Length)
+{
+    const uint32* T = Table.Entries;
 
-    while (remaining--)
+    for (; Length >= 16; Data += 16, Length -= 16)
     {
-        crcLocal = Table[(crcLocal ^ Data[offset++]) & 0xFF] ^ (crcLocal >> 8);
+        uint32 a = T[(3 * 256) + Data[12]]
+            ^ T[(2 * 256) + Data[13]]
+            ^ T[(1 * 256) + Data[14]]
+            ^ T[(0 * 256) + Data[15]];
+
+        uint32 b = T[(7 * 256) + Data[8]]
+            ^ T[(6 * 256) + Data[9]]
+            ^ T[(5 * 256) + Data[10]]
+            ^ T[(4 * 256) + Data[11]];
+
+        uint32 c = T[(11 * 256) + Data[4]]
+            ^ T[(10 * 256) + Data[5]]
+            ^ T[(9 * 256) + Data[6]]
+            ^ T[(8 * 256) + Data[7]];
+
+        uint32 d = T[(15 * 256) + ((uint8)State ^ Data[0])]
+            ^ T[(14 * 256) + ((uint8)(State >> 8) ^ Data[1])]
+            ^ T[(13 * 256) + ((uint8)(State >> 16) ^ Data[2])]
+            ^ T[(12 * 256) + ((State >> 24) ^ Data[3])];
+
+        State = d ^ c ^ b ^ a;
     }
 
-    return crcLocal;
+    while (Length--)
+        State = T[(State ^ *Data++) & 0xFF] ^ (State >> 8);
+
+    return State;
 }
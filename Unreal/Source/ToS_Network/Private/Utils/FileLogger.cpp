@@ -102,3 +102,10 @@ void ClientFileLogHex(const FString& Prefix, const TArray<uint8>& Data)
     FFileLogger::Get().LogHex(Prefix, Data);
 #endif
 }
+
+void ClientFileLogHex(const FString& Prefix, const uint8* Data, int32 Length)
+{
+#if !UE_BUILD_SHIPPING
+    FFileLogger::Get().LogHex(Prefix, TArray<uint8>(Data, Length));
+#endif
+}
@@ -22,188 +22,820 @@
  */
 
 #include "Utils/LZ4.h"
+#include "Utils/CRC32C.h"
+#include "Misc/FileHelper.h"
 #include <cstring>
 
-int32 FLZ4::Compress(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity)
+bool FLZ4Dictionary::Load(const uint8* InData, int32 Size)
 {
-    uint32 HashTable[HASH_SIZE] = {0};
-    const uint8* Ip = Src;
-    const uint8* Anchor = Ip;
-    const uint8* Iend = Src + SrcSize;
-    const uint8* Mflimit = Iend - MINMATCH;
-    uint8* Op = Dst;
-    uint8* Oend = Dst + DstCapacity;
+    Reset();
 
-    auto Hash = [](uint32 V) { return (V * 2654435761u) >> ((MINMATCH * 8) - HASH_LOG); };
+    if (!InData || Size < FLZ4::MINMATCH)
+        return false;
 
-    while (Ip < Mflimit)
+    if (Size > MaxSize)
+    {
+        InData += Size - MaxSize;
+        Size = MaxSize;
+    }
+
+    Data.SetNumUninitialized(Size);
+    FMemory::Memcpy(Data.GetData(), InData, Size);
+
+    // Later positions overwrite earlier ones, so lookups land on the closest, cheapest offset
+    HashTable.SetNumZeroed(FLZ4::HASH_SIZE);
+
+    for (int32 Position = 0; Position + FLZ4::MINMATCH <= Size; ++Position)
+        HashTable[FLZ4::Hash(*(const uint32*)(Data.GetData() + Position))] = (uint32)Position + 1;
+
+    Id = FCRC32C::Compute(Data.GetData(), Size);
+
+    if (Id == 0)
+        Id = 1;
+
+    return true;
+}
+
+bool FLZ4Dictionary::LoadFromFile(const FString& Path)
+{
+    TArray<uint8> Bytes;
+
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+    {
+        Reset();
+        return false;
+    }
+
+    return Load(Bytes.GetData(), Bytes.Num());
+}
+
+void FLZ4Dictionary::Reset()
+{
+    Data.Empty();
+    HashTable.Empty();
+    Id = 0;
+}
+
+void FLZ4CompressState::Reset()
+{
+    Origin = 1;
+
+    if (HashTable.Num() > 0)
+        FMemory::Memzero(HashTable.GetData(), HashTable.Num() * sizeof(uint32));
+}
+
+uint32 FLZ4CompressState::Begin(int32 Size, bool bChain)
+{
+    if (HashTable.Num() == 0)
+        HashTable.SetNumZeroed(FLZ4::HASH_SIZE);
+
+    // Chain entries are only followed from positions written during the same block, so stale ones need no clearing
+    if (bChain && ChainTable.Num() == 0)
+        ChainTable.SetNumUninitialized(0x10000);
+
+    if (Origin > MaxOrigin - (uint32)Size)
+        Reset();
+
+    const uint32 Base = Origin;
+    Origin += (uint32)Size;
+
+    return Base;
+}
+
+namespace
+{
+    FLZ4CompressState& GetThreadCompressState()
     {
-        uint32 Sequence = *(const uint32*)Ip;
-        int H = Hash(Sequence);
-        const uint8* Ref = Src + HashTable[H];
-        HashTable[H] = (uint32)(Ip - Src);
+        static thread_local FLZ4CompressState State;
+        return State;
+    }
+}
 
-        if (Ref < Ip && (Ip - Ref) < 0xFFFF && *(const uint32*)Ref == Sequence)
+int32 FLZ4::Compress(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, FLZ4Level Level)
+{
+    return CompressBlock(Src, SrcSize, Dst, DstCapacity, nullptr, GetThreadCompressState(), Level);
+}
+
+int32 FLZ4::Compress(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, FLZ4CompressState& State, FLZ4Level Level)
+{
+    return CompressBlock(Src, SrcSize, Dst, DstCapacity, nullptr, State, Level);
+}
+
+int32 FLZ4::Decompress(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity)
+{
+    return DecompressBlock(Src, SrcSize, Dst, DstCapacity, nullptr, 0);
+}
+
+int32 FLZ4::CompressWithDictionary(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, const FLZ4Dictionary& Dictionary, FLZ4Level Level)
+{
+    return CompressBlock(Src, SrcSize, Dst, DstCapacity, Dictionary.IsValid() ? &Dictionary : nullptr, GetThreadCompressState(), Level);
+}
+
+int32 FLZ4::CompressWithDictionary(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, const FLZ4Dictionary& Dictionary,
+                                   FLZ4CompressState& State, FLZ4Level Level)
+{
+    return CompressBlock(Src, SrcSize, Dst, DstCapacity, Dictionary.IsValid() ? &Dictionary : nullptr, State, Level);
+}
+
+int32 FLZ4::DecompressWithDictionary(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, const FLZ4Dictionary& Dictionary)
+{
+    if (!Dictionary.IsValid())
+        return DecompressBlock(Src, SrcSize, Dst, DstCapacity, nullptr, 0);
+
+    return DecompressBlock(Src, SrcSize, Dst, DstCapacity, Dictionary.GetData() + Dictionary.Num(), Dictionary.Num());
+}
+
+namespace
+{
+    // Block format end rules: the last 5 bytes are always literals and the last match starts at least
+    // 12 bytes before the end, which is what lets decoders copy in wide steps without checking every byte
+    constexpr int32 LASTLITERALS = 5;
+    constexpr int32 MFLIMIT = 12;
+
+    // Fast level: misses in a row before the search step grows by one
+    constexpr int32 SKIP_TRIGGER = 6;
+
+    // Offsets are 16 bits, one short of the full range like the dictionary size
+    constexpr int32 MAX_DISTANCE = 0xFFFF;
+
+    FORCEINLINE void WriteLength(uint8*& Op, int32 Length)
+    {
+        while (Length >= 255)
         {
-            uint8* Token = Op++;
-            int LiteralLength = (int)(Ip - Anchor);
+            *Op++ = 255;
+            Length -= 255;
+        }
 
-            if (Op + LiteralLength + 8 > Oend)
-                return 0;
+        *Op++ = (uint8)Length;
+    }
+
+    // Length of the common run at A and B, reading A no further than Limit
+    FORCEINLINE int32 Count(const uint8* A, const uint8* B, const uint8* Limit)
+    {
+        const uint8* const Start = A;
+
+        while (A + 8 <= Limit)
+        {
+            const uint64 Diff = *(const uint64*)A ^ *(const uint64*)B;
+
+            if (Diff != 0)
+                return (int32)(A - Start) + (int32)(FMath::CountTrailingZeros64(Diff) >> 3);
+
+            A += 8;
+            B += 8;
+        }
+
+        while (A < Limit && *A == *B)
+        {
+            ++A;
+            ++B;
+        }
+
+        return (int32)(A - Start);
+    }
+
+    // Token, literal run, offset and match length past MINMATCH; false when it would not fit before Oend
+    FORCEINLINE bool WriteSequence(uint8*& Op, const uint8* Oend, const uint8* Anchor, int32 LiteralLength, int32 Offset, int32 MatchLength)
+    {
+        if (Oend - Op < 1 + LiteralLength / 255 + 1 + LiteralLength + 2 + MatchLength / 255 + 1)
+            return false;
+
+        uint8* Token = Op++;
+        *Token = (uint8)(FMath::Min(LiteralLength, 15) << 4 | FMath::Min(MatchLength, 15));
+
+        if (LiteralLength >= 15)
+            WriteLength(Op, LiteralLength - 15);
+
+        FMemory::Memcpy(Op, Anchor, LiteralLength);
+        Op += LiteralLength;
+
+        *Op++ = (uint8)Offset;
+        *Op++ = (uint8)(Offset >> 8);
+
+        if (MatchLength >= 15)
+            WriteLength(Op, MatchLength - 15);
+
+        return true;
+    }
+
+    FORCEINLINE bool WriteLastLiterals(uint8*& Op, const uint8* Oend, const uint8* Anchor, int32 LiteralLength)
+    {
+        if (Oend - Op < 1 + LiteralLength / 255 + 1 + LiteralLength)
+            return false;
+
+        *Op++ = (uint8)(FMath::Min(LiteralLength, 15) << 4);
+
+        if (LiteralLength >= 15)
+            WriteLength(Op, LiteralLength - 15);
+
+        FMemory::Memcpy(Op, Anchor, LiteralLength);
+        Op += LiteralLength;
+
+        return true;
+    }
+}
 
-            if (LiteralLength >= 15)
+int32 FLZ4::CompressBlock(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, const FLZ4Dictionary* Dictionary,
+                          FLZ4CompressState& State, FLZ4Level Level)
+{
+    if (SrcSize < 0 || DstCapacity <= 0)
+        return 0;
+
+    return Level.IsHigh()
+        ? CompressHigh(Src, SrcSize, Dst, DstCapacity, Dictionary, State, Level.SearchDepth)
+        : CompressFast(Src, SrcSize, Dst, DstCapacity, Dictionary, State, FMath::Clamp(Level.Acceleration, 1, FLZ4Level::MaxAcceleration));
+}
+
+int32 FLZ4::CompressFast(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, const FLZ4Dictionary* Dictionary,
+                         FLZ4CompressState& State, int32 Acceleration)
+{
+    const uint8* Ip = Src;
+    const uint8* Anchor = Src;
+    const uint8* const Iend = Src + SrcSize;
+    uint8* Op = Dst;
+    const uint8* const Oend = Dst + DstCapacity;
+
+    if (SrcSize > MFLIMIT)
+    {
+        const uint8* const Mflimit = Iend - MFLIMIT;
+        const uint8* const Matchlimit = Iend - LASTLITERALS;
+        const uint32 Base = State.Begin(SrcSize, false);
+        uint32* const Table = State.HashTable.GetData();
+
+        const uint8* const DictBegin = Dictionary ? Dictionary->Data.GetData() : nullptr;
+        const uint32* const DictTable = Dictionary ? Dictionary->HashTable.GetData() : nullptr;
+        const int32 DictSize = Dictionary ? Dictionary->Data.Num() : 0;
+
+        int32 Search = Acceleration << SKIP_TRIGGER;
+
+        while (Ip <= Mflimit)
+        {
+            const uint32 Sequence = *(const uint32*)Ip;
+            const uint32 H = Hash(Sequence);
+            const uint32 Current = Base + (uint32)(Ip - Src);
+            const uint32 Entry = Table[H];
+            Table[H] = Current;
+
+            const uint8* Ref = nullptr;
+            const uint8* RefBegin = Src;
+            const uint8* Limit = Matchlimit;
+            int32 Offset = (int32)(Current - Entry);
+
+            // History from the block itself first, then the dictionary that logically precedes it
+            if (Entry >= Base && Offset < MAX_DISTANCE && *(const uint32*)(Src + (Entry - Base)) == Sequence)
+            {
+                Ref = Src + (Entry - Base);
+            }
+            else if (DictTable && DictTable[H] != 0)
             {
-                *Token = 15 << 4;
-                int Len = LiteralLength - 15;
+                const int32 DictPosition = (int32)DictTable[H] - 1;
+                Offset = (int32)(Ip - Src) + DictSize - DictPosition;
 
-                while (Len >= 255)
+                if (Offset < MAX_DISTANCE && *(const uint32*)(DictBegin + DictPosition) == Sequence)
                 {
-                    *Op++ = 255;
-                    Len -= 255;
+                    Ref = DictBegin + DictPosition;
+                    RefBegin = DictBegin;
+
+                    // A dictionary match stops at the end of the dictionary
+                    Limit = FMath::Min(Matchlimit, Ip + (DictSize - DictPosition));
                 }
+            }
 
-                *Op++ = (uint8)Len;
+            if (!Ref)
+            {
+                // The longer the literal run, the further each miss jumps
+                Ip += Search++ >> SKIP_TRIGGER;
+                continue;
             }
-            else
+
+            // Reclaim bytes the step jumped over that already belong to the match
+            while (Ip > Anchor && Ref > RefBegin && Ip[-1] == Ref[-1])
             {
-                *Token = (uint8)(LiteralLength << 4);
+                --Ip;
+                --Ref;
             }
 
-            FMemory::Memcpy(Op, Anchor, LiteralLength);
-            Op += LiteralLength;
+            const int32 MatchLength = MINMATCH + Count(Ip + MINMATCH, Ref + MINMATCH, Limit);
+
+            if (!WriteSequence(Op, Oend, Anchor, (int32)(Ip - Anchor), Offset, MatchLength - MINMATCH))
+                return 0;
+
+            Ip += MatchLength;
+            Anchor = Ip;
+            Search = Acceleration << SKIP_TRIGGER;
+
+            // Keeps a match right behind this one findable, the positions inside it were never hashed
+            Table[Hash(*(const uint32*)(Ip - 2))] = Base + (uint32)(Ip - 2 - Src);
+        }
+    }
+
+    if (!WriteLastLiterals(Op, Oend, Anchor, (int32)(Iend - Anchor)))
+        return 0;
+
+    return int32(Op - Dst);
+}
+
+int32 FLZ4::CompressHigh(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, const FLZ4Dictionary* Dictionary,
+                         FLZ4CompressState& State, int32 SearchDepth)
+{
+    const uint8* Ip = Src;
+    const uint8* Anchor = Src;
+    const uint8* const Iend = Src + SrcSize;
+    uint8* Op = Dst;
+    const uint8* const Oend = Dst + DstCapacity;
 
-            uint16 Offset = (uint16)(Ip - Ref);
-            *Op++ = (uint8)Offset;
-            *Op++ = (uint8)(Offset >> 8);
+    if (SrcSize > MFLIMIT)
+    {
+        const uint8* const Mflimit = Iend - MFLIMIT;
+        const uint8* const Matchlimit = Iend - LASTLITERALS;
+        const uint32 Base = State.Begin(SrcSize, true);
+        uint32* const Table = State.HashTable.GetData();
+        uint16* const Chain = State.ChainTable.GetData();
 
-            Ip += MINMATCH;
-            Ref += MINMATCH;
+        const uint8* const DictBegin = Dictionary ? Dictionary->Data.GetData() : nullptr;
+        const uint32* const DictTable = Dictionary ? Dictionary->HashTable.GetData() : nullptr;
+        const int32 DictSize = Dictionary ? Dictionary->Data.Num() : 0;
 
-            int MatchLength = 0;
+        const uint8* NextToInsert = Src;
 
-            while (Ip < Mflimit && *(const uint32*)Ip == *(const uint32*)Ref)
+        // Longest match for the sequence at At, 0 when there is none. Every position before At is linked
+        // into the chains first, so the search sees all of them and not only those the parse stopped on.
+        auto FindMatch = [&](const uint8* At, int32& OutOffset) -> int32
+        {
+            for (; NextToInsert < At; ++NextToInsert)
             {
-                Ip += 4;
-                Ref += 4;
-                MatchLength += 4;
+                const uint32 Position = Base + (uint32)(NextToInsert - Src);
+                const uint32 H = Hash(*(const uint32*)NextToInsert);
+
+                // Anything older than a full offset, including entries left over from earlier blocks, ends the chain
+                Chain[Position & 0xFFFF] = (uint16)FMath::Min<uint32>(Position - Table[H], MAX_DISTANCE);
+                Table[H] = Position;
             }
 
-            while (Ip < Iend && *Ip == *Ref)
+            const uint32 Sequence = *(const uint32*)At;
+            const uint32 H = Hash(Sequence);
+            const uint32 Current = Base + (uint32)(At - Src);
+            int32 BestLength = 0;
+
+            uint32 Candidate = Table[H];
+
+            for (int32 Attempts = SearchDepth; Attempts > 0 && Candidate >= Base && Current - Candidate < (uint32)MAX_DISTANCE; --Attempts)
             {
-                ++Ip;
-                ++Ref;
-                ++MatchLength;
+                const uint8* Ref = Src + (Candidate - Base);
+
+                // Only a candidate that also agrees at the current best length can beat it
+                if (Ref[BestLength] == At[BestLength] && *(const uint32*)Ref == Sequence)
+                {
+                    const int32 Length = MINMATCH + Count(At + MINMATCH, Ref + MINMATCH, Matchlimit);
+
+                    if (Length > BestLength)
+                    {
+                        BestLength = Length;
+                        OutOffset = (int32)(Current - Candidate);
+                    }
+                }
+
+                Candidate -= Chain[Candidate & 0xFFFF];
             }
 
-            if (MatchLength >= 15)
+            if (DictTable && DictTable[H] != 0)
             {
-                *Token |= 15;
-                int Len = MatchLength - 15;
-                while (Len >= 255)
+                const int32 DictPosition = (int32)DictTable[H] - 1;
+                const int32 Offset = (int32)(At - Src) + DictSize - DictPosition;
+                const uint8* Ref = DictBegin + DictPosition;
+
+                if (Offset < MAX_DISTANCE && *(const uint32*)Ref == Sequence)
                 {
-                    *Op++ = 255;
-                    Len -= 255;
+                    const uint8* Limit = FMath::Min(Matchlimit, At + (DictSize - DictPosition));
+                    const int32 Length = MINMATCH + Count(At + MINMATCH, Ref + MINMATCH, Limit);
+
+                    if (Length > BestLength)
+                    {
+                        BestLength = Length;
+                        OutOffset = Offset;
+                    }
                 }
-                *Op++ = (uint8)Len;
             }
-            else
+
+            return BestLength;
+        };
+
+        while (Ip <= Mflimit)
+        {
+            int32 Offset = 0;
+            int32 MatchLength = FindMatch(Ip, Offset);
+
+            if (MatchLength == 0)
             {
-                *Token |= (uint8)MatchLength;
+                ++Ip;
+                continue;
             }
 
-            Anchor = Ip;
+            // Lazy matching: a longer match starting one byte later is worth one more literal
+            while (Ip < Mflimit)
+            {
+                int32 NextOffset = 0;
+                const int32 NextLength = FindMatch(Ip + 1, NextOffset);
+
+                if (NextLength <= MatchLength)
+                    break;
 
-            if (Op > Oend - 5)
+                ++Ip;
+                MatchLength = NextLength;
+                Offset = NextOffset;
+            }
+
+            if (!WriteSequence(Op, Oend, Anchor, (int32)(Ip - Anchor), Offset, MatchLength - MINMATCH))
                 return 0;
 
-            continue;
+            Ip += MatchLength;
+            Anchor = Ip;
         }
-        ++Ip;
     }
 
-    int LastLit = (int)(Iend - Anchor);
-
-    if (Op + LastLit + (LastLit / 255) + 1 > Oend)
+    if (!WriteLastLiterals(Op, Oend, Anchor, (int32)(Iend - Anchor)))
         return 0;
 
-    if (LastLit >= 15)
+    return int32(Op - Dst);
+}
+
+namespace
+{
+    // Wild copies move 8 bytes at a time and may run up to 7 bytes past the requested end, so they
+    // are only used while that much room is left in both buffers; the tails fall back to exact copies
+    constexpr int32 WILDCOPY_LENGTH = 8;
+
+    FORCEINLINE void Copy8(uint8* Dst, const uint8* Src)
     {
-        *Op++ = 15 << 4;
-        int Len = LastLit - 15;
+        FMemory::Memcpy(Dst, Src, 8);
+    }
 
-        while (Len >= 255)
+    FORCEINLINE void WildCopy8(uint8* Dst, const uint8* Src, uint8* DstEnd)
+    {
+        do
         {
-            *Op++ = 255;
-            Len -= 255;
-        }
-
-        *Op++ = (uint8)Len;
+            Copy8(Dst, Src);
+            Dst += 8;
+            Src += 8;
+        } while (Dst < DstEnd);
     }
-    else
+
+    // Same with 16-byte steps: up to 15 bytes of overrun, and the source must trail by 16 or more
+    FORCEINLINE void WildCopy16(uint8* Dst, const uint8* Src, uint8* DstEnd)
     {
-        *Op++ = (uint8)(LastLit << 4);
+        do
+        {
+            FMemory::Memcpy(Dst, Src, 16);
+            Dst += 16;
+            Src += 16;
+        } while (Dst < DstEnd);
     }
 
-    FMemory::Memcpy(Op, Anchor, LastLit);
-    Op += LastLit;
+    // Extended length bytes: 255 means another byte follows. Fails when the input ends first or
+    // the length grows past Limit, which also keeps it from overflowing.
+    FORCEINLINE bool ReadLength(const uint8*& Ip, const uint8* Iend, int32 Limit, int32& Length)
+    {
+        uint32 S;
 
-    return int32(Op - Dst);
+        do
+        {
+            if (Ip >= Iend)
+                return false;
+
+            S = *Ip++;
+            Length += S;
+
+            if (Length > Limit)
+                return false;
+        } while (S == 255);
+
+        return true;
+    }
 }
 
-int32 FLZ4::Decompress(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity)
+int32 FLZ4::DecompressBlock(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, const uint8* DictEnd, int32 DictSize)
 {
+    // Input comes off the network: every length and offset is validated before it is used
+    static constexpr int32 IncrementTable[8] = { 0, 1, 2, 1, 0, 4, 4, 4 };
+    static constexpr int32 DecrementTable[8] = { 0, 0, 0, -1, -4, 1, 2, 3 };
+
     const uint8* Ip = Src;
-    const uint8* Iend = Src + SrcSize;
+    const uint8* const Iend = Src + SrcSize;
     uint8* Op = Dst;
-    uint8* Oend = Dst + DstCapacity;
+    uint8* const Oend = Dst + DstCapacity;
 
     while (Ip < Iend)
     {
-        uint8 Token = *Ip++;
-        int LiteralLength = Token >> 4;
+        const uint32 Token = *Ip++;
+
+        int32 LiteralLength = Token >> 4;
 
-        if (LiteralLength == 15)
+        if (LiteralLength != 15 && Iend - Ip >= 16 && Oend - Op >= 16)
         {
-            uint8 S;
-            while (((S = *Ip++) == 255) && Ip < Iend)
-                LiteralLength += 255;
-            LiteralLength += S;
+            // Short literal run well inside both buffers: one fixed 16-byte copy, and with at least
+            // 2 input bytes left over this cannot be the last sequence
+            Copy8(Op, Ip);
+            Copy8(Op + 8, Ip + 8);
+            Ip += LiteralLength;
+            Op += LiteralLength;
         }
+        else
+        {
+            if (LiteralLength == 15 && !ReadLength(Ip, Iend, (int32)(Oend - Op), LiteralLength))
+                return 0;
 
-        if (Op + LiteralLength > Oend || Ip + LiteralLength > Iend)
-            return 0;
+            if (LiteralLength > Iend - Ip || LiteralLength > Oend - Op)
+                return 0;
 
-        FMemory::Memcpy(Op, Ip, LiteralLength);
-        Ip += LiteralLength;
-        Op += LiteralLength;
+            if (LiteralLength <= (Iend - Ip) - 2 * WILDCOPY_LENGTH && LiteralLength <= (Oend - Op) - 2 * WILDCOPY_LENGTH)
+                WildCopy16(Op, Ip, Op + LiteralLength);
+            else if (LiteralLength <= (Iend - Ip) - WILDCOPY_LENGTH && LiteralLength <= (Oend - Op) - WILDCOPY_LENGTH)
+                WildCopy8(Op, Ip, Op + LiteralLength);
+            else
+                FMemory::Memcpy(Op, Ip, LiteralLength);
 
-        if (Ip >= Iend)
-            break;
+            Ip += LiteralLength;
+            Op += LiteralLength;
 
-        uint16 Offset = (uint16)(Ip[0] | (Ip[1] << 8));
+            // The last sequence carries literals only
+            if (Ip >= Iend)
+                break;
+
+            if (Iend - Ip < 2)
+                return 0;
+        }
+
+        const int32 Offset = Ip[0] | (Ip[1] << 8);
         Ip += 2;
-        uint8* Match = Op - Offset;
 
-        int MatchLength = Token & 0x0F;
+        int32 MatchLength = Token & 0x0F;
 
-        if (MatchLength == 15)
+        if (MatchLength != 15 && Offset >= 8 && Offset <= Op - Dst && Oend - Op >= 18)
         {
-            uint8 S;
-            while (((S = *Ip++) == 255) && Ip < Iend)
-                MatchLength += 255;
-            MatchLength += S;
+            // Short match that neither overlaps its own first 8 bytes nor reaches into the dictionary:
+            // a fixed 18-byte copy covers every length the token can hold
+            const uint8* Match = Op - Offset;
+            Copy8(Op, Match);
+            Copy8(Op + 8, Match + 8);
+            FMemory::Memcpy(Op + 16, Match + 16, 2);
+            Op += MatchLength + MINMATCH;
+            continue;
         }
 
-        MatchLength += 4;
+        if (MatchLength == 15 && !ReadLength(Ip, Iend, (int32)(Oend - Op), MatchLength))
+            return 0;
+
+        MatchLength += MINMATCH;
+
+        if (MatchLength > Oend - Op)
+            return 0;
+
+        // The offset may reach back past the start of the output, into the dictionary
+        const int32 Produced = (int32)(Op - Dst);
 
-        if (Op + MatchLength > Oend)
+        if (Offset == 0 || Offset > Produced + DictSize)
             return 0;
 
-        while (MatchLength--)
+        if (Offset > Produced)
+        {
+            const int32 Back = Offset - Produced;
+            const int32 FromDictionary = FMath::Min(Back, MatchLength);
+
+            FMemory::Memcpy(Op, DictEnd - Back, FromDictionary);
+            Op += FromDictionary;
+            MatchLength -= FromDictionary;
+
+            // Whatever is left continues from the start of the output, still Offset behind Op
+            if (MatchLength == 0)
+                continue;
+        }
+
+        const uint8* Match = Op - Offset;
+        uint8* const Cend = Op + MatchLength;
+
+        if (Cend > Oend - WILDCOPY_LENGTH)
+        {
+            // Too close to the end for wild copies, byte by byte keeps overlapping matches right
+            while (Op < Cend)
+                *Op++ = *Match++;
+
+            continue;
+        }
+
+        if (Offset < 8)
+        {
+            // Overlapping match: the first 8 bytes are expanded by hand, after which the source trails
+            // the output by 8 bytes or more and the rest can be copied 8 at a time
+            Op[0] = Match[0];
+            Op[1] = Match[1];
+            Op[2] = Match[2];
+            Op[3] = Match[3];
+            Match += IncrementTable[Offset];
+            FMemory::Memcpy(Op + 4, Match, 4);
+            Match -= DecrementTable[Offset];
+            Op += 8;
+        }
+        else
+        {
+            Copy8(Op, Match);
+            Op += 8;
+            Match += 8;
+        }
+
+        if (Op < Cend)
+        {
+            if (Op - Match >= 16 && Cend <= Oend - 2 * WILDCOPY_LENGTH)
+                WildCopy16(Op, Match, Cend);
+            else
+                WildCopy8(Op, Match, Cend);
+        }
+
+        Op = Cend;
+    }
+
+    return int32(Op - Dst);
+}
+
+void FLZ4Stream::Reset()
+{
+    Position = 0;
+
+    if (HashTable.Num() > 0)
+        FMemory::Memzero(HashTable.GetData(), HashTable.Num() * sizeof(uint32));
+}
+
+void FLZ4Stream::Allocate(bool bEncoder)
+{
+    if (Buffer.Num() == 0)
+    {
+        Buffer.SetNumUninitialized(HistorySize + MaxMessageSize);
+        Allocations++;
+    }
+
+    if (bEncoder && HashTable.Num() == 0)
+    {
+        HashTable.SetNumZeroed(HASH_SIZE);
+        Allocations++;
+    }
+}
+
+uint8* FLZ4Stream::Reserve(int32 Size)
+{
+    if (Buffer.Num() == 0)
+        Allocate(false);
+
+    if (Position + Size > Buffer.Num())
+    {
+        const int32 Keep = FMath::Min(Position, HistorySize);
+        const uint32 Delta = (uint32)(Position - Keep);
+
+        FMemory::Memmove(Buffer.GetData(), Buffer.GetData() + Delta, Keep);
+        Position = Keep;
+
+        // Rebase the encoder's positions, whatever slid out of the buffer is forgotten
+        for (uint32& Entry : HashTable)
+            Entry = Entry > Delta ? Entry - Delta : 0;
+    }
+
+    return Buffer.GetData() + Position;
+}
+
+int32 FLZ4Stream::Compress(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity)
+{
+    if (SrcSize < 0 || SrcSize > MaxMessageSize)
+        return 0;
+
+    if (HashTable.Num() == 0)
+        Allocate(true);
+
+    // The message goes right behind the history, so matching earlier messages and matching itself are the same
+    uint8* Message = Reserve(SrcSize);
+    FMemory::Memcpy(Message, Src, SrcSize);
+    Position += SrcSize;
+
+    const uint8* Base = Buffer.GetData();
+    const uint8* Ip = Message;
+    const uint8* Anchor = Ip;
+    const uint8* Iend = Message + SrcSize;
+    const uint8* Mflimit = Iend - FLZ4::MINMATCH;
+    uint8* Op = Dst;
+    uint8* Oend = Dst + DstCapacity;
+    uint32* Table = HashTable.GetData();
+
+    while (Ip < Mflimit)
+    {
+        const uint32 Sequence = *(const uint32*)Ip;
+        const uint32 H = Hash(Sequence);
+        const uint32 Entry = Table[H];
+        Table[H] = (uint32)(Ip - Base) + 1;
+
+        if (Entry == 0)
+        {
+            ++Ip;
+            continue;
+        }
+
+        const uint8* Ref = Base + (Entry - 1);
+        const int32 Offset = (int32)(Ip - Ref);
+
+        if (Offset >= 0xFFFF || *(const uint32*)Ref != Sequence)
+        {
+            ++Ip;
+            continue;
+        }
+
+        const int32 LiteralLength = (int32)(Ip - Anchor);
+        const uint8* MatchStart = Ip;
+
+        Ip += FLZ4::MINMATCH;
+        Ref += FLZ4::MINMATCH;
+
+        while (Ip < Mflimit && *(const uint32*)Ip == *(const uint32*)Ref)
         {
-            *Op++ = *Match++;
+            Ip += 4;
+            Ref += 4;
         }
+
+        while (Ip < Iend && *Ip == *Ref)
+        {
+            ++Ip;
+            ++Ref;
+        }
+
+        const int32 MatchLength = (int32)(Ip - MatchStart) - FLZ4::MINMATCH;
+
+        // Token, both length extensions, literals and offset
+        if (Op + 1 + LiteralLength / 255 + 1 + LiteralLength + 2 + MatchLength / 255 + 1 > Oend)
+            return 0;
+
+        uint8* Token = Op++;
+        *Token = (uint8)(FMath::Min(LiteralLength, 15) << 4 | FMath::Min(MatchLength, 15));
+
+        if (LiteralLength >= 15)
+            WriteLength(Op, LiteralLength - 15);
+
+        FMemory::Memcpy(Op, Anchor, LiteralLength);
+        Op += LiteralLength;
+
+        *Op++ = (uint8)Offset;
+        *Op++ = (uint8)(Offset >> 8);
+
+        if (MatchLength >= 15)
+            WriteLength(Op, MatchLength - 15);
+
+        Anchor = Ip;
     }
 
+    const int32 LastLit = (int32)(Iend - Anchor);
+
+    if (Op + 1 + LastLit / 255 + 1 + LastLit > Oend)
+        return 0;
+
+    *Op++ = (uint8)(FMath::Min(LastLit, 15) << 4);
+
+    if (LastLit >= 15)
+        WriteLength(Op, LastLit - 15);
+
+    FMemory::Memcpy(Op, Anchor, LastLit);
+    Op += LastLit;
+
     return int32(Op - Dst);
 }
+
+int32 FLZ4Stream::Decompress(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity)
+{
+    const int32 Capacity = FMath::Min(DstCapacity, MaxMessageSize);
+    uint8* Message = Reserve(Capacity);
+
+    // Earlier messages sit right in front of the output, the block decoder reads them as its dictionary
+    const int32 Length = FLZ4::DecompressBlock(Src, SrcSize, Message, Capacity, Message, Position);
+
+    if (Length <= 0)
+        return 0;
+
+    FMemory::Memcpy(Dst, Message, Length);
+    Position += Length;
+
+    return Length;
+}
+
+const uint8* FLZ4Stream::Decompress(const uint8* Src, int32 SrcSize, int32& OutLength)
+{
+    uint8* Message = Reserve(MaxMessageSize);
+    OutLength = FLZ4::DecompressBlock(Src, SrcSize, Message, MaxMessageSize, Message, Position);
+
+    if (OutLength <= 0)
+        return nullptr;
+
+    Position += OutLength;
+    return Message;
+}
+
+void FLZ4Stream::Append(const uint8* Data, int32 Size)
+{
+    if (Size <= 0 || Size > MaxMessageSize)
+        return;
+
+    FMemory::Memcpy(Reserve(Size), Data, Size);
+    Position += Size;
+}
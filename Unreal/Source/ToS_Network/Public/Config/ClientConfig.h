@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
+#include "Enum/NetLatencyMode.h"
+#include "Enum/CongestionControl.h"
 #include "ClientConfig.generated.h"
 
 USTRUCT(BlueprintType)
@@ -26,6 +28,10 @@ struct FNetworkClientConfig
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network", meta = (DisplayName = "Enable Retry"))
     bool bEnableRetry = true;
+
+    // A broken path rebinds a new local socket and keeps the session instead of disconnecting
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Network", meta = (DisplayName = "Enable Connection Migration"))
+    bool bEnableConnectionMigration = true;
 };
 
 USTRUCT(BlueprintType)
@@ -45,6 +51,34 @@ struct FSecurityClientConfig
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Compression Threshold (bytes)"))
     int32 CompressionThreshold = 512;
 
+    // Higher values trade ratio for speed on packets that turn out incompressible
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Compression Acceleration"))
+    int32 CompressionAcceleration = 1;
+
+    // Reliable payloads this large use the slower, denser LZ4 level, 0 disables it
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "High Compression Threshold (bytes)"))
+    int32 HighCompressionThreshold = 1024;
+
+    // Trained from captured traffic and shipped with both peers, relative paths resolve against Content
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Compression Dictionary (path)"))
+    FString CompressionDictionaryPath = TEXT("");
+
+    // Reliable messages are compressed against the earlier messages of their stream
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Enable Stream Compression"))
+    bool bEnableStreamCompression = true;
+
+    // Offers the server to drop the CRC32C trailer on encrypted packets, the AEAD tag already covers them
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Omit AEAD Checksum"))
+    bool bOmitAEADChecksum = false;
+
+    // Offers AES-256-GCM in place of ChaCha20-Poly1305, only ever sent when the CPU has AES-NI
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Enable AES-256-GCM"))
+    bool bEnableAES256GCM = true;
+
+    // Reconnects present the ticket from the last session and skip the key exchange when the server takes it
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Enable Session Resumption"))
+    bool bEnableSessionResumption = true;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Server Password"))
     FString ServerPassword = TEXT("");
 
@@ -71,6 +105,27 @@ struct FPerformanceClientConfig
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Max Retries"))
     int32 MaxRetries = 10;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Network Thread Latency Mode"))
+    ENetLatencyMode LatencyMode = ENetLatencyMode::Park;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Spin Wait (microseconds)"))
+    int32 SpinWaitMicroseconds = 50;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Enable Batched I/O (Linux)"))
+    bool bEnableBatchedIO = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Coalesce Outgoing Messages"))
+    bool bEnableCoalescing = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Outgoing Flush Interval (ms)"))
+    float FlushIntervalMs = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Congestion Control"))
+    ECongestionControl CongestionControl = ECongestionControl::NewReno;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Enable Send Pacing"))
+    bool bEnablePacing = true;
 };
 
 USTRUCT(BlueprintType)
@@ -48,6 +48,27 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Compression Threshold (bytes)"))
     int32 CompressionThreshold = 512;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Compression Acceleration"))
+    int32 CompressionAcceleration = 1;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "High Compression Threshold (bytes)"))
+    int32 HighCompressionThreshold = 1024;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Compression Dictionary (path)"))
+    FString CompressionDictionaryPath = TEXT("");
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Enable Stream Compression"))
+    bool bEnableStreamCompression = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Omit AEAD Checksum"))
+    bool bOmitAEADChecksum = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Enable AES-256-GCM"))
+    bool bEnableAES256GCM = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Enable Session Resumption"))
+    bool bEnableSessionResumption = true;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Security", meta = (DisplayName = "Server Password"))
     FString ServerPassword = TEXT("");
 
@@ -64,6 +85,27 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Max Retries"))
     int32 MaxRetries = 10;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Network Thread Latency Mode"))
+    ENetLatencyMode NetLatencyMode = ENetLatencyMode::Park;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Spin Wait (microseconds)"))
+    int32 SpinWaitMicroseconds = 50;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Enable Batched I/O (Linux)"))
+    bool bEnableBatchedIO = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Coalesce Outgoing Messages"))
+    bool bEnableCoalescing = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Outgoing Flush Interval (ms)"))
+    float FlushIntervalMs = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Congestion Control"))
+    ECongestionControl CongestionControl = ECongestionControl::NewReno;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance", meta = (DisplayName = "Enable Send Pacing"))
+    bool bEnablePacing = true;
+
     // === LOGGING CONFIGURATION ===
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Logging", meta = (DisplayName = "Enable Debug Logs"))
     bool bEnableDebugLogs = false;
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CongestionControl.generated.h"
+
+/**
+ * Congestion controller driving the reliable send window and the pacer.
+ * Off sends everything as soon as it is queued, as before.
+ */
+UENUM(BlueprintType)
+enum class ECongestionControl : uint8
+{
+    Off     UMETA(DisplayName = "Off"),
+    NewReno UMETA(DisplayName = "NewReno"),
+    Cubic   UMETA(DisplayName = "Cubic")
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NetLatencyMode.generated.h"
+
+/**
+ * How the network thread waits between polls.
+ * Park blocks on socket readiness until the next timer deadline (idle ~0% CPU),
+ * SpinThenPark polls for a short window before parking, BusyPoll never sleeps.
+ */
+UENUM(BlueprintType)
+enum class ENetLatencyMode : uint8
+{
+    Park         UMETA(DisplayName = "Park"),
+    SpinThenPark UMETA(DisplayName = "Spin Then Park"),
+    BusyPoll     UMETA(DisplayName = "Busy Poll")
+};
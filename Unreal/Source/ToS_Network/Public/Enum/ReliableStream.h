@@ -0,0 +1,19 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReliableStream.generated.h"
+
+/**
+ * Independently ordered reliable streams. Each one has its own sequence space and reorder
+ * window, so a message lost on one stream never holds back delivery on another.
+ * Packets declare their stream in the contract; the values must match the server's ReliableStream.
+ */
+UENUM(BlueprintType)
+enum class EReliableStream : uint8
+{
+    Default   UMETA(DisplayName = "Default"),
+    World     UMETA(DisplayName = "World"),
+    Chat      UMETA(DisplayName = "Chat"),
+    Inventory UMETA(DisplayName = "Inventory"),
+    Count     UMETA(Hidden)
+};
@@ -0,0 +1,243 @@
+/*
+ * CongestionController.h
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Enum/CongestionControl.h"
+#include "Network/RttEstimator.h"
+#include "CongestionController.generated.h"
+
+/**
+ * Snapshot of the link as the congestion controller sees it, for gameplay code that wants to
+ * lower its update rate before the network chokes.
+ */
+USTRUCT(BlueprintType)
+struct FNetCongestionStats
+{
+    GENERATED_USTRUCT_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "UDP")
+    float RoundTripTimeMs = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "UDP")
+    float RoundTripVarianceMs = 0.0f;
+
+    // Smoothed fraction of reliable packets declared lost, 0..1
+    UPROPERTY(BlueprintReadOnly, Category = "UDP")
+    float LossRate = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "UDP")
+    int32 CongestionWindowBytes = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "UDP")
+    int32 BytesInFlight = 0;
+
+    // Bytes per second the pacer releases, 0 when pacing is off
+    UPROPERTY(BlueprintReadOnly, Category = "UDP")
+    float PacingRate = 0.0f;
+
+    // Reliable messages held back because the congestion window is full
+    UPROPERTY(BlueprintReadOnly, Category = "UDP")
+    int32 QueuedReliableMessages = 0;
+
+    // Unreliable datagrams dropped because the pacing queue was full
+    UPROPERTY(BlueprintReadOnly, Category = "UDP")
+    int32 PacingDrops = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "UDP")
+    bool bSlowStart = false;
+};
+
+/**
+ * Window-based congestion control for outbound traffic. The owner reports every reliable send,
+ * ACK and loss; the controller answers how many bytes may be unacknowledged and how fast the pacer
+ * releases datagrams. Loss-based controllers derive the pacing rate from cwnd / SRTT; a rate-based
+ * (BBR-like) controller overrides GetPacingRate and builds its bandwidth and min-RTT model from the
+ * per-ACK delivery samples. Not thread-safe: the owner serializes access.
+ */
+class TOS_NETWORK_API ICongestionController
+{
+public:
+    virtual ~ICongestionController() = default;
+
+    virtual void Reset(int32 InMaxDatagramSize) = 0;
+    virtual void OnPacketSent(double Now, int32 Bytes, int64 BytesInFlight) {}
+
+    // SentTime is the last transmission of the acknowledged packet
+    virtual void OnPacketAcked(double Now, int32 Bytes, double SentTime, const FRttEstimator& Rtt) = 0;
+
+    // bTimeout for retransmission timeouts, false for losses inferred from selective ACKs
+    virtual void OnPacketLost(double Now, int32 Bytes, double SentTime, bool bTimeout) = 0;
+
+    virtual int64 GetCongestionWindow() const = 0;
+    virtual bool InSlowStart() const = 0;
+    virtual double GetPacingRate(const FRttEstimator& Rtt) const;
+
+    static TUniquePtr<ICongestionController> Create(ECongestionControl Algorithm, int32 MaxDatagramSize);
+};
+
+/**
+ * Slow start and one window reduction per loss event: losses of packets sent before the
+ * current recovery period started belong to the same event and are ignored.
+ */
+class TOS_NETWORK_API FLossBasedCongestionController : public ICongestionController
+{
+public:
+    static constexpr int32 InitialWindowPackets = 10;
+    static constexpr int32 MinWindowPackets = 2;
+    static constexpr double SlowStartPacingGain = 2.0;
+    static constexpr double PacingGain = 1.25;
+
+    virtual void Reset(int32 InMaxDatagramSize) override;
+    virtual void OnPacketAcked(double Now, int32 Bytes, double SentTime, const FRttEstimator& Rtt) override;
+    virtual void OnPacketLost(double Now, int32 Bytes, double SentTime, bool bTimeout) override;
+
+    virtual int64 GetCongestionWindow() const override { return static_cast<int64>(Window); }
+    virtual bool InSlowStart() const override { return Window < SlowStartThreshold; }
+    virtual double GetPacingRate(const FRttEstimator& Rtt) const override;
+
+protected:
+    virtual void OnCongestionAvoidance(double Now, int32 Bytes, const FRttEstimator& Rtt) = 0;
+    virtual void OnCongestionEvent(double Now) = 0;
+
+    FORCEINLINE double GetMinWindow() const { return static_cast<double>(MinWindowPackets) * MaxDatagramSize; }
+
+    double Window = 0.0;
+    double SlowStartThreshold = TNumericLimits<double>::Max();
+    double RecoveryStart = -1.0;
+    int32 MaxDatagramSize = 1200;
+};
+
+// Additive increase of one datagram per round trip, halves the window on loss
+class TOS_NETWORK_API FNewRenoCongestionController : public FLossBasedCongestionController
+{
+protected:
+    virtual void OnCongestionAvoidance(double Now, int32 Bytes, const FRttEstimator& Rtt) override;
+    virtual void OnCongestionEvent(double Now) override;
+};
+
+// RFC 8312: cubic growth around the last saturation point, never slower than Reno
+class TOS_NETWORK_API FCubicCongestionController : public FLossBasedCongestionController
+{
+public:
+    static constexpr double C = 0.4;
+    static constexpr double Beta = 0.7;
+
+    virtual void Reset(int32 InMaxDatagramSize) override;
+
+protected:
+    virtual void OnCongestionAvoidance(double Now, int32 Bytes, const FRttEstimator& Rtt) override;
+    virtual void OnCongestionEvent(double Now) override;
+
+private:
+    double WindowMax = 0.0;
+    double LastWindowMax = 0.0;
+    double EpochStart = -1.0;
+    double EpochOrigin = 0.0;
+    double K = 0.0;
+    double RenoWindow = 0.0;
+};
+
+/**
+ * Token bucket releasing at most Rate bytes per second with a burst of a couple of datagrams
+ * (or one millisecond of rate, whichever is larger), so a frame's worth of sends is spread over
+ * the frame instead of leaving in one clump. A zero rate disables pacing.
+ */
+struct FSendPacer
+{
+    static constexpr int32 MinBurstDatagrams = 2;
+    static constexpr double BurstInterval = 0.001;
+
+    FORCEINLINE void Reset(double Now)
+    {
+        Tokens = Burst;
+        LastRefill = Now;
+    }
+
+    FORCEINLINE void SetRate(double BytesPerSecond, int32 MaxDatagramSize)
+    {
+        Rate = BytesPerSecond;
+        Burst = FMath::Max(static_cast<double>(MinBurstDatagrams) * MaxDatagramSize, Rate * BurstInterval);
+        Tokens = FMath::Min(Tokens, Burst);
+    }
+
+    FORCEINLINE bool TryConsume(double Now, int32 Bytes)
+    {
+        if (Rate <= 0.0)
+            return true;
+
+        Tokens = FMath::Min(Burst, Tokens + (Now - LastRefill) * Rate);
+        LastRefill = Now;
+
+        if (Tokens < Bytes)
+            return false;
+
+        Tokens -= Bytes;
+        return true;
+    }
+
+    // When Bytes worth of tokens will have accumulated
+    FORCEINLINE double GetReadyTime(double Now, int32 Bytes) const
+    {
+        if (Rate <= 0.0)
+            return Now;
+
+        const double Available = FMath::Min(Burst, Tokens + (Now - LastRefill) * Rate);
+        return Available >= Bytes ? Now : Now + (Bytes - Available) / Rate;
+    }
+
+    FORCEINLINE double GetRate() const { return Rate; }
+
+private:
+    double Rate = 0.0;
+    double Burst = 0.0;
+    double Tokens = 0.0;
+    double LastRefill = 0.0;
+};
+
+/**
+ * FIFO of length-prefixed byte records in one reusable allocation, for datagrams waiting on the
+ * pacer and reliable messages waiting on the congestion window. Not thread-safe.
+ */
+class TOS_NETWORK_API FByteRecordQueue
+{
+public:
+    void Push(const uint8* Data, int32 Length, uint8 Tag = 0);
+
+    // Front record, false when empty
+    bool Peek(const uint8*& OutData, int32& OutLength, uint8* OutTag = nullptr) const;
+    void Pop();
+    void Reset();
+
+    FORCEINLINE bool IsEmpty() const { return Count == 0; }
+    FORCEINLINE int32 Num() const { return Count; }
+    FORCEINLINE int32 GetQueuedBytes() const { return Storage.Num() - Head; }
+
+private:
+    static constexpr int32 RecordHeaderSize = sizeof(int32) + 1;
+
+    TArray<uint8> Storage;
+    int32 Head = 0;
+    int32 Count = 0;
+};
@@ -0,0 +1,601 @@
+/*
+ * FlatBuffer.h
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Header-only serialization core shared by the native network code and UFlatBuffer.
+// Define TOS_FLATBUFFER_STANDALONE to build it outside the engine (tests, benchmarks).
+
+#ifdef TOS_FLATBUFFER_STANDALONE
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+typedef std::uint8_t  uint8;
+typedef std::uint16_t uint16;
+typedef std::uint32_t uint32;
+typedef std::uint64_t uint64;
+typedef std::int8_t   int8;
+typedef std::int16_t  int16;
+typedef std::int32_t  int32;
+typedef std::int64_t  int64;
+
+#ifndef FORCEINLINE
+#define FORCEINLINE inline
+#endif
+
+#define FLATBUFFER_MEMCPY(Dest, Src, Size) std::memcpy(Dest, Src, Size)
+#define FLATBUFFER_MALLOC(Size) std::malloc(Size)
+#define FLATBUFFER_FREE(Ptr) std::free(Ptr)
+#else
+#include "CoreMinimal.h"
+#include <type_traits>
+
+#define FLATBUFFER_MEMCPY(Dest, Src, Size) FMemory::Memcpy(Dest, Src, Size)
+#define FLATBUFFER_MALLOC(Size) FMemory::Malloc(Size)
+#define FLATBUFFER_FREE(Ptr) FMemory::Free(Ptr)
+#endif
+
+/**
+ * Non-owning read/write cursor over a byte range. Holds all of the
+ * read/write/varint/bit logic; overflow never logs, it only raises a flag
+ * that callers check once with HasOverflowed().
+ */
+class FFlatBufferView
+{
+public:
+    FFlatBufferView() = default;
+
+    FFlatBufferView(uint8* InData, int32 InCapacity, int32 InPosition = 0)
+        : Data(InData), Capacity(InCapacity), Position(InPosition) {}
+
+    template<typename T>
+    FORCEINLINE void Write(const T& Value)
+    {
+        static_assert(std::is_trivial_v<T>, "Type must be trivial for unsafe operations");
+
+        constexpr int32 Size = sizeof(T);
+
+        if (Position + Size > Capacity)
+        {
+            bOverflow = true;
+            return;
+        }
+
+        FLATBUFFER_MEMCPY(Data + Position, &Value, Size);
+        Position += Size;
+    }
+
+    template<typename T>
+    FORCEINLINE T Read()
+    {
+        static_assert(std::is_trivial_v<T>, "Type must be trivial for unsafe operations");
+
+        constexpr int32 Size = sizeof(T);
+
+        if (Position + Size > Capacity)
+        {
+            bOverflow = true;
+            return T{};
+        }
+
+        T Value;
+        FLATBUFFER_MEMCPY(&Value, Data + Position, Size);
+        Position += Size;
+        return Value;
+    }
+
+    template<typename T>
+    FORCEINLINE T Peek() const
+    {
+        static_assert(std::is_trivial_v<T>, "Type must be trivial");
+
+        constexpr int32 Size = sizeof(T);
+
+        if (Position + Size > Capacity)
+            return T{};
+
+        T Value;
+        FLATBUFFER_MEMCPY(&Value, Data + Position, Size);
+        return Value;
+    }
+
+    FORCEINLINE void WriteByte(uint8 Value) { Write<uint8>(Value); }
+    FORCEINLINE void WriteUInt16(uint16 Value) { Write<uint16>(Value); }
+    FORCEINLINE void WriteInt16(int16 Value) { Write<int16>(Value); }
+    FORCEINLINE void WriteInt32(int32 Value) { Write<int32>(Value); }
+    FORCEINLINE void WriteUInt32(uint32 Value) { Write<uint32>(Value); }
+    FORCEINLINE void WriteInt64(int64 Value) { Write<int64>(Value); }
+    FORCEINLINE void WriteFloat(float Value) { Write<float>(Value); }
+    FORCEINLINE void WriteBool(bool Value) { Write<uint8>(Value ? 1 : 0); }
+
+    FORCEINLINE uint8 ReadByte() { return Read<uint8>(); }
+    FORCEINLINE uint16 ReadUInt16() { return Read<uint16>(); }
+    FORCEINLINE int16 ReadInt16() { return Read<int16>(); }
+    FORCEINLINE int32 ReadInt32() { return Read<int32>(); }
+    FORCEINLINE uint32 ReadUInt32() { return Read<uint32>(); }
+    FORCEINLINE int64 ReadInt64() { return Read<int64>(); }
+    FORCEINLINE float ReadFloat() { return Read<float>(); }
+    FORCEINLINE bool ReadBool() { return Read<uint8>() != 0; }
+
+    FORCEINLINE void WriteVarUInt(uint32 Value)
+    {
+        while (Value >= 0x80)
+        {
+            Write<uint8>(static_cast<uint8>(Value | 0x80));
+            Value >>= 7;
+        }
+
+        Write<uint8>(static_cast<uint8>(Value));
+    }
+
+    FORCEINLINE void WriteVarULong(uint64 Value)
+    {
+        while (Value >= 0x80)
+        {
+            Write<uint8>(static_cast<uint8>(Value | 0x80));
+            Value >>= 7;
+        }
+
+        Write<uint8>(static_cast<uint8>(Value));
+    }
+
+    FORCEINLINE void WriteVarInt(int32 Value) { WriteVarUInt(EncodeZigZag32(Value)); }
+    FORCEINLINE void WriteVarLong(int64 Value) { WriteVarULong(EncodeZigZag64(Value)); }
+
+    FORCEINLINE uint32 ReadVarUInt()
+    {
+        int32 Shift = 0;
+        uint32 Result = 0;
+
+        while (true)
+        {
+            if (Position >= Capacity)
+            {
+                bOverflow = true;
+                return 0;
+            }
+
+            uint8 B = Data[Position++];
+            Result |= static_cast<uint32>(B & 0x7F) << Shift;
+
+            if ((B & 0x80) == 0)
+                break;
+
+            Shift += 7;
+
+            if (Shift > 28)
+            {
+                bOverflow = true;
+                break;
+            }
+        }
+
+        return Result;
+    }
+
+    FORCEINLINE uint64 ReadVarULong()
+    {
+        int32 Shift = 0;
+        uint64 Result = 0;
+
+        while (true)
+        {
+            if (Position >= Capacity)
+            {
+                bOverflow = true;
+                return 0;
+            }
+
+            uint8 B = Data[Position++];
+            Result |= static_cast<uint64>(B & 0x7F) << Shift;
+
+            if ((B & 0x80) == 0)
+                break;
+
+            Shift += 7;
+
+            if (Shift > 63)
+            {
+                bOverflow = true;
+                break;
+            }
+        }
+
+        return Result;
+    }
+
+    FORCEINLINE int32 ReadVarInt() { return DecodeZigZag32(ReadVarUInt()); }
+    FORCEINLINE int64 ReadVarLong() { return DecodeZigZag64(ReadVarULong()); }
+
+    FORCEINLINE void WriteBit(bool Value)
+    {
+        if (WriteBitIndex == 0)
+        {
+            if (Position >= Capacity)
+            {
+                bOverflow = true;
+                return;
+            }
+
+            Data[Position] = 0;
+        }
+
+        if (Value)
+            Data[Position] |= 1 << WriteBitIndex;
+
+        WriteBitIndex++;
+
+        if (WriteBitIndex == 8)
+        {
+            WriteBitIndex = 0;
+            Position++;
+        }
+    }
+
+    FORCEINLINE bool ReadBit()
+    {
+        if (ReadBitIndex == 0)
+            ReadBits = Read<uint8>();
+
+        bool b = (ReadBits & (1 << ReadBitIndex)) != 0;
+        ReadBitIndex++;
+
+        if (ReadBitIndex == 8)
+            ReadBitIndex = 0;
+
+        return b;
+    }
+
+    FORCEINLINE void AlignBits()
+    {
+        if (WriteBitIndex > 0)
+        {
+            WriteBitIndex = 0;
+            Position++;
+        }
+
+        ReadBitIndex = 0;
+    }
+
+    FORCEINLINE void WriteBytes(const uint8* Source, int32 Length)
+    {
+        if (!Source || Length <= 0)
+            return;
+
+        if (Position + Length > Capacity)
+        {
+            bOverflow = true;
+            return;
+        }
+
+        FLATBUFFER_MEMCPY(Data + Position, Source, Length);
+        Position += Length;
+    }
+
+    FORCEINLINE void ReadBytes(uint8* Dest, int32 Length)
+    {
+        if (!Dest || Length <= 0)
+            return;
+
+        if (Position + Length > Capacity)
+        {
+            bOverflow = true;
+            return;
+        }
+
+        FLATBUFFER_MEMCPY(Dest, Data + Position, Length);
+        Position += Length;
+    }
+
+    // Length-prefixed (int32) UTF-8 bytes, same layout as WriteString
+    FORCEINLINE void WriteUtf8(const char* Source, int32 Length)
+    {
+        Write<int32>(Length);
+        WriteBytes(reinterpret_cast<const uint8*>(Source), Length);
+    }
+
+    // Returns the string length and points OutChars into the buffer, nothing is copied
+    FORCEINLINE int32 ReadUtf8View(const char*& OutChars)
+    {
+        OutChars = nullptr;
+        int32 Length = Read<int32>();
+
+        if (Length <= 0)
+            return 0;
+
+        if (Position + Length > Capacity)
+        {
+            bOverflow = true;
+            return 0;
+        }
+
+        OutChars = reinterpret_cast<const char*>(Data + Position);
+        Position += Length;
+        return Length;
+    }
+
+    // Strips a trailing CRC32C signature, shrinking the readable range
+    FORCEINLINE uint32 ReadSign()
+    {
+        if (Capacity < 4)
+        {
+            bOverflow = true;
+            return 0;
+        }
+
+        uint32 Signature = 0;
+        FLATBUFFER_MEMCPY(&Signature, Data + Capacity - 4, 4);
+        Capacity -= 4;
+        return Signature;
+    }
+
+    FORCEINLINE uint32 GetHashFast() const
+    {
+        uint32 Hash = 0;
+
+        for (int32 i = 0; i < Position; i++)
+            Hash = (Hash << 5) + Hash + Data[i];
+
+        return Hash;
+    }
+
+#ifndef TOS_FLATBUFFER_STANDALONE
+    void WriteString(const FString& Value)
+    {
+        FTCHARToUTF8 Converter(*Value);
+        WriteUtf8(reinterpret_cast<const char*>(Converter.Get()), Converter.Length());
+    }
+
+    FString ReadString()
+    {
+        const char* Chars = nullptr;
+        int32 Length = ReadUtf8View(Chars);
+
+        if (Length <= 0)
+            return FString();
+
+        FUTF8ToTCHAR Converter(reinterpret_cast<const UTF8CHAR*>(Chars), Length);
+        return FString(Converter.Length(), Converter.Get());
+    }
+
+    void WriteAsciiString(const FString& Value)
+    {
+        int32 StringLength = Value.Len();
+        Write<int32>(StringLength);
+
+        if (StringLength <= 0)
+            return;
+
+        if (Position + StringLength > Capacity)
+        {
+            bOverflow = true;
+            return;
+        }
+
+        for (int32 i = 0; i < StringLength; ++i)
+        {
+            TCHAR Char = Value[i];
+            Data[Position + i] = (Char >= 0 && Char <= 127) ? static_cast<uint8>(Char) : '?';
+        }
+
+        Position += StringLength;
+    }
+
+    FString ReadAsciiString()
+    {
+        const char* Chars = nullptr;
+        int32 Length = ReadUtf8View(Chars);
+
+        if (Length <= 0)
+            return FString();
+
+        return FString(Length, Chars);
+    }
+#endif
+
+    FORCEINLINE void Reset()
+    {
+        Position = 0;
+        WriteBitIndex = 0;
+        ReadBits = 0;
+        ReadBitIndex = 0;
+        bOverflow = false;
+    }
+
+    FORCEINLINE void SetPosition(int32 NewPosition)
+    {
+        Position = NewPosition < 0 ? 0 : (NewPosition > Capacity ? Capacity : NewPosition);
+    }
+
+    FORCEINLINE uint8* GetData() { return Data; }
+    FORCEINLINE const uint8* GetData() const { return Data; }
+    FORCEINLINE int32 GetPosition() const { return Position; }
+    FORCEINLINE int32 GetCapacity() const { return Capacity; }
+    FORCEINLINE int32 GetLength() const { return Position; }
+    FORCEINLINE int32 GetLengthBits() const { return (Position * 8) + WriteBitIndex; }
+    FORCEINLINE int32 Remaining() const { return Capacity - Position; }
+    FORCEINLINE bool HasOverflowed() const { return bOverflow; }
+
+    // Read-only window over [Position, Position + Length) of this buffer
+    FORCEINLINE FFlatBufferView Slice(int32 Length) const
+    {
+        const int32 Clamped = Length < 0 ? 0 : (Length > Capacity - Position ? Capacity - Position : Length);
+        return FFlatBufferView(Data + Position, Clamped);
+    }
+
+protected:
+    static FORCEINLINE uint32 EncodeZigZag32(int32 Value) { return static_cast<uint32>((Value << 1) ^ (Value >> 31)); }
+    static FORCEINLINE int32 DecodeZigZag32(uint32 Value) { return static_cast<int32>((Value >> 1) ^ -static_cast<int32>(Value & 1)); }
+    static FORCEINLINE uint64 EncodeZigZag64(int64 Value) { return (static_cast<uint64>(Value) << 1) ^ static_cast<uint64>(Value >> 63); }
+    static FORCEINLINE int64 DecodeZigZag64(uint64 Value) { return static_cast<int64>((Value >> 1) ^ -static_cast<int64>(Value & 1)); }
+
+    uint8* Data = nullptr;
+    int32 Capacity = 0;
+    int32 Position = 0;
+    uint8 WriteBitIndex = 0;
+    uint8 ReadBits = 0;
+    uint8 ReadBitIndex = 0;
+    bool bOverflow = false;
+};
+
+/**
+ * Heap-owning flat buffer. Move-only; Attach() turns it into a non-owning
+ * buffer over external memory (used by UFlatBuffer::SetView).
+ */
+class FFlatBuffer : public FFlatBufferView
+{
+public:
+    FFlatBuffer() = default;
+
+    explicit FFlatBuffer(int32 InCapacity) { Allocate(InCapacity); }
+
+    ~FFlatBuffer() { Free(); }
+
+    FFlatBuffer(const FFlatBuffer&) = delete;
+    FFlatBuffer& operator=(const FFlatBuffer&) = delete;
+
+    FFlatBuffer(FFlatBuffer&& Other) noexcept
+        : FFlatBufferView(Other), bOwnsData(Other.bOwnsData)
+    {
+        Other.Data = nullptr;
+        Other.Capacity = 0;
+        Other.Position = 0;
+        Other.bOwnsData = false;
+    }
+
+    FFlatBuffer& operator=(FFlatBuffer&& Other) noexcept
+    {
+        if (this != &Other)
+        {
+            Free();
+            static_cast<FFlatBufferView&>(*this) = Other;
+            bOwnsData = Other.bOwnsData;
+            Other.Data = nullptr;
+            Other.Capacity = 0;
+            Other.Position = 0;
+            Other.bOwnsData = false;
+        }
+
+        return *this;
+    }
+
+    bool Allocate(int32 InCapacity)
+    {
+        Free();
+
+        if (InCapacity <= 0)
+            return false;
+
+        Data = static_cast<uint8*>(FLATBUFFER_MALLOC(InCapacity));
+
+        if (Data == nullptr)
+            return false;
+
+        Capacity = InCapacity;
+        bOwnsData = true;
+        return true;
+    }
+
+    void Attach(uint8* Memory, int32 Length)
+    {
+        Free();
+        Data = Memory;
+        Capacity = Length;
+        bOwnsData = false;
+    }
+
+    void Free()
+    {
+        if (Data != nullptr && bOwnsData)
+            FLATBUFFER_FREE(Data);
+
+        Data = nullptr;
+        Capacity = 0;
+        bOwnsData = false;
+        Reset();
+    }
+
+    FORCEINLINE bool OwnsData() const { return bOwnsData; }
+
+private:
+    bool bOwnsData = false;
+};
+
+/**
+ * Flat buffer with inline storage, for stack-allocated scratch buffers on hot paths.
+ */
+template<int32 InlineCapacity>
+class TFlatBuffer : public FFlatBufferView
+{
+public:
+    TFlatBuffer() : FFlatBufferView(Storage, InlineCapacity) {}
+
+    TFlatBuffer(const TFlatBuffer&) = delete;
+    TFlatBuffer& operator=(const TFlatBuffer&) = delete;
+
+private:
+    uint8 Storage[InlineCapacity];
+};
+
+#ifndef TOS_FLATBUFFER_STANDALONE
+template<>
+FORCEINLINE void FFlatBufferView::Write<FVector>(const FVector& Value)
+{
+    constexpr float Factor = 0.1f;
+    Write<int16>(static_cast<int16>(FMath::RoundToInt(Value.X / Factor)));
+    Write<int16>(static_cast<int16>(FMath::RoundToInt(Value.Y / Factor)));
+    Write<int16>(static_cast<int16>(FMath::RoundToInt(Value.Z / Factor)));
+}
+
+template<>
+FORCEINLINE FVector FFlatBufferView::Read<FVector>()
+{
+    constexpr float Factor = 0.1f;
+    int16 X = Read<int16>();
+    int16 Y = Read<int16>();
+    int16 Z = Read<int16>();
+    return FVector(static_cast<float>(X) * Factor, static_cast<float>(Y) * Factor, static_cast<float>(Z) * Factor);
+}
+
+template<>
+FORCEINLINE void FFlatBufferView::Write<FRotator>(const FRotator& Value)
+{
+    constexpr float Factor = 0.1f;
+    Write<int16>(static_cast<int16>(FMath::RoundToInt(Value.Pitch / Factor)));
+    Write<int16>(static_cast<int16>(FMath::RoundToInt(Value.Yaw / Factor)));
+    Write<int16>(static_cast<int16>(FMath::RoundToInt(Value.Roll / Factor)));
+}
+
+template<>
+FORCEINLINE FRotator FFlatBufferView::Read<FRotator>()
+{
+    constexpr float Factor = 0.1f;
+    int16 Pitch = Read<int16>();
+    int16 Yaw = Read<int16>();
+    int16 Roll = Read<int16>();
+    return FRotator(static_cast<float>(Pitch) * Factor, static_cast<float>(Yaw) * Factor, static_cast<float>(Roll) * Factor);
+}
+#endif
@@ -0,0 +1,85 @@
+/*
+ * FragmentReassembler.h
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Network/PacketBufferPool.h"
+
+/**
+ * Rebuilds datagrams the server split into [Fragment][id u16][offset u16][total u32][chunk].
+ * Messages are assembled in place inside fixed 64 KB slots of MessagePool; a completed
+ * message is handed out as a pooled packet (bReassembled set) so it can be decrypted and
+ * queued without another copy. Not thread-safe: used from the network thread only.
+ */
+class TOS_NETWORK_API FFragmentReassembler
+{
+public:
+    static constexpr int32 HeaderSize = 1 + 2 + 2 + 4;
+    static constexpr int32 MaxMessageSize = 64 * 1024;
+    static constexpr int32 MessageSlotCount = 16;
+    static constexpr int32 MaxPendingMessages = 8;
+    static constexpr int32 MaxFragments = 128;
+    static constexpr double FragmentTimeout = 5.0;
+
+    void Initialize();
+    void Reset();
+
+    /**
+     * Stores one fragment. Returns true when it completed its message; OutMessage then owns a
+     * MessagePool slot holding the original datagram and must be released by the caller.
+     */
+    bool Add(uint16 FragmentId, uint32 Offset, uint32 TotalSize, const uint8* Chunk, int32 Length, double Now, FPooledPacket& OutMessage);
+
+    // Drops partial messages that have not seen a fragment within FragmentTimeout
+    void Expire(double Now);
+
+    FORCEINLINE FPacketBufferPool& GetPool() { return MessagePool; }
+    FORCEINLINE const FPacketBufferPool& GetPool() const { return MessagePool; }
+    FORCEINLINE uint64 GetCompletedCount() const { return Completed; }
+    FORCEINLINE uint64 GetDroppedCount() const { return Dropped; }
+    FORCEINLINE uint64 GetExpiredCount() const { return Expired; }
+
+private:
+    struct FPendingMessage
+    {
+        int32 Slot = INDEX_NONE;
+        uint16 FragmentId = 0;
+        uint32 TotalSize = 0;
+        int32 ChunkSize = 0;
+        int32 FinalOffset = INDEX_NONE;
+        int32 ChunksReceived = 0;
+        double LastUpdate = 0.0;
+        uint64 Received[MaxFragments / 64] = {};
+    };
+
+    FPendingMessage* Find(uint16 FragmentId);
+    FPendingMessage* Begin(uint16 FragmentId, uint32 TotalSize, double Now);
+    void Discard(FPendingMessage& Message);
+
+    FPacketBufferPool MessagePool;
+    FPendingMessage Pending[MaxPendingMessages];
+    uint64 Completed = 0;
+    uint64 Dropped = 0;
+    uint64 Expired = 0;
+};
@@ -0,0 +1,90 @@
+/*
+ * LinuxUdpBatchSocket.h
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Network/PacketBufferPool.h"
+
+class FInternetAddr;
+
+/**
+ * Connected UDP socket that moves datagrams in batches: recvmmsg/sendmmsg, plus
+ * UDP_GRO on receive and UDP_SEGMENT (GSO) on send when the kernel supports them.
+ * Only available on Linux; Open() fails elsewhere so callers fall back to FSocket.
+ * Sends may be queued from the owning (network) thread only; Send() is safe from any thread.
+ */
+class TOS_NETWORK_API FLinuxUdpBatchSocket
+{
+public:
+    static constexpr int32 MaxBatch = 32;
+    static constexpr int32 MaxReceivePackets = 512;
+
+    FLinuxUdpBatchSocket();
+    ~FLinuxUdpBatchSocket();
+
+    bool Open(const FInternetAddr& Remote, int32 ReceiveBufferSize);
+    void Close();
+
+    FORCEINLINE bool IsOpen() const { return Fd >= 0; }
+    FORCEINLINE bool IsGSOEnabled() const { return bGSO; }
+    FORCEINLINE bool IsGROEnabled() const { return bGRO; }
+
+    /**
+     * Drains up to MaxPackets datagrams with as few syscalls as possible. Every returned
+     * packet owns a pool slot the caller must release. OutDropped counts datagrams lost to
+     * pool exhaustion or truncation.
+     */
+    int32 ReceiveBatch(FPacketBufferPool& Pool, FPooledPacket* OutPackets, int32 MaxPackets, uint64& OutDropped);
+
+    // Immediate send on the connected socket, returns bytes sent or -1
+    int32 Send(const uint8* Data, int32 Length);
+
+    // Copies the datagram into the outbound batch; flushed by Flush() or when the batch fills
+    void QueueSend(const uint8* Data, int32 Length);
+
+    // Sends every queued datagram with one sendmmsg, coalescing equal-sized runs with GSO
+    int32 Flush();
+
+    FORCEINLINE int32 GetQueuedCount() const { return SendCount; }
+
+    bool HasPendingData() const;
+    bool Wait(double TimeoutSeconds) const;
+
+private:
+    struct FBatchState;
+
+    int32 ReceiveDirect(FPacketBufferPool& Pool, FPooledPacket* OutPackets, int32 MaxPackets, uint64& OutDropped);
+    int32 ReceiveCoalesced(FPacketBufferPool& Pool, FPooledPacket* OutPackets, int32 MaxPackets, uint64& OutDropped);
+    int32 SendQueued(bool bAllowGSO);
+
+    int32 Fd = -1;
+    bool bGSO = false;
+    bool bGRO = false;
+
+    TUniquePtr<FBatchState> State;
+    TArray<uint8> SendStaging;
+    int32 SendLengths[MaxBatch];
+    int32 SendCount = 0;
+    int32 SendBytes = 0;
+};
@@ -0,0 +1,148 @@
+/*
+ * NetEventQueue.h
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/CircularQueue.h"
+#include "Containers/Queue.h"
+#include "Network/FlatBuffer.h"
+#include <atomic>
+#include <type_traits>
+
+enum class ENetEventKind : uint8
+{
+    Packet,
+    RawPacket,
+    Connect,
+    ConnectDenied,
+    ConnectionError,
+    Disconnect
+};
+
+/**
+ * One network event handed from the network thread to the game thread.
+ * Packet events carry the decoded packet struct by value; RawPacket events carry the
+ * serialized message body for packets with variable-size fields (arrays, strings),
+ * which are deserialized again on the game thread.
+ */
+struct FNetEvent
+{
+    static constexpr int32 PayloadSize = 112;
+
+    ENetEventKind Kind = ENetEventKind::Packet;
+    uint8 PacketId = 0;
+    uint16 Size = 0;
+    int32 Value = 0;
+    alignas(16) uint8 Payload[PayloadSize];
+
+    FNetEvent() = default;
+    FNetEvent(ENetEventKind InKind, uint8 InPacketId = 0, int32 InValue = 0)
+        : Kind(InKind), PacketId(InPacketId), Value(InValue) {}
+
+    template<typename T>
+    FORCEINLINE void Store(const T& Packet)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Packet events must be trivially copyable, send them as raw packets");
+        static_assert(sizeof(T) <= PayloadSize && alignof(T) <= 16, "Packet struct does not fit an inline event");
+
+        FMemory::Memcpy(Payload, &Packet, sizeof(T));
+        Size = static_cast<uint16>(sizeof(T));
+    }
+
+    template<typename T>
+    FORCEINLINE const T& Get() const
+    {
+        return *reinterpret_cast<const T*>(Payload);
+    }
+
+    FORCEINLINE bool StoreRaw(const uint8* Data, int32 Length)
+    {
+        if (Length < 0 || Length > PayloadSize)
+            return false;
+
+        FMemory::Memcpy(Payload, Data, Length);
+        Size = static_cast<uint16>(Length);
+        return true;
+    }
+
+    // Read-only view over a raw payload
+    FORCEINLINE FFlatBufferView GetRawView() const
+    {
+        return FFlatBufferView(const_cast<uint8*>(Payload), Size);
+    }
+};
+
+/**
+ * Single-producer/single-consumer handoff of network events. The network thread enqueues,
+ * the game thread drains once per frame. Steady state runs on a fixed lock-free ring; when the
+ * game thread stalls long enough to fill it, events spill into an unbounded SPSC list so
+ * reliable events are never lost, and the ring is not reused until the spill has drained.
+ */
+class TOS_NETWORK_API FNetEventQueue
+{
+public:
+    static constexpr uint32 DefaultCapacity = 4096;
+
+    explicit FNetEventQueue(uint32 Capacity = DefaultCapacity) : Ring(Capacity) {}
+
+    // Producer side, network thread only
+    void Enqueue(const FNetEvent& Event);
+
+    // Consumer side, game thread only. Invokes Handler for each pending event in arrival order.
+    template<typename FHandler>
+    int32 Drain(FHandler&& Handler)
+    {
+        // Events are copied out before dispatch so a handler may Empty() the queue
+        int32 Count = 0;
+        FNetEvent Event;
+
+        while (Ring.Dequeue(Event))
+        {
+            Handler(Event);
+            Count++;
+        }
+
+        while (Overflow.Dequeue(Event))
+        {
+            SpilledCount.fetch_sub(1, std::memory_order_release);
+            Handler(Event);
+            Count++;
+        }
+
+        return Count;
+    }
+
+    // Consumer side, drops every pending event
+    void Empty();
+
+    FORCEINLINE uint64 GetEnqueuedCount() const { return Enqueued.load(std::memory_order_relaxed); }
+    FORCEINLINE uint64 GetOverflowCount() const { return Overflowed.load(std::memory_order_relaxed); }
+
+private:
+    TCircularQueue<FNetEvent> Ring;
+    TQueue<FNetEvent, EQueueMode::Spsc> Overflow;
+    std::atomic<uint64> Enqueued{ 0 };
+    std::atomic<uint64> Overflowed{ 0 };
+    std::atomic<int32> SpilledCount{ 0 };
+};
@@ -0,0 +1,114 @@
+/*
+ * PacketBufferPool.h
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+ * A received (or decrypted) datagram that lives inside a pool slot.
+ * Slot is INDEX_NONE when the handle is empty. bReassembled marks slots owned by
+ * the fragment reassembler's 64 KB message pool instead of the datagram pool.
+ * Offset skips transport prefixes (ACK block, reliable sequence) left in front of the payload.
+ */
+struct FPooledPacket
+{
+    int32 Slot = INDEX_NONE;
+    int32 Offset = 0;
+    int32 Length = 0;
+    bool bReassembled = false;
+    bool bStreamCompressed = false;
+
+    FORCEINLINE bool IsValid() const { return Slot != INDEX_NONE; }
+};
+
+/**
+ * Snapshot of the receive path counters. HeapAllocations counts the pool slabs
+ * and the LZ4 stream decoders' buffers, all set up before traffic flows, so it
+ * moving under load points at a decoder allocating late. Events that spill past
+ * the game thread's ring are counted by FNetEventQueue::GetOverflowCount.
+ */
+struct FReceivePathStats
+{
+    uint64 DatagramsReceived = 0;
+    uint64 BytesReceived = 0;
+    uint64 HeapAllocations = 0;
+    uint64 PoolExhaustedDrops = 0;
+    uint64 QueueFullDrops = 0;
+    uint64 ReorderWindowDrops = 0;
+    uint64 MessagesReassembled = 0;
+    uint64 ReassemblyDrops = 0;
+    uint64 MalformedDrops = 0;
+    uint64 ChecksumDrops = 0;
+    uint64 ReplayDrops = 0;
+    uint64 DecryptDrops = 0;
+    int32 SlotsInUse = 0;
+};
+
+/**
+ * Fixed slab of MTU-sized buffers. Slots are handed out by index and recycled
+ * after dispatch, nothing is allocated after Initialize.
+ * Not thread-safe: acquire and release must happen on the network thread.
+ */
+class TOS_NETWORK_API FPacketBufferPool
+{
+public:
+    static constexpr int32 DefaultSlotSize = 1536;
+    static constexpr int32 DefaultSlotCount = 256;
+
+    void Initialize(int32 InSlotCount = DefaultSlotCount, int32 InSlotSize = DefaultSlotSize);
+    void Reset();
+
+    int32 Acquire();
+    void Release(int32 Slot);
+
+    FORCEINLINE void Release(FPooledPacket& Packet)
+    {
+        Release(Packet.Slot);
+        Packet.Slot = INDEX_NONE;
+        Packet.Offset = 0;
+        Packet.Length = 0;
+        Packet.bReassembled = false;
+        Packet.bStreamCompressed = false;
+    }
+
+    FORCEINLINE uint8* GetData(int32 Slot) { return Slab.GetData() + static_cast<SIZE_T>(Slot) * SlotSize; }
+    FORCEINLINE const uint8* GetData(int32 Slot) const { return Slab.GetData() + static_cast<SIZE_T>(Slot) * SlotSize; }
+    FORCEINLINE uint8* GetData(const FPooledPacket& Packet) { return GetData(Packet.Slot) + Packet.Offset; }
+    FORCEINLINE int32 GetSlotSize() const { return SlotSize; }
+    FORCEINLINE int32 GetSlotCount() const { return SlotCount; }
+    FORCEINLINE int32 GetFreeCount() const { return FreeCount; }
+    FORCEINLINE int32 GetUsedCount() const { return SlotCount - FreeCount; }
+    FORCEINLINE bool IsInitialized() const { return SlotCount > 0; }
+    FORCEINLINE uint64 GetAllocationCount() const { return Allocations.load(std::memory_order_relaxed); }
+
+private:
+    TArray<uint8, TAlignedHeapAllocator<64>> Slab;
+    TArray<int32> FreeSlots;
+    TBitArray<> InUse;
+    int32 FreeCount = 0;
+    int32 SlotSize = 0;
+    int32 SlotCount = 0;
+    std::atomic<uint64> Allocations{ 0 };
+};
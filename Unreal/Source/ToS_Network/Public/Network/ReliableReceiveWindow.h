@@ -0,0 +1,120 @@
+/*
+ * ReliableReceiveWindow.h
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Network/PacketBufferPool.h"
+
+/**
+ * Reorder buffer for reliable packets that arrive ahead of the next expected sequence.
+ * Slots are indexed by sequence modulo Capacity and only hold the pooled packet handle, so
+ * buffering and delivery never copy payloads; presence bits catch duplicates and double as
+ * the SACK mask. Sequences Capacity or more past the expected one are refused, which bounds
+ * the window to Capacity pinned pool slots. Not thread-safe: the owner serializes access.
+ */
+class TOS_NETWORK_API FReliableReceiveWindow
+{
+public:
+    static constexpr int32 Capacity = 256;
+    static constexpr uint64 Mask = Capacity - 1;
+
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(Capacity >= 128, "The window must cover the 64 sequences of a SACK mask");
+
+    enum class EInsertResult : uint8
+    {
+        Stored,
+        Duplicate,
+        TooFarAhead
+    };
+
+    void Reset();
+
+    /**
+     * Buffers a packet with Expected < Sequence. On Stored the window takes the handle over;
+     * otherwise the caller still owns Packet and must release it.
+     */
+    EInsertResult Insert(uint64 Expected, uint64 Sequence, const FPooledPacket& Packet);
+
+    // Moves the packet buffered for Sequence out of the window, if it arrived
+    bool Take(uint64 Sequence, FPooledPacket& OutPacket);
+
+    // Presence of the 64 sequences starting at First, bit i set when First + i is buffered
+    uint64 GetPresenceMask(uint64 First) const;
+
+    FORCEINLINE bool Contains(uint64 Sequence) const
+    {
+        const uint64 Index = Sequence & Mask;
+        return (Present[Index >> 6] >> (Index & 63)) & 1;
+    }
+
+    FORCEINLINE int32 Num() const { return Count; }
+    FORCEINLINE bool IsEmpty() const { return Count == 0; }
+
+private:
+    FPooledPacket Slots[Capacity];
+    uint64 Present[Capacity / 64] = {};
+    int32 Count = 0;
+};
+
+/**
+ * Transport-level record of the reliable sequences received, independent of the stream each
+ * packet is delivered on: the cumulative point below which everything arrived, plus a bitmap of
+ * what arrived past it. Drives the ACK/SACK block and duplicate detection for retransmits.
+ * Not thread-safe: the owner serializes access.
+ */
+class TOS_NETWORK_API FReliableSequenceTracker
+{
+public:
+    static constexpr int32 Capacity = FReliableReceiveWindow::Capacity;
+    static constexpr uint64 Mask = Capacity - 1;
+
+    void Reset();
+
+    // Records Sequence, advancing the cumulative point over every contiguous arrival
+    void Mark(uint64 Sequence);
+
+    FORCEINLINE bool Contains(uint64 Sequence) const
+    {
+        if (Sequence <= Cumulative)
+            return true;
+
+        const uint64 Index = Sequence & Mask;
+        return Sequence - Cumulative <= static_cast<uint64>(Capacity) && ((Present[Index >> 6] >> (Index & 63)) & 1);
+    }
+
+    // Sequences more than Capacity past the cumulative point cannot be recorded
+    FORCEINLINE bool IsWithinWindow(uint64 Sequence) const { return Sequence - Cumulative <= static_cast<uint64>(Capacity); }
+
+    // Presence of the 64 sequences starting at First, bit i set when First + i was received
+    uint64 GetPresenceMask(uint64 First) const;
+
+    FORCEINLINE uint64 GetCumulative() const { return Cumulative; }
+    FORCEINLINE bool HasGaps() const { return Ahead > 0; }
+
+private:
+    uint64 Present[Capacity / 64] = {};
+    uint64 Cumulative = 0;
+    int32 Ahead = 0;
+};
@@ -0,0 +1,101 @@
+/*
+ * ReliableSendWindow.h
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Network/SendBufferPool.h"
+
+/**
+ * In-flight reliable packets, indexed by sequence in a power-of-two ring so lookups on ACK are
+ * a mask instead of a hash. Resend deadlines live in a binary min-heap whose entries know their
+ * slot (and slots their heap index), so the next due packet is read in O(1) and an ACK or a
+ * reschedule costs O(log n). The ring doubles when the span of unacknowledged sequences outgrows it.
+ * Not thread-safe: the owner serializes access.
+ */
+class TOS_NETWORK_API FReliableSendWindow
+{
+public:
+    static constexpr int32 DefaultCapacity = 256;
+
+    struct FEntry
+    {
+        FSendBufferRef Buffer;
+        uint64 Sequence = 0;
+        double SentTime = 0.0;
+        double Deadline = 0.0;
+        int32 RetryCount = 0;
+        int32 SackSkips = 0;
+        int32 HeapIndex = INDEX_NONE;
+        bool bRetransmitted = false;
+        bool bInUse = false;
+    };
+
+    explicit FReliableSendWindow(int32 InitialCapacity = DefaultCapacity);
+
+    void Reset();
+
+    // Tracks a sent packet until it is acknowledged; Deadline is when it is first due for a resend
+    FEntry& Add(uint64 Sequence, FSendBufferRef Buffer, double SentTime, double Deadline);
+
+    FORCEINLINE FEntry* Find(uint64 Sequence)
+    {
+        if (Sequence < Base || Sequence >= Next)
+            return nullptr;
+
+        FEntry& Entry = Slots[Sequence & Mask];
+        return Entry.bInUse && Entry.Sequence == Sequence ? &Entry : nullptr;
+    }
+
+    bool Remove(uint64 Sequence);
+    void Reschedule(FEntry& Entry, double Deadline);
+
+    // Earliest resend deadline, or nullptr when nothing is in flight
+    FORCEINLINE FEntry* PeekNext() { return Heap.Num() > 0 ? &Slots[Heap[0] & Mask] : nullptr; }
+    FORCEINLINE double GetNextDeadline() const { return Heap.Num() > 0 ? Slots[Heap[0] & Mask].Deadline : TNumericLimits<double>::Max(); }
+
+    // Sequences in [GetBase(), GetNext()) may be in flight
+    FORCEINLINE uint64 GetBase() const { return Base; }
+    FORCEINLINE uint64 GetNext() const { return Next; }
+    FORCEINLINE int64 GetBytesInFlight() const { return BytesInFlight; }
+    FORCEINLINE int32 Num() const { return Heap.Num(); }
+    FORCEINLINE bool IsEmpty() const { return Heap.Num() == 0; }
+
+private:
+    void Grow(uint64 RequiredSpan);
+    void SiftUp(int32 Index);
+    void SiftDown(int32 Index);
+    void HeapSwap(int32 A, int32 B);
+
+    FORCEINLINE bool HeapLess(int32 A, int32 B) const
+    {
+        return Slots[Heap[A] & Mask].Deadline < Slots[Heap[B] & Mask].Deadline;
+    }
+
+    TArray<FEntry> Slots;
+    TArray<uint64> Heap;
+    uint64 Mask = 0;
+    uint64 Base = 0;
+    uint64 Next = 0;
+    int64 BytesInFlight = 0;
+};
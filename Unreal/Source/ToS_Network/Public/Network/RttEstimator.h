@@ -0,0 +1,90 @@
+/*
+ * RttEstimator.h
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Smoothed round-trip estimator for the reliable channel (RFC 6298). Only unambiguous samples
+ * should be fed in: per Karn's rule, a packet that was ever retransmitted cannot tell which copy
+ * its ACK answers. Until the first sample the configured initial timeout is used as-is.
+ */
+struct FRttEstimator
+{
+    static constexpr double Alpha = 0.125;
+    static constexpr double Beta = 0.25;
+    static constexpr double ClockGranularity = 0.001;
+    static constexpr double MinTimeout = 0.03;
+    static constexpr double MaxTimeout = 5.0;
+
+    FORCEINLINE void Reset(double InitialTimeout)
+    {
+        SmoothedRtt = 0.0;
+        RttVariance = 0.0;
+        LatestRtt = 0.0;
+        Timeout = FMath::Clamp(InitialTimeout, MinTimeout, MaxTimeout);
+        bHasSample = false;
+    }
+
+    FORCEINLINE void AddSample(double Rtt)
+    {
+        if (Rtt <= 0.0)
+            return;
+
+        LatestRtt = Rtt;
+
+        if (!bHasSample)
+        {
+            SmoothedRtt = Rtt;
+            RttVariance = Rtt * 0.5;
+            bHasSample = true;
+        }
+        else
+        {
+            RttVariance = (1.0 - Beta) * RttVariance + Beta * FMath::Abs(SmoothedRtt - Rtt);
+            SmoothedRtt = (1.0 - Alpha) * SmoothedRtt + Alpha * Rtt;
+        }
+
+        Timeout = FMath::Clamp(SmoothedRtt + FMath::Max(ClockGranularity, 4.0 * RttVariance), MinTimeout, MaxTimeout);
+    }
+
+    // Exponential backoff: every timeout of the same packet doubles its wait
+    FORCEINLINE double GetRetransmitTimeout(int32 RetryCount) const
+    {
+        return FMath::Min(Timeout * static_cast<double>(1ull << FMath::Clamp(RetryCount, 0, 16)), MaxTimeout);
+    }
+
+    FORCEINLINE double GetTimeout() const { return Timeout; }
+    FORCEINLINE double GetSmoothedRtt() const { return SmoothedRtt; }
+    FORCEINLINE double GetRttVariance() const { return RttVariance; }
+    FORCEINLINE double GetLatestRtt() const { return LatestRtt; }
+    FORCEINLINE bool HasSample() const { return bHasSample; }
+
+private:
+    double SmoothedRtt = 0.0;
+    double RttVariance = 0.0;
+    double LatestRtt = 0.0;
+    double Timeout = 0.25;
+    bool bHasSample = false;
+};
@@ -3,6 +3,8 @@
 #include "CoreMinimal.h"
 #include <sodium.h>
 
+class FLZ4Dictionary;
+
 UENUM(BlueprintType)
 enum class EPacketChannel : uint8
 {
@@ -11,20 +13,54 @@ enum class EPacketChannel : uint8
     ReliableUnordered = 2
 };
 
+// The channel byte carries the channel kind in its low nibble and, on the reliable
+// channels, the reliable stream the message is ordered on in its high nibble
+static constexpr uint8 PacketChannelKindMask = 0x0F;
+static constexpr int32 PacketChannelStreamShift = 4;
+
+FORCEINLINE EPacketChannel GetChannelKind(EPacketChannel Channel)
+{
+    return static_cast<EPacketChannel>(static_cast<uint8>(Channel) & PacketChannelKindMask);
+}
+
+FORCEINLINE uint8 GetChannelStream(EPacketChannel Channel)
+{
+    return static_cast<uint8>(Channel) >> PacketChannelStreamShift;
+}
+
+FORCEINLINE EPacketChannel MakeChannel(EPacketChannel Kind, uint8 Stream)
+{
+    return static_cast<EPacketChannel>(static_cast<uint8>(Kind) | (Stream << PacketChannelStreamShift));
+}
+
 UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
 enum class EPacketHeaderFlags : uint8
 {
     None = 0,
     Encrypted = 1 << 0,
     AEAD_ChaCha20Poly1305 = 1 << 1,
-    Rekey = 1 << 2,
+    AEAD_AES256GCM = 1 << 2,
     Fragment = 1 << 3,
     Compressed = 1 << 4,
     Acknowledgment = 1 << 5,
-    ReliableHandshake = 1 << 6
+    ReliableHandshake = 1 << 6,
+    StreamCompressed = 1 << 7
 };
 ENUM_CLASS_FLAGS(EPacketHeaderFlags)
 
+// The AEAD bits name the suite the payload is sealed with, the one the session negotiated
+static constexpr EPacketHeaderFlags PacketHeaderAEADMask = EPacketHeaderFlags::AEAD_ChaCha20Poly1305 | EPacketHeaderFlags::AEAD_AES256GCM;
+
+// Negotiated in the handshake: the client offers them on Connect, ConnectionAccepted echoes the ones granted
+enum class ESessionOptions : uint8
+{
+    None = 0,
+    NoChecksum = 1 << 0, // AEAD packets drop their CRC32C trailer, the tag already authenticates them
+    Resumed = 1 << 1, // Offered on Resume; granted when the ticket redeemed and the keys come from it
+    AES256GCM = 1 << 2 // Packets are sealed with AES-256-GCM, offered and granted only where both ends run AES in hardware
+};
+ENUM_CLASS_FLAGS(ESessionOptions)
+
 struct TOS_NETWORK_API FPacketHeader
 {
     uint32 ConnectionId = 0;
@@ -50,32 +86,131 @@ private:
     uint32 ConnectionId = 0;
     uint64 ReplayWindow = 0;
     uint64 HighestSeqReceived = 0;
+    ESessionOptions Options = ESessionOptions::None;
+
+    // AES-256-GCM key schedules, expanded once when the suite is granted
+    crypto_aead_aes256gcm_state TxAESState;
+    crypto_aead_aes256gcm_state RxAESState;
 
     static constexpr int32 ReplayWindowSize = 64;
 
+    // Compression state, send side only
+    bool bCompressionEnabled = true;
+    int32 CompressionThreshold = 512;
+    float CompressionRatio = 0.0f;
+    int32 CompressionSkipped = 0;
+    int32 CompressionAcceleration = 1;
+    int32 HighCompressionThreshold = 1024;
+    const FLZ4Dictionary* Dictionary = nullptr; // Negotiated in the handshake, owned by the client
+
+    // HKDF-SHA256
+    static void DeriveKeyMaterial(const uint8* IKM, int32 IKMLength, const uint8* Salt, int32 SaltLength,
+                                  const uint8* Info, int32 InfoLength, uint8* OKM, int32 OKMLength);
+    void ApplyKeyMaterial(const uint8* OKM, const uint8* Salt, uint32 InConnectionId);
+
+    // The negotiated suite, both with the tag detached so every caller keeps the [ciphertext][tag] layout
+    int Seal(uint8* Ciphertext, uint8* Tag, const uint8* Plaintext, int32 Length, const uint8* AAD, int32 AADLength, const uint8* Nonce) const;
+    int Open(uint8* Plaintext, const uint8* Ciphertext, int32 Length, const uint8* Tag, const uint8* AAD, int32 AADLength, const uint8* Nonce) const;
+
 public:
     bool InitializeAsClient(const TArray<uint8>& ClientPrivateKey, const TArray<uint8>& ServerPublicKey,
                            const TArray<uint8>& Salt, uint32 InConnectionId);
 
+    // Resumption: both ends derive the same secret from the session keys and the server seals its copy into
+    // a ticket. Presenting the ticket with a fresh nonce keys the next session without an X25519 exchange.
+    static constexpr int32 ResumptionSecretSize = 32;
+    static constexpr int32 ResumeNonceSize = 32;
+
+    void DeriveResumptionSecret(uint8* Secret) const;
+
+    bool InitializeFromResumption(const uint8* ResumptionSecret, const uint8* ResumeNonce, const TArray<uint8>& Salt, uint32 InConnectionId);
+
+    static constexpr int32 NonceSize = 12;
+
     void GenerateNonce(uint64 Sequence, TArray<uint8>& Nonce) const;
 
+    void GenerateNonce(uint64 Sequence, uint8* Nonce) const;
+
     bool EncryptPayload(const TArray<uint8>& Plaintext, const TArray<uint8>& AAD, TArray<uint8>& Ciphertext);
 
-    bool EncryptPayloadWithCompression(const TArray<uint8>& Plaintext, const TArray<uint8>& AAD, TArray<uint8>& Result, bool& bWasCompressed);
+    // Compress-then-encrypt: sets the Compressed flag on Header when LZ4 wins, then seals under the resulting AAD
+    bool EncryptPayloadWithCompression(const TArray<uint8>& Plaintext, FPacketHeader& Header, TArray<uint8>& Result);
 
-    bool EncryptPayloadWithSequence(const TArray<uint8>& Plaintext, const TArray<uint8>& AAD, uint64 Sequence, TArray<uint8>& Result, bool& bWasCompressed);
+    bool EncryptPayloadWithSequence(const TArray<uint8>& Plaintext, FPacketHeader& Header, uint64 Sequence, TArray<uint8>& Result);
 
     bool EncryptPayloadWithSpecificSequence(const TArray<uint8>& Plaintext, const TArray<uint8>& AAD, uint64 Sequence, TArray<uint8>& Ciphertext);
 
+    // Send path: encrypts Length bytes at Data in place under SeqTx and writes the tag right behind them,
+    // so Data needs room for Length + TagSize. The wire layout matches EncryptPayload.
+    static constexpr int32 TagSize = crypto_aead_chacha20poly1305_ietf_ABYTES;
+
+    static_assert(crypto_aead_aes256gcm_ABYTES == TagSize && crypto_aead_aes256gcm_NPUBBYTES == NonceSize,
+                  "Both suites have to share the wire layout");
+
+    bool EncryptInPlace(uint8* Data, int32 Length, const uint8* AAD, int32 AADLength, int32& CiphertextLength);
+
     bool DecryptPayload(const TArray<uint8>& Ciphertext, const TArray<uint8>& AAD, uint64 Sequence, TArray<uint8>& Plaintext);
 
     bool DecryptPayloadWithDecompression(const TArray<uint8>& Data, const TArray<uint8>& AAD, uint64 Sequence, bool bIsCompressed, TArray<uint8>& Plaintext);
 
+    // View based variants used by the receive path: read straight from the datagram, write into caller owned memory
+    bool DecryptPayload(const uint8* Ciphertext, int32 CiphertextLength, const uint8* AAD, int32 AADLength, uint64 Sequence,
+                        uint8* Plaintext, int32 PlaintextCapacity, int32& PlaintextLength);
+
+    bool DecryptPayloadWithDecompression(const uint8* Data, int32 DataLength, const uint8* AAD, int32 AADLength, uint64 Sequence, bool bIsCompressed,
+                                         uint8* Scratch, int32 ScratchCapacity, uint8* Plaintext, int32 PlaintextCapacity, int32& PlaintextLength);
+
+    // Inflates an already authenticated plaintext, 0 or less when it is malformed or outgrows OutCapacity
+    int32 Decompress(const uint8* Data, int32 Length, uint8* Out, int32 OutCapacity) const;
+
+    // Plaintexts at or above the threshold are LZ4'd before encryption. A running ratio of compressed to
+    // original size stops the attempts once traffic proves incompressible, and an occasional probe
+    // picks compressible traffic up again.
+    static constexpr float IncompressibleRatio = 0.9f;
+    static constexpr float CompressionRatioGain = 0.125f;
+    static constexpr int32 CompressionProbeInterval = 32;
+    static constexpr int32 MaxDecompressedSize = 64 * 1024;
+
+    // A negotiated dictionary lets even small packets shrink, so the threshold drops with it
+    static constexpr int32 DictionaryCompressionThreshold = 16;
+
+    void SetCompression(bool bEnabled, int32 Threshold);
+    bool ShouldCompress(int32 Length);
+
+    // Packets run the fast LZ4 level at the given acceleration; reliable payloads at or above the high
+    // compression threshold, rare and sent once, take the slower high level instead (0 turns it off)
+    void SetCompressionLevel(int32 Acceleration, int32 HighThreshold);
+
+    // Returns the compressed length, or 0 when the result would not be smaller than the input
+    int32 Compress(const uint8* Data, int32 Length, uint8* Out, int32 OutCapacity, bool bReliable = false);
+
+    float GetCompressionRatio() const { return CompressionRatio; }
+
+    // Both directions use the dictionary from here on, it must outlive the session
+    void SetDictionary(const FLZ4Dictionary* InDictionary) { Dictionary = InDictionary; }
+    uint32 GetDictionaryId() const;
+
+    // Keys have to be in place first, granting AES256GCM expands them
+    void SetOptions(ESessionOptions InOptions);
+    ESessionOptions GetOptions() const { return Options; }
+    bool IsChecksumEnabled() const { return !EnumHasAnyFlags(Options, ESessionOptions::NoChecksum); }
+
+    // AES-256-GCM where both ends run AES in hardware, ChaCha20-Poly1305 everywhere else. Both take a 96-bit
+    // nonce and leave a 16-byte tag, so the wire layout is the same whichever suite the handshake settled on.
+    bool IsAES256GCM() const { return EnumHasAnyFlags(Options, ESessionOptions::AES256GCM); }
+    EPacketHeaderFlags GetAEADFlag() const { return IsAES256GCM() ? EPacketHeaderFlags::AEAD_AES256GCM : EPacketHeaderFlags::AEAD_ChaCha20Poly1305; }
+
+    // AES-NI and PCLMUL present, without them GCM is slower than ChaCha20 and not constant time. Needs sodium_init.
+    static bool IsAES256GCMAvailable() { return crypto_aead_aes256gcm_is_available() != 0; }
+
     uint32 GetConnectionId() const { return ConnectionId; }
     uint64 GetSeqTx() const { return SeqTx; }
     const uint8* GetTxKey() const { return TxKey; }
 
-private:
+    // Replay check alone, so the receive path can turn a stale sequence away before paying for the AEAD.
+    // The window itself only moves once a packet authenticates.
     bool IsSequenceValid(uint64 Sequence) const;
+
+private:
     void UpdateReplayWindow(uint64 Sequence);
 };
@@ -0,0 +1,129 @@
+/*
+ * SendBufferPool.h
+ *
+ * Author: Andre Ferreira
+ *
+ * Copyright (c) Uzmi Games. Licensed under the MIT License.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include <atomic>
+
+class FSendBufferPool;
+
+/**
+ * One outgoing datagram. The header, ciphertext and CRC trailer are written straight into Data,
+ * and the same bytes are then shared by the pacer queue and the reliable send window.
+ */
+struct FSendBuffer
+{
+    static constexpr int32 Capacity = 8192;
+
+    std::atomic<int32> RefCount{ 0 };
+    int32 Length = 0;
+    FSendBufferPool* Owner = nullptr;
+    alignas(16) uint8 Data[Capacity];
+};
+
+/**
+ * Reference-counted handle to a pooled send buffer. Copies share the buffer, the last handle
+ * to go away hands it back to its pool. Handles may be passed between threads.
+ */
+class TOS_NETWORK_API FSendBufferRef
+{
+public:
+    FSendBufferRef() = default;
+    FSendBufferRef(const FSendBufferRef& Other);
+    FSendBufferRef(FSendBufferRef&& Other) : Buffer(Other.Buffer) { Other.Buffer = nullptr; }
+    ~FSendBufferRef() { Reset(); }
+
+    FSendBufferRef& operator=(const FSendBufferRef& Other);
+    FSendBufferRef& operator=(FSendBufferRef&& Other);
+
+    void Reset();
+
+    FORCEINLINE bool IsValid() const { return Buffer != nullptr; }
+    FORCEINLINE uint8* GetData() { return Buffer->Data; }
+    FORCEINLINE const uint8* GetData() const { return Buffer->Data; }
+    FORCEINLINE int32 Num() const { return Buffer ? Buffer->Length : 0; }
+    FORCEINLINE void SetNum(int32 Length) { check(Length >= 0 && Length <= FSendBuffer::Capacity); Buffer->Length = Length; }
+
+private:
+    friend class FSendBufferPool;
+    explicit FSendBufferRef(FSendBuffer* InBuffer) : Buffer(InBuffer) {}
+
+    FSendBuffer* Buffer = nullptr;
+};
+
+/**
+ * Recycles send buffers so steady-state sends never touch the allocator. Acquire grows the pool
+ * when every buffer is still referenced (in flight or queued), released buffers are kept for reuse.
+ * Thread-safe. The pool must outlive every handle it gave out.
+ */
+class TOS_NETWORK_API FSendBufferPool
+{
+public:
+    static constexpr int32 DefaultReserve = 64;
+
+    FSendBufferPool() = default;
+    FSendBufferPool(const FSendBufferPool&) = delete;
+    FSendBufferPool& operator=(const FSendBufferPool&) = delete;
+    ~FSendBufferPool();
+
+    void Reserve(int32 Count);
+    FSendBufferRef Acquire();
+
+    FORCEINLINE uint64 GetAllocationCount() const { return Allocations.load(std::memory_order_relaxed); }
+
+private:
+    friend class FSendBufferRef;
+    void Release(FSendBuffer* Buffer);
+    FSendBuffer* Allocate();
+
+    FCriticalSection Lock;
+    TArray<FSendBuffer*> Buffers;
+    TArray<FSendBuffer*> FreeBuffers;
+    std::atomic<uint64> Allocations{ 0 };
+};
+
+/**
+ * FIFO of sealed datagrams waiting on the pacer. Holds references, nothing is copied.
+ * Not thread-safe.
+ */
+class TOS_NETWORK_API FSendBufferQueue
+{
+public:
+    void Push(FSendBufferRef Buffer);
+
+    // Front datagram, nullptr when empty
+    FORCEINLINE const FSendBufferRef* Peek() const { return Head < Items.Num() ? &Items[Head] : nullptr; }
+    void Pop();
+    void Reset();
+
+    FORCEINLINE bool IsEmpty() const { return Head == Items.Num(); }
+    FORCEINLINE int32 Num() const { return Items.Num() - Head; }
+    FORCEINLINE int64 GetQueuedBytes() const { return QueuedBytes; }
+
+private:
+    TArray<FSendBufferRef> Items;
+    int32 Head = 0;
+    int64 QueuedBytes = 0;
+};
@@ -31,9 +31,23 @@
 #include "HAL/Runnable.h"
 #include "HAL/RunnableThread.h"
 #include "HAL/ThreadSafeBool.h"
+#include "HAL/CriticalSection.h"
+#include "Containers/CircularQueue.h"
 #include "Network/SecureSession.h"
+#include "Network/PacketBufferPool.h"
+#include "Network/FragmentReassembler.h"
+#include "Network/LinuxUdpBatchSocket.h"
+#include "Network/FlatBuffer.h"
+#include "Network/RttEstimator.h"
+#include "Network/SendBufferPool.h"
+#include "Network/ReliableSendWindow.h"
+#include "Network/ReliableReceiveWindow.h"
+#include "Network/CongestionController.h"
+#include "Utils/LZ4.h"
+#include "Enum/NetLatencyMode.h"
+#include "Enum/ReliableStream.h"
+#include <atomic>
 
-class UFlatBuffer;
 class UDPClient;
 
 UENUM(BlueprintType)
@@ -64,7 +78,12 @@ enum class EPacketType : uint8
     Cookie              UMETA(DisplayName = "Cookie"),
     CryptoTest          UMETA(DisplayName = "CryptoTest"),
     CryptoTestAck       UMETA(DisplayName = "CryptoTestAck"),
-    ReliableHandshake   UMETA(DisplayName = "ReliableHandshake")
+    ReliableHandshake   UMETA(DisplayName = "ReliableHandshake"),
+    Batch               UMETA(DisplayName = "Batch"),
+    SessionTicket       UMETA(DisplayName = "SessionTicket"),
+    Resume              UMETA(DisplayName = "Resume"),
+    PathChallenge       UMETA(DisplayName = "PathChallenge"),
+    PathResponse        UMETA(DisplayName = "PathResponse")
   };
 
 class FPacketPollRunnable : public FRunnable
@@ -82,11 +101,12 @@ private:
 
 class UDPClient
 {
+    friend class FPacketPollRunnable;
 public:
     UDPClient();
     ~UDPClient();
 
-    std::function<void(UFlatBuffer*)> OnDataReceive;
+    std::function<void(FFlatBufferView&)> OnDataReceive;
     std::function<void(int32)> OnConnect;
     std::function<void()> OnConnectDenied;
     std::function<void()> OnConnectionError;
@@ -96,17 +116,58 @@ public:
     bool Connect(const FString& Host, int32 Port);
     void Disconnect();
     void SendAck(uint16 Sequence);
-    void Send(UFlatBuffer* buffer);
-    void SendEncrypted(UFlatBuffer* buffer, bool reliable = false);
-    void SendLegacy(UFlatBuffer* buffer);
+    void Send(FFlatBufferView& buffer, bool reliable = false, bool bFlushImmediately = false, EReliableStream Stream = EReliableStream::Default);
+    void FlushOutgoing(bool bForce = false);
+    void SendEncrypted(FFlatBufferView& buffer, bool reliable = false, EReliableStream Stream = EReliableStream::Default);
+    void SendLegacy(FFlatBufferView& buffer);
     void PollIncomingPackets();
-    void ProcessEncryptedPacket(UFlatBuffer* Buffer, int32 BytesRead, const FPacketHeader& Header);
+    void ProcessEncryptedPacket(const uint8* Data, int32 BytesRead, const FPacketHeader& Header);
+    void ProcessControlPacket(FFlatBufferView& Buffer, int32 BytesRead, bool bSigned = true);
+    FReceivePathStats GetReceiveStats() const;
     void SetConnectTimeout(float Seconds) { ConnectTimeout = Seconds; }
     void SetRetryInterval(float Seconds) { RetryInterval = Seconds; }
     void SetRetryEnabled(bool bEnabled) { bRetryEnabled = bEnabled; }
     float GetConnectTimeout() const { return ConnectTimeout; }
     float GetRetryInterval() const { return RetryInterval; }
     bool IsRetryEnabled() const { return bRetryEnabled; }
+    void SetConnectionMigrationEnabled(bool bEnabled) { bConnectionMigrationEnabled.store(bEnabled, std::memory_order_relaxed); }
+    bool IsConnectionMigrationEnabled() const { return bConnectionMigrationEnabled.load(std::memory_order_relaxed); }
+    void SetLatencyMode(ENetLatencyMode Mode) { LatencyMode.store(Mode, std::memory_order_relaxed); }
+    ENetLatencyMode GetLatencyMode() const { return LatencyMode.load(std::memory_order_relaxed); }
+    void SetSpinWaitMicroseconds(int32 Microseconds) { SpinWaitMicroseconds.store(FMath::Max(0, Microseconds), std::memory_order_relaxed); }
+    int32 GetSpinWaitMicroseconds() const { return SpinWaitMicroseconds.load(std::memory_order_relaxed); }
+    void SetBatchedIOEnabled(bool bEnabled) { bBatchedIOEnabled = bEnabled; }
+    bool IsBatchedIOEnabled() const { return bBatchedIOEnabled; }
+    bool IsBatchedIOActive() const { return BatchSocket.IsOpen(); }
+    void SetMaxPacketSize(int32 Bytes) { MaxPacketSize.store(FMath::Clamp(Bytes, MinPacketSize, MaxPacketSizeLimit), std::memory_order_relaxed); }
+    int32 GetMaxPacketSize() const { return MaxPacketSize.load(std::memory_order_relaxed); }
+    void SetReliableTimeout(float Seconds);
+    void SetMaxRetries(int32 Retries) { ReliableMaxRetries.store(FMath::Max(1, Retries), std::memory_order_relaxed); }
+    int32 GetMaxRetries() const { return ReliableMaxRetries.load(std::memory_order_relaxed); }
+    float GetSmoothedRtt() const;
+    float GetRetransmitTimeout() const;
+    void SetCongestionControl(ECongestionControl Algorithm);
+    ECongestionControl GetCongestionControl() const { return CongestionAlgorithm.load(std::memory_order_relaxed); }
+    void SetPacingEnabled(bool bEnabled);
+    bool IsPacingEnabled() const { return bPacingEnabled.load(std::memory_order_relaxed); }
+    FNetCongestionStats GetCongestionStats() const;
+    void SetCompression(bool bEnabled, int32 Threshold) { SecureSession.SetCompression(bEnabled, Threshold); }
+    void SetCompressionLevel(int32 Acceleration, int32 HighThreshold) { SecureSession.SetCompressionLevel(Acceleration, HighThreshold); }
+    float GetCompressionRatio() const { return SecureSession.GetCompressionRatio(); }
+    bool SetCompressionDictionary(const FString& Path);
+    uint32 GetCompressionDictionaryId() const { return CompressionDictionary.GetId(); }
+    void SetStreamCompressionEnabled(bool bEnabled) { bStreamCompressionEnabled.store(bEnabled, std::memory_order_relaxed); }
+    bool IsStreamCompressionEnabled() const { return bStreamCompressionEnabled.load(std::memory_order_relaxed); }
+    void SetOmitAEADChecksum(bool bEnabled) { bOmitAEADChecksum.store(bEnabled, std::memory_order_relaxed); }
+    bool IsAEADChecksumOmitted() const { return !SecureSession.IsChecksumEnabled(); }
+    void SetAES256GCMEnabled(bool bEnabled) { bAES256GCMEnabled.store(bEnabled, std::memory_order_relaxed); }
+    bool IsAES256GCMNegotiated() const { return SecureSession.IsAES256GCM(); }
+    void SetSessionResumptionEnabled(bool bEnabled);
+    bool IsSessionResumptionEnabled() const { return bSessionResumptionEnabled.load(std::memory_order_relaxed); }
+    void SetCoalescingEnabled(bool bEnabled);
+    bool IsCoalescingEnabled() const { return bCoalescingEnabled.load(std::memory_order_relaxed); }
+    void SetFlushInterval(float Seconds) { FlushInterval.store(FMath::Max(0.0f, Seconds), std::memory_order_relaxed); }
+    float GetFlushInterval() const { return FlushInterval.load(std::memory_order_relaxed); }
 
 private:
     EConnectionStatus ConnectionStatus = EConnectionStatus::Disconnected;
@@ -125,6 +186,112 @@ private:
     FSocket* Socket = nullptr;
     TSharedPtr<FInternetAddr> RemoteEndpoint;
 
+    // Linux batched transport (recvmmsg/sendmmsg + GSO/GRO), Socket stays null while it is open
+    FLinuxUdpBatchSocket BatchSocket;
+    bool bBatchedIOEnabled = true;
+    static constexpr int32 ReceiveBufferSize = 2 * 1024 * 1024;
+    bool IsTransportOpen() const { return Socket != nullptr || BatchSocket.IsOpen(); }
+    bool OpenTransport();
+    int32 SendDatagram(const uint8* Data, int32 Length);
+    void ReceiveDatagram(int32 Slot, int32 BytesRead);
+    void ProcessDatagram(uint8* Data, int32 BytesRead, bool bSigned);
+    void PollBatchedPackets();
+
+    // Connection migration: when the path breaks (a hard send error, or the server quiet for MigrationProbeTimeout)
+    // a connected client rebinds a fresh local socket and carries on under the same ConnectionId and keys. The
+    // server moves the connection once the new address echoes its path challenge. The keepalive still ends it
+    // if no path comes back. A replaced FSocket is only destroyed at the next rebind or on Disconnect, as a
+    // game thread send may still be holding it.
+    static constexpr double MigrationProbeTimeout = 11.0; // A little over two missed heartbeats at the server's default 5 s
+    static constexpr double MigrationRebindInterval = 2.0;
+    std::atomic<bool> bConnectionMigrationEnabled{ true };
+    std::atomic<bool> bMigrationRequested{ false };
+    double LastRebindTime = 0.0;
+    FSocket* RetiredSocket = nullptr;
+    void OnSendFailed();
+    void RebindTransport();
+
+    // Outbound fragmentation: encrypted payloads that would exceed MaxPacketSize are split before
+    // encryption into [Fragment][id][offset][total][chunk] pieces, each sealed as its own packet
+    static constexpr int32 MinPacketSize = 512;
+    static constexpr int32 MaxPacketSizeLimit = 8192;
+    std::atomic<int32> MaxPacketSize{ 1200 };
+    std::atomic<uint16> NextFragmentId{ 1 };
+    void SendFragmented(FFlatBufferView& buffer, bool reliable, int32 ChunkSize, EReliableStream Stream);
+    int32 GetMaxPayloadSize() const;
+
+    // Sealed datagrams live in pooled, shared buffers: the pacer queue and the reliable window hold
+    // references rather than copies. Declared ahead of both so it outlives their handles.
+    FSendBufferPool SendPool;
+    static_assert(MaxPacketSizeLimit <= FSendBuffer::Capacity, "A send buffer must hold the largest datagram");
+
+    // Outbound coalescing: game messages sent during a frame are packed per channel as
+    // [Batch]([u16 length][message])* and sealed into as few datagrams as MaxPacketSize allows.
+    // A reliable batch only ever holds messages of one stream.
+    static constexpr int32 BatchHeaderSize = 3;
+    struct FOutboundBatch
+    {
+        TFlatBuffer<MaxPacketSizeLimit> Buffer;
+        int32 Messages = 0;
+        EReliableStream Stream = EReliableStream::Default;
+    };
+    FOutboundBatch OutboundBatches[2];
+    FCriticalSection OutboundLock;
+    std::atomic<bool> bCoalescingEnabled{ true };
+    std::atomic<float> FlushInterval{ 0.0f };
+    double LastOutboundFlush = 0.0;
+    void FlushBatch(FOutboundBatch& Batch, bool reliable);
+    void ResetOutboundBatches();
+
+    // Congestion control: new reliable messages wait in PendingReliable (before encryption, so
+    // crypto sequences still leave in order) while the window is full; encrypted data datagrams
+    // then go through the pacer, which spreads them at the controller's rate. ACK-only and
+    // control packets bypass both.
+    static constexpr int32 MaxPacedQueueBytes = 256 * 1024;
+    static constexpr double LossRateGain = 1.0 / 16.0;
+    TUniquePtr<ICongestionController> Congestion;
+    std::atomic<ECongestionControl> CongestionAlgorithm{ ECongestionControl::NewReno };
+    FByteRecordQueue PendingReliable;
+    double LossRate = 0.0;
+    void EncryptAndSend(FFlatBufferView& buffer, bool reliable, EReliableStream Stream);
+    bool CanSendReliable(int32 Length) const;
+    void FlushPendingReliable();
+    void OnReliablePacketLost(FReliableSendWindow::FEntry& Entry, double Now, bool bTimeout);
+    void UpdatePacingRate();
+
+    mutable FCriticalSection PacerLock;
+    FSendPacer Pacer;
+    FSendBufferQueue PacedQueue;
+    std::atomic<bool> bPacingEnabled{ true };
+    std::atomic<double> PacingRate{ 0.0 };
+    std::atomic<int32> PacingDrops{ 0 };
+    int32 SendPaced(FSendBufferRef Packet, bool bReliable);
+    void FlushPaced();
+    void DrainPacedQueue(double Now);
+    double GetPacedReadyTime() const;
+    void ResetPacer();
+
+    // Receive path: datagrams and plaintexts live in pool slots and are recycled after dispatch
+    FPacketBufferPool ReceivePool;
+    FFragmentReassembler Reassembler;
+    FORCEINLINE FPacketBufferPool& GetPacketPool(const FPooledPacket& Packet) { return Packet.bReassembled ? Reassembler.GetPool() : ReceivePool; }
+    TSharedPtr<FInternetAddr> ReceiveSender;
+    FFlatBuffer ControlBuffer{ 64 };
+    std::atomic<uint64> DatagramsReceived{ 0 };
+    std::atomic<uint64> BytesReceived{ 0 };
+    std::atomic<uint64> PoolExhaustedDrops{ 0 };
+    std::atomic<uint64> QueueFullDrops{ 0 };
+    std::atomic<uint64> ReorderWindowDrops{ 0 };
+    void ResetReceivePath();
+    bool DecompressPacket(const uint8* Data, int32 Length, FPooledPacket& OutPacket);
+
+    // Encrypted datagrams are validated cheapest first: length and connection id, CRC32C trailer,
+    // replay window, and only then the AEAD. Each stage counts what it turned away.
+    std::atomic<uint64> MalformedDrops{ 0 };
+    std::atomic<uint64> ChecksumDrops{ 0 };
+    std::atomic<uint64> ReplayDrops{ 0 };
+    std::atomic<uint64> DecryptDrops{ 0 };
+
     FTimerHandle RetryTimerHandle;
     void StartRetryTimer();
     void StopRetryTimer();
@@ -134,6 +301,15 @@ private:
     FRunnableThread* PacketPollThread = nullptr;
     void StartPacketPollThread();
     void StopPacketPollThread();
+    bool IsInPacketPollThread() const;
+
+    // Network thread wait strategy: block on socket readiness until the next timer deadline
+    static constexpr double KeepAliveTimeout = 15.0;
+    static constexpr double MaxParkSeconds = 0.05;
+    std::atomic<ENetLatencyMode> LatencyMode{ ENetLatencyMode::Park };
+    std::atomic<int32> SpinWaitMicroseconds{ 50 };
+    double GetNextTimerDeadline() const;
+    void WaitForNetworkEvent();
 
     TArray<uint8> ClientPublicKey;
     TArray<uint8> ClientPrivateKey;
@@ -148,6 +324,49 @@ private:
     bool bEncryptionEnabled = false;
     FSecureSession SecureSession;
 
+    // Offered to the server on connect, used once ConnectionAccepted echoes its id back
+    FLZ4Dictionary CompressionDictionary;
+
+    // Reliable messages are LZ4'd against the history of their stream, see FReliableStream
+    std::atomic<bool> bStreamCompressionEnabled{ true };
+
+    // Offered on connect; the CRC32C trailer only goes once the server grants it
+    std::atomic<bool> bOmitAEADChecksum{ false };
+
+    // AES-256-GCM is only offered where libsodium finds AES-NI, anywhere else ChaCha20-Poly1305 is the faster of the two
+    std::atomic<bool> bAES256GCMEnabled{ true };
+
+    ESessionOptions GetOfferedSessionOptions() const
+    {
+        ESessionOptions Offered = bOmitAEADChecksum.load(std::memory_order_relaxed) ? ESessionOptions::NoChecksum : ESessionOptions::None;
+
+        if (bAES256GCMEnabled.load(std::memory_order_relaxed) && FSecureSession::IsAES256GCMAvailable())
+            Offered |= ESessionOptions::AES256GCM;
+
+        return Offered;
+    }
+
+    // Session resumption: once the keys are confirmed the server hands out a ticket, and the next Connect to the
+    // same endpoint presents it in place of the key exchange. A rejected ticket is answered with a cookie and
+    // the full handshake carries on from there. Tickets are single use.
+    struct FResumptionTicket
+    {
+        FString Host;
+        int32 Port = 0;
+        TArray<uint8> Ticket;
+        uint8 Secret[FSecureSession::ResumptionSecretSize];
+        double ExpiresAt = 0.0;
+    };
+    FResumptionTicket ResumptionTicket;
+    FCriticalSection ResumptionLock;
+    std::atomic<bool> bSessionResumptionEnabled{ true };
+    bool bResuming = false;
+    uint8 ResumeSecret[FSecureSession::ResumptionSecretSize];
+    uint8 ResumeNonce[FSecureSession::ResumeNonceSize];
+    bool TakeResumptionTicket(const FString& Host, int32 Port, TArray<uint8>& OutTicket);
+    void StoreResumptionTicket(const uint8* Ticket, int32 Length, uint32 LifetimeSeconds);
+    void ClearResumptionTicket();
+
     bool bClientCryptoConfirmed = false;
     bool bServerCryptoConfirmed = false;
     uint32 ClientTestValue = 0;
@@ -156,36 +375,95 @@ private:
     bool bReliableHandshakeComplete = false;
     bool IsCryptoReady() const { return bClientCryptoConfirmed && bServerCryptoConfirmed; }
     bool IsFullyConnected() const { return IsCryptoReady() && bReliableHandshakeComplete; }
+    void CompleteCryptoHandshake();
 
-    // Reliability system
-    struct FReliablePacketInfo
-    {
-        TArray<uint8> Buffer;
-        double SentTime;
-        int32 RetryCount;
-        uint64 Sequence;
-    };
+    // Retransmission timeout follows the measured round trip; ReliableTimeout only seeds it
+    FRttEstimator Rtt;
+    float ReliableTimeout = 0.25f;
+    std::atomic<int32> ReliableMaxRetries{ 10 };
 
-    TMap<uint64, FReliablePacketInfo> ReliablePackets;
+    // Selective acknowledgment: reliable plaintexts start with their own [u32 sequence], independent of
+    // the crypto sequence, and a packet flagged Acknowledgment starts with [u32 cumulative][u64 sack]
+    // where bit i acknowledges cumulative + 2 + i. ACKs are delayed to cover bursts and ride on outgoing data.
+    // The reliable sequence is followed by a [u32 stream sequence] that orders delivery within the stream
+    // named in the channel byte, so retransmission is shared while each stream only waits on its own gaps.
+    static constexpr int32 AckBlockSize = 12;
+    static constexpr int32 ReliableSequenceSize = 8;
+    static constexpr double AckDelay = 0.01;
+    static constexpr int32 FastRetransmitThreshold = 3;
+
+    // Held by EncryptAndSend from reading the crypto sequence until the datagram is handed off: the game thread
+    // sends while the network thread flushes ACKs, and a nonce must never seal twice or reach the wire out of order.
+    // Taken before ReliableLock and PacerLock, never while holding either.
+    FCriticalSection SealLock;
+
+    // Guards the send-side tracking, the RTT estimate and the pending ACK, all touched from the game and network threads
+    mutable FCriticalSection ReliableLock;
+    FReliableSendWindow ReliablePackets;
     uint64 ReliableSequenceSend = 1;
-    uint64 ReliableSequenceReceive = 0;
     uint64 UnreliableSequenceSend = 1;
+    uint64 AckSack = 0;
+    bool bAckPending = false;
+    double AckDeadline = 0.0;
+    int32 WriteAckBlock(uint8* Out);
+    void ScheduleAcknowledgment(bool bImmediate);
+    void ProcessAcknowledgment(uint32 Cumulative, uint64 Sack);
+    void ResetReliableState();
+
+    // A reliable message ran out of retries, or one already acknowledged could not be delivered: its stream can
+    // never resync, so the connection goes. Set under ReliableLock, acted on by the network loop outside of it.
+    std::atomic<bool> bReliableDeliveryFailed{ false };
+    void AbandonConnection();
+
+    // Reliable sequences received on any stream, the source of the ACK block
+    FReliableSequenceTracker ReliableReceived;
+
+    // Per-stream ordering: each stream numbers its messages and buffers its own out-of-order arrivals
+    static constexpr int32 ReliableStreamCount = static_cast<int32>(EReliableStream::Count);
+    static_assert(ReliableStreamCount <= 16, "The stream travels in the high nibble of the channel byte");
+    // The LZ4 histories follow the stream order: the encoder runs as sequences are handed out, the decoder
+    // as messages are delivered, starting with the first compressed one. Their buffers are allocated on Connect,
+    // so the first compressed message in either direction does not allocate.
+    struct FReliableStream
+    {
+        uint64 SequenceSend = 1;
+        uint64 SequenceReceive = 0;
+        FReliableReceiveWindow Window;
+        FLZ4Stream Encoder;
+        FLZ4Stream Decoder;
+        bool bDecoding = false;
+    };
+    FReliableStream ReliableStreams[ReliableStreamCount];
+
+    // Slots the stream windows pin between them, per pool. The message pool keeps the rest for the reassembler's
+    // partial messages and what the packet filling a gap needs on its way: opened, inflated and stream-decoded
+    static constexpr int32 ReorderDatagramSlots = FPacketBufferPool::DefaultSlotCount / 2;
+    static constexpr int32 ReorderMessageSlots = FFragmentReassembler::MessageSlotCount - FFragmentReassembler::MaxPendingMessages - 3;
+    static_assert(ReorderMessageSlots > 0, "The message pool leaves no room to reorder");
+    int32 ReorderHeldDatagrams = 0;
+    int32 ReorderHeldMessages = 0;
+    FORCEINLINE int32& GetReorderHeld(const FPooledPacket& Packet) { return Packet.bReassembled ? ReorderHeldMessages : ReorderHeldDatagrams; }
+    FORCEINLINE static int32 GetReorderLimit(const FPooledPacket& Packet) { return Packet.bReassembled ? ReorderMessageSlots : ReorderDatagramSlots; }
 
-    // Packet ordering buffer for reliable packets
-    TMap<uint64, TArray<uint8>> ReliablePacketBuffer;
+    bool DeliverReliablePacket(FReliableStream& Stream, uint64 Sequence, FPooledPacket Packet);
+    void EnqueueReliablePacket(FReliableStream& Stream, FPooledPacket Packet);
+    int32 EncodeStreamMessage(FReliableStream& Stream, const uint8* Message, int32 Length, uint8* Out, int32 Capacity);
+    bool DecodeStreamMessage(FReliableStream& Stream, FPooledPacket& Packet);
 
-    // Processing queues
-    TQueue<TArray<uint8>> ReliableEventQueue;
-    TQueue<TArray<uint8>> UnreliableEventQueue;
+    // Processing queues. Every queued packet pins a slot of one of the two pools, so a queue holding all of
+    // them at once can never be full and an acknowledged reliable message always has a place.
+    static constexpr uint32 EventQueueCapacity = FPacketBufferPool::DefaultSlotCount + FFragmentReassembler::MessageSlotCount;
+    TCircularQueue<FPooledPacket> ReliableEventQueue{ EventQueueCapacity + 1 };
+    TCircularQueue<FPooledPacket> UnreliableEventQueue{ EventQueueCapacity + 1 };
 
 public:
     void SendReliablePacket(const TArray<uint8>& Data);
     void SendUnreliablePacket(const TArray<uint8>& Data);
-    void ProcessReliablePacket(uint64 Sequence, const TArray<uint8>& Data);
+    void ProcessReliablePacket(uint64 Sequence, uint8 Stream, uint64 StreamSequence, FPooledPacket Packet);
     void AcknowledgeReliablePacket(uint64 Sequence);
-    void SendAcknowledgment(uint64 Sequence);
+    void FlushAcknowledgment(bool bForce = false);
     void ProcessReliableQueue();
     void ProcessUnreliableQueue();
-    void ProcessMultiplePacketsInBuffer(UFlatBuffer* Buffer);
+    void DispatchPayload(uint8* Data, int32 Length);
     void UpdateReliablePackets();
 };
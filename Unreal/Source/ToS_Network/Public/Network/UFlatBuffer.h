@@ -26,8 +26,14 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "Network/FlatBuffer.h"
 #include "UFlatBuffer.generated.h"
 
+/**
+ * Blueprint-facing wrapper around FFlatBuffer. Native code should use
+ * FFlatBuffer / FFlatBufferView / TFlatBuffer directly; GetBuffer() exposes
+ * the underlying buffer when a UFlatBuffer has to cross into native paths.
+ */
 UCLASS()
 class TOS_NETWORK_API UFlatBuffer : public UObject
 {
@@ -44,40 +50,13 @@ public:
 	void Initialize(int32 Capacity);
 
 	template<typename T>
-	void Write(const T& Value)
-	{
-		static_assert(std::is_trivial_v<T>, "Type must be trivial for unsafe operations");
-
-		int32 Size = sizeof(T);
-
-		if (Position + Size > Capacity)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("UFlatBuffer::Write - Buffer overflow. Cannot write value of size %d"), Size);
-			//throw std::runtime_error("Buffer overflow");
-			return;
-		}
-
-		FMemory::Memcpy(Data + Position, &Value, Size);
-		Position += Size;
-	}
+	FORCEINLINE void Write(const T& Value) { Buffer.Write<T>(Value); }
 
 	template<typename T>
-	T Read()
-	{
-		static_assert(std::is_trivial_v<T>, "Type must be trivial for unsafe operations");
-
-		int32 Size = sizeof(T);
+	FORCEINLINE T Read() { return Buffer.Read<T>(); }
 
-		if (Position + Size > Capacity) {
-			UE_LOG(LogTemp, Error, TEXT("UFlatBuffer::Read - Buffer underflow. Cannot read value of size %d"), Size);
-			return T{};
-		}
-
-		T Value;
-		FMemory::Memcpy(&Value, Data + Position, Size);
-		Position += Size;
-		return Value;
-	}
+	template<typename T>
+	FORCEINLINE T Peek() const { return Buffer.Peek<T>(); }
 
 	UFUNCTION(BlueprintCallable, Category = "FlatBuffer")
 	void WriteByte(uint8 Value);
@@ -194,98 +173,37 @@ public:
 	void CopyFromMemory(const uint8* SourceData, int32 Length);
     void CopyToMemory(uint8* DestData, int32 Length) const;
 
-    FORCEINLINE int32 SavePosition() const { return Position; }
-    FORCEINLINE void RestorePosition(int32 NewPos) { SetPosition(NewPos); }
-    FORCEINLINE int32 GetLengthBits() const { return (Position * 8) + WriteBitIndex; }
+    // Points the buffer at memory it does not own (e.g. a receive pool slot); no copy, no allocation
+    void SetView(uint8* Memory, int32 Length);
+
+    FORCEINLINE int32 SavePosition() const { return Buffer.GetPosition(); }
+    FORCEINLINE void RestorePosition(int32 NewPos) { Buffer.SetPosition(NewPos); }
+    FORCEINLINE int32 GetLengthBits() const { return Buffer.GetLengthBits(); }
     void WriteBytes(const uint8* Source, int32 Length);
     void ReadBytes(uint8* Dest, int32 Length);
 
-	FORCEINLINE uint8* GetData() { return Data; }
-	FORCEINLINE const uint8* GetData() const { return Data; }
-	FORCEINLINE int32 GetPosition() const { return Position; }
-	FORCEINLINE int32 GetCapacity() const { return Capacity; }
-	FORCEINLINE bool IsDisposed() const { return bDisposed; }
-	FORCEINLINE int32 Remaining() const { return Capacity - Position; }
-
-	FORCEINLINE void SetPosition(int32 NewPosition)
-	{
-		Position = FMath::Clamp(NewPosition, 0, Capacity);
-	}
-
-	uint8* GetRawBuffer() { return Data; }
-	int32 GetLength() const { return Position; }
-	int32 GetOffset() const { return Position; }
-    void SetOffset(int32 NewOffset) { SetPosition(NewOffset); }
-
-    template<typename T>
-    FORCEINLINE T Peek() const
-    {
-        static_assert(std::is_trivial_v<T>, "Type must be trivial");
-        int32 Size = sizeof(T);
-        if (Position + Size > Capacity)
-        {
-                UE_LOG(LogTemp, Error, TEXT("UFlatBuffer::Peek - Buffer underflow."));
-                return T{};
-        }
-        T Value;
-        FMemory::Memcpy(&Value, Data + Position, Size);
-        return Value;
-    }
+	FORCEINLINE uint8* GetData() { return Buffer.GetData(); }
+	FORCEINLINE const uint8* GetData() const { return Buffer.GetData(); }
+	FORCEINLINE int32 GetPosition() const { return Buffer.GetPosition(); }
+	FORCEINLINE int32 GetCapacity() const { return Buffer.GetCapacity(); }
+	FORCEINLINE bool IsDisposed() const { return Buffer.GetData() == nullptr; }
+	FORCEINLINE int32 Remaining() const { return Buffer.Remaining(); }
+	FORCEINLINE void SetPosition(int32 NewPosition) { Buffer.SetPosition(NewPosition); }
+
+	uint8* GetRawBuffer() { return Buffer.GetData(); }
+	int32 GetLength() const { return Buffer.GetLength(); }
+	int32 GetOffset() const { return Buffer.GetPosition(); }
+    void SetOffset(int32 NewOffset) { Buffer.SetPosition(NewOffset); }
+
+	FORCEINLINE FFlatBuffer& GetBuffer() { return Buffer; }
+	FORCEINLINE const FFlatBuffer& GetBuffer() const { return Buffer; }
 
 	uint32 ReadSign();
 	void PrintBuffer(const uint8* buffer, int len);
 
-	uint8* Data;
-	int32 Capacity;
-	int32 Position;
-
 protected:
 	virtual void BeginDestroy() override;
 
 private:
-    bool bDisposed;
-    uint8 WriteBits = 0;
-    uint8 WriteBitIndex = 0;
-    uint8 ReadBits = 0;
-    uint8 ReadBitIndex = 0;
-
-    void EnsureCapacity(int32 RequiredSize);
+    FFlatBuffer Buffer;
 };
-
-template<>
-inline void UFlatBuffer::Write<FVector>(const FVector& Value)
-{
-    constexpr float Factor = 0.1f;
-    Write<int16>(static_cast<int16>(FMath::RoundToInt(Value.X / Factor)));
-    Write<int16>(static_cast<int16>(FMath::RoundToInt(Value.Y / Factor)));
-    Write<int16>(static_cast<int16>(FMath::RoundToInt(Value.Z / Factor)));
-}
-
-template<>
-inline FVector UFlatBuffer::Read<FVector>()
-{
-    constexpr float Factor = 0.1f;
-    int16 X = Read<int16>();
-    int16 Y = Read<int16>();
-    int16 Z = Read<int16>();
-    return FVector(static_cast<float>(X) * Factor, static_cast<float>(Y) * Factor, static_cast<float>(Z) * Factor);
-}
-
-template<>
-inline void UFlatBuffer::Write<FRotator>(const FRotator& Value)
-{
-    constexpr float Factor = 0.1f;
-    Write<int16>(static_cast<int16>(FMath::RoundToInt(Value.Pitch / Factor)));
-    Write<int16>(static_cast<int16>(FMath::RoundToInt(Value.Yaw / Factor)));
-    Write<int16>(static_cast<int16>(FMath::RoundToInt(Value.Roll / Factor)));
-}
-
-template<>
-inline FRotator UFlatBuffer::Read<FRotator>()
-{
-    constexpr float Factor = 0.1f;
-    int16 Pitch = Read<int16>();
-    int16 Yaw = Read<int16>();
-    int16 Roll = Read<int16>();
-    return FRotator(static_cast<float>(Pitch) * Factor, static_cast<float>(Yaw) * Factor, static_cast<float>(Roll) * Factor);
-}
@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ServerPackets.h"
 #include "AckPacket.generated.h"
 
@@ -18,8 +18,8 @@ struct FAckPacket
 
     int32 GetSize() const { return 3; }
 
-    void Deserialize(UFlatBuffer* Buffer)
+    void Deserialize(FFlatBufferView& Buffer)
     {
-        Sequence = static_cast<int32>(Buffer->Read<int16>());
+        Sequence = static_cast<int32>(Buffer.Read<int16>());
     }
 };
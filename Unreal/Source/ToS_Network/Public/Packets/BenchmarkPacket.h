@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ServerPackets.h"
 #include "BenchmarkPacket.generated.h"
 
@@ -24,10 +24,10 @@ struct FBenchmarkPacket
 
     int32 GetSize() const { return 19; }
 
-    void Deserialize(UFlatBuffer* Buffer)
+    void Deserialize(FFlatBufferView& Buffer)
     {
-        Id = static_cast<int32>(Buffer->Read<uint32>());
-        Positon = Buffer->Read<FVector>();
-        Rotator = Buffer->Read<FRotator>();
+        Id = static_cast<int32>(Buffer.Read<uint32>());
+        Positon = Buffer.Read<FVector>();
+        Rotator = Buffer.Read<FRotator>();
     }
 };
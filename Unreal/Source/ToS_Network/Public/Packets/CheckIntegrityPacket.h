@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ServerPackets.h"
 #include "CheckIntegrityPacket.generated.h"
 
@@ -21,9 +21,9 @@ struct FCheckIntegrityPacket
 
     int32 GetSize() const { return 7; }
 
-    void Deserialize(UFlatBuffer* Buffer)
+    void Deserialize(FFlatBufferView& Buffer)
     {
-        Index = static_cast<int32>(Buffer->Read<uint16>());
-        Version = static_cast<int32>(Buffer->Read<uint32>());
+        Index = static_cast<int32>(Buffer.Read<uint16>());
+        Version = static_cast<int32>(Buffer.Read<uint32>());
     }
 };
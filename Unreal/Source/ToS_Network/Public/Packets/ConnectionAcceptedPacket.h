@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ServerPackets.h"
 #include "ConnectionAcceptedPacket.generated.h"
 
@@ -21,15 +21,23 @@ struct FConnectionAcceptedPacket
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     TArray<uint8> Salt;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 DictionaryId;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    uint8 Options;
+
 
-    int32 GetSize() const { return 53; }
+    int32 GetSize() const { return 58; }
 
-    void Deserialize(UFlatBuffer* Buffer)
+    void Deserialize(FFlatBufferView& Buffer)
     {
-        Id = static_cast<int32>(Buffer->Read<uint32>());
+        Id = static_cast<int32>(Buffer.Read<uint32>());
         ServerPublicKey.SetNumUninitialized(32);
-        Buffer->ReadBytes(ServerPublicKey.GetData(), 32);
+        Buffer.ReadBytes(ServerPublicKey.GetData(), 32);
         Salt.SetNumUninitialized(16);
-        Buffer->ReadBytes(Salt.GetData(), 16);
+        Buffer.ReadBytes(Salt.GetData(), 16);
+        DictionaryId = static_cast<int32>(Buffer.Read<uint32>());
+        Options = Buffer.Read<uint8>();
     }
 };
@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ServerPackets.h"
 #include "ConnectionDeniedPacket.generated.h"
 
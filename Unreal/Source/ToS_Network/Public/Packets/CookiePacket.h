@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ServerPackets.h"
 #include "CookiePacket.generated.h"
 
@@ -18,9 +18,9 @@ struct FCookiePacket
 
     int32 GetSize() const { return 49; }
 
-    void Deserialize(UFlatBuffer* Buffer)
+    void Deserialize(FFlatBufferView& Buffer)
     {
         Cookie.SetNumUninitialized(48);
-        Buffer->ReadBytes(Cookie.GetData(), 48);
+        Buffer.ReadBytes(Cookie.GetData(), 48);
     }
 };
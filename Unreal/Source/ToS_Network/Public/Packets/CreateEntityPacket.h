@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ServerPackets.h"
 #include "CreateEntityPacket.generated.h"
 
@@ -27,11 +27,11 @@ struct FCreateEntityPacket
 
     int32 GetSize() const { return 23; }
 
-    void Deserialize(UFlatBuffer* Buffer)
+    void Deserialize(FFlatBufferView& Buffer)
     {
-        EntityId = static_cast<int32>(Buffer->Read<uint32>());
-        Positon = Buffer->Read<FVector>();
-        Rotator = Buffer->Read<FRotator>();
-        Flags = static_cast<int32>(Buffer->Read<uint32>());
+        EntityId = static_cast<int32>(Buffer.Read<uint32>());
+        Positon = Buffer.Read<FVector>();
+        Rotator = Buffer.Read<FRotator>();
+        Flags = static_cast<int32>(Buffer.Read<uint32>());
     }
 };
@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ServerPackets.h"
 #include "DeltaSyncPacket.generated.h"
 
@@ -21,9 +21,9 @@ struct FDeltaSyncPacket
 
     int32 GetSize() const { return 8; }
 
-    void Deserialize(UFlatBuffer* Buffer)
+    void Deserialize(FFlatBufferView& Buffer)
     {
-        Index = static_cast<int32>(Buffer->Read<uint32>());
-        EntitiesMask = Buffer->Read<uint8>();
+        Index = static_cast<int32>(Buffer.Read<uint32>());
+        EntitiesMask = Buffer.Read<uint8>();
     }
 };
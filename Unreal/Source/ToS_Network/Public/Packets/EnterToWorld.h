@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ClientPackets.h"
 #include "EnterToWorld.generated.h"
 
@@ -18,11 +18,11 @@ struct FEnterToWorld
 
     int32 GetSize() const { return 7; }
 
-    void Serialize(UFlatBuffer* Buffer)
+    void Serialize(FFlatBufferView& Buffer)
     {
-        Buffer->WriteByte(static_cast<uint8>(EPacketType::Unreliable));
-        Buffer->WriteUInt16(static_cast<uint16>(EClientPackets::EnterToWorld));
-        Buffer->WriteUInt32(static_cast<uint32>(CharacterId));
+        Buffer.WriteByte(static_cast<uint8>(EPacketType::Unreliable));
+        Buffer.WriteUInt16(static_cast<uint16>(EClientPackets::EnterToWorld));
+        Buffer.WriteUInt32(static_cast<uint32>(CharacterId));
     }
 
 };
@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ClientPackets.h"
 #include "EnterToWorldPacket.generated.h"
 
@@ -18,11 +18,11 @@ struct FEnterToWorldPacket
 
     int32 GetSize() const { return 7; }
 
-    void Serialize(UFlatBuffer* Buffer)
+    void Serialize(FFlatBufferView& Buffer)
     {
-        Buffer->Write<uint8>(static_cast<uint8>(EPacketType::Unreliable));
-        Buffer->Write<uint16>(static_cast<uint16>(EClientPackets::EnterToWorld));
-        Buffer->Write<uint32>(static_cast<uint32>(CharacterId));
+        Buffer.Write<uint8>(static_cast<uint8>(EPacketType::Unreliable));
+        Buffer.Write<uint16>(static_cast<uint16>(EClientPackets::EnterToWorld));
+        Buffer.Write<uint32>(static_cast<uint32>(CharacterId));
     }
 
 };
@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ClientPackets.h"
 #include "PongPacket.generated.h"
 
@@ -18,10 +18,10 @@ struct FPongPacket
 
     int32 GetSize() const { return 3; }
 
-    void Serialize(UFlatBuffer* Buffer)
+    void Serialize(FFlatBufferView& Buffer)
     {
-        Buffer->Write<uint8>(static_cast<uint8>(EPacketType::Pong));
-        Buffer->Write<uint16>(static_cast<uint16>(SentTimestamp));
+        Buffer.Write<uint8>(static_cast<uint8>(EPacketType::Pong));
+        Buffer.Write<uint16>(static_cast<uint16>(SentTimestamp));
     }
 
 };
@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ServerPackets.h"
 #include "RekeyRequestPacket.generated.h"
 
@@ -21,10 +21,10 @@ struct FRekeyRequestPacket
 
     int32 GetSize() const { return 27; }
 
-    void Deserialize(UFlatBuffer* Buffer)
+    void Deserialize(FFlatBufferView& Buffer)
     {
-        CurrentSequence = Buffer->Read<int64>();
+        CurrentSequence = Buffer.Read<int64>();
         NewSalt.SetNumUninitialized(16);
-        Buffer->ReadBytes(NewSalt.GetData(), 16);
+        Buffer.ReadBytes(NewSalt.GetData(), 16);
     }
 };
@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ClientPackets.h"
 #include "RekeyResponsePacket.generated.h"
 
@@ -21,12 +21,14 @@ struct FRekeyResponsePacket
 
     int32 GetSize() const { return 12; }
 
-    void Serialize(UFlatBuffer* Buffer)
+    static constexpr EReliableStream Stream = EReliableStream::Default;
+
+    void Serialize(FFlatBufferView& Buffer)
     {
-        Buffer->Write<uint8>(static_cast<uint8>(EPacketType::Reliable));
-        Buffer->Write<uint16>(static_cast<uint16>(EClientPackets::RekeyResponse));
-        Buffer->Write<bool>(Accepted);
-        Buffer->Write<int64>(static_cast<int64>(AcknowledgedSequence));
+        Buffer.Write<uint8>(static_cast<uint8>(EPacketType::Reliable));
+        Buffer.Write<uint16>(static_cast<uint16>(EClientPackets::RekeyResponse));
+        Buffer.Write<bool>(Accepted);
+        Buffer.Write<int64>(static_cast<int64>(AcknowledgedSequence));
     }
 
 };
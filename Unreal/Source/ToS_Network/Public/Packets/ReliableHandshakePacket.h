@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ServerPackets.h"
 #include "ReliableHandshakePacket.generated.h"
 
@@ -18,8 +18,8 @@ struct FReliableHandshakePacket
 
     int32 GetSize() const { return 3601; }
 
-    void Deserialize(UFlatBuffer* Buffer)
+    void Deserialize(FFlatBufferView& Buffer)
     {
-        Message = Buffer->ReadString();
+        Message = Buffer.ReadString();
     }
 };
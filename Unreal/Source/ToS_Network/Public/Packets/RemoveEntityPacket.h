@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ServerPackets.h"
 #include "RemoveEntityPacket.generated.h"
 
@@ -18,8 +18,8 @@ struct FRemoveEntityPacket
 
     int32 GetSize() const { return 7; }
 
-    void Deserialize(UFlatBuffer* Buffer)
+    void Deserialize(FFlatBufferView& Buffer)
     {
-        EntityId = static_cast<int32>(Buffer->Read<uint32>());
+        EntityId = static_cast<int32>(Buffer.Read<uint32>());
     }
 };
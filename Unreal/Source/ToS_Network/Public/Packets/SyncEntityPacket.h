@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ClientPackets.h"
 #include "SyncEntityPacket.generated.h"
 
@@ -30,15 +30,15 @@ struct FSyncEntityPacket
 
     int32 GetSize() const { return 24; }
 
-    void Serialize(UFlatBuffer* Buffer)
+    void Serialize(FFlatBufferView& Buffer)
     {
-        Buffer->Write<uint8>(static_cast<uint8>(EPacketType::Unreliable));
-        Buffer->Write<uint16>(static_cast<uint16>(EClientPackets::SyncEntity));
-        Buffer->Write<FVector>(Positon);
-        Buffer->Write<FRotator>(Rotator);
-        Buffer->Write<FVector>(Velocity);
-        Buffer->Write<uint16>(static_cast<uint16>(AnimationState));
-        Buffer->Write<bool>(IsFalling);
+        Buffer.Write<uint8>(static_cast<uint8>(EPacketType::Unreliable));
+        Buffer.Write<uint16>(static_cast<uint16>(EClientPackets::SyncEntity));
+        Buffer.Write<FVector>(Positon);
+        Buffer.Write<FRotator>(Rotator);
+        Buffer.Write<FVector>(Velocity);
+        Buffer.Write<uint16>(static_cast<uint16>(AnimationState));
+        Buffer.Write<bool>(IsFalling);
     }
 
 };
@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ClientPackets.h"
 #include "SyncEntityQuantizedPacket.generated.h"
 
@@ -42,19 +42,19 @@ struct FSyncEntityQuantizedPacket
 
     int32 GetSize() const { return 26; }
 
-    void Serialize(UFlatBuffer* Buffer)
+    void Serialize(FFlatBufferView& Buffer)
     {
-        Buffer->Write<uint8>(static_cast<uint8>(EPacketType::Unreliable));
-        Buffer->Write<uint16>(static_cast<uint16>(EClientPackets::SyncEntityQuantized));
-        Buffer->Write<int16>(static_cast<int16>(QuantizedX));
-        Buffer->Write<int16>(static_cast<int16>(QuantizedY));
-        Buffer->Write<int16>(static_cast<int16>(QuantizedZ));
-        Buffer->Write<int16>(static_cast<int16>(QuadrantX));
-        Buffer->Write<int16>(static_cast<int16>(QuadrantY));
-        Buffer->Write<float>(Yaw);
-        Buffer->Write<FVector>(Velocity);
-        Buffer->Write<uint16>(static_cast<uint16>(AnimationState));
-        Buffer->Write<bool>(IsFalling);
+        Buffer.Write<uint8>(static_cast<uint8>(EPacketType::Unreliable));
+        Buffer.Write<uint16>(static_cast<uint16>(EClientPackets::SyncEntityQuantized));
+        Buffer.Write<int16>(static_cast<int16>(QuantizedX));
+        Buffer.Write<int16>(static_cast<int16>(QuantizedY));
+        Buffer.Write<int16>(static_cast<int16>(QuantizedZ));
+        Buffer.Write<int16>(static_cast<int16>(QuadrantX));
+        Buffer.Write<int16>(static_cast<int16>(QuadrantY));
+        Buffer.Write<float>(Yaw);
+        Buffer.Write<FVector>(Velocity);
+        Buffer.Write<uint16>(static_cast<uint16>(AnimationState));
+        Buffer.Write<bool>(IsFalling);
     }
 
 };
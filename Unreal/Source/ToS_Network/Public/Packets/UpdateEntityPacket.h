@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ServerPackets.h"
 #include "UpdateEntityPacket.generated.h"
 
@@ -33,13 +33,13 @@ struct FUpdateEntityPacket
 
     int32 GetSize() const { return 31; }
 
-    void Deserialize(UFlatBuffer* Buffer)
+    void Deserialize(FFlatBufferView& Buffer)
     {
-        EntityId = static_cast<int32>(Buffer->Read<uint32>());
-        Positon = Buffer->Read<FVector>();
-        Rotator = Buffer->Read<FRotator>();
-        Velocity = Buffer->Read<FVector>();
-        AnimationState = static_cast<int32>(Buffer->Read<uint16>());
-        Flags = static_cast<int32>(Buffer->Read<uint32>());
+        EntityId = static_cast<int32>(Buffer.Read<uint32>());
+        Positon = Buffer.Read<FVector>();
+        Rotator = Buffer.Read<FRotator>();
+        Velocity = Buffer.Read<FVector>();
+        AnimationState = static_cast<int32>(Buffer.Read<uint16>());
+        Flags = static_cast<int32>(Buffer.Read<uint32>());
     }
 };
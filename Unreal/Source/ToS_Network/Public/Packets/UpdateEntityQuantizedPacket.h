@@ -3,7 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Network/UDPClient.h"
-#include "Network/UFlatBuffer.h"
+#include "Network/FlatBuffer.h"
 #include "Network/ServerPackets.h"
 #include "UpdateEntityQuantizedPacket.generated.h"
 
@@ -45,17 +45,17 @@ struct FUpdateEntityQuantizedPacket
 
     int32 GetSize() const { return 33; }
 
-    void Deserialize(UFlatBuffer* Buffer)
+    void Deserialize(FFlatBufferView& Buffer)
     {
-        EntityId = static_cast<int32>(Buffer->Read<uint32>());
-        QuantizedX = static_cast<int32>(Buffer->Read<int16>());
-        QuantizedY = static_cast<int32>(Buffer->Read<int16>());
-        QuantizedZ = static_cast<int32>(Buffer->Read<int16>());
-        QuadrantX = static_cast<int32>(Buffer->Read<int16>());
-        QuadrantY = static_cast<int32>(Buffer->Read<int16>());
-        Yaw = Buffer->Read<float>();
-        Velocity = Buffer->Read<FVector>();
-        AnimationState = static_cast<int32>(Buffer->Read<uint16>());
-        Flags = static_cast<int32>(Buffer->Read<uint32>());
+        EntityId = static_cast<int32>(Buffer.Read<uint32>());
+        QuantizedX = static_cast<int32>(Buffer.Read<int16>());
+        QuantizedY = static_cast<int32>(Buffer.Read<int16>());
+        QuantizedZ = static_cast<int32>(Buffer.Read<int16>());
+        QuadrantX = static_cast<int32>(Buffer.Read<int16>());
+        QuadrantY = static_cast<int32>(Buffer.Read<int16>());
+        Yaw = Buffer.Read<float>();
+        Velocity = Buffer.Read<FVector>();
+        AnimationState = static_cast<int32>(Buffer.Read<uint16>());
+        Flags = static_cast<int32>(Buffer.Read<uint32>());
     }
 };
@@ -1,22 +1,39 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include <atomic>
 
 class FCRC32C
 {
 public:
-    static uint32 Compute(const uint8* Data, int32 Length);
+    static uint32 Compute(const uint8* Data, int32 Length)
+    {
+        return Finalize(Update(Initial, Data, Length));
+    }
 
-private:
-    static const uint32 Polynomial = 0x82F63B78u;
-    static uint32 Table[16 * 256];
-    static bool bTableInitialized;
-    static void InitializeTable();
+    // Incremental form, Finalize(Update(Update(Initial, A), B)) equals Compute over A followed by B,
+    // so a header and its payload can be checksummed where they lie
+    static constexpr uint32 Initial = 0xFFFFFFFFu;
+
+    static uint32 Update(uint32 State, const uint8* Data, int32 Length)
+    {
+        return Kernel.load(std::memory_order_relaxed)(State, Data, Length);
+    }
 
-    static bool HasSSE42();
-    static bool HasARMCRC();
+    static constexpr uint32 Finalize(uint32 State)
+    {
+        return State ^ 0xFFFFFFFFu;
+    }
+
+private:
+    // Resolved once: starts on a trampoline that probes the CPU and swaps in the best kernel
+    using FKernel = uint32 (*)(uint32 State, const uint8* Data, int32 Length);
+    static std::atomic<FKernel> Kernel;
+    static FKernel Resolve();
+    static uint32 ResolveAndUpdate(uint32 State, const uint8* Data, int32 Length);
 
-    static uint32 ComputeSSE42(const uint8* Data, int32 Length, uint32 crcLocal);
-    static uint32 ComputeARMCRC(const uint8* Data, int32 Length, uint32 crcLocal);
-    static uint32 ComputeFallback(const uint8* Data, int32 Length, uint32 crcLocal);
+    static uint32 UpdateSSE42(uint32 State, const uint8* Data, int32 Length);
+    static uint32 UpdateSSE42Interleaved(uint32 State, const uint8* Data, int32 Length);
+    static uint32 UpdateARMCRC(uint32 State, const uint8* Data, int32 Length);
+    static uint32 UpdateFallback(uint32 State, const uint8* Data, int32 Length);
 };
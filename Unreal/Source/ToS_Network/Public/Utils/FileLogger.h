@@ -5,3 +5,4 @@
 // Global functions for logging to file
 void ClientFileLog(const FString& Message);
 void ClientFileLogHex(const FString& Prefix, const TArray<uint8>& Data);
+void ClientFileLogHex(const FString& Prefix, const uint8* Data, int32 Length);
@@ -2,14 +2,160 @@
 
 #include "CoreMinimal.h"
 
+/**
+ * Shared LZ4 dictionary. Both peers preload the same bytes as match history, so packets too short
+ * to repeat themselves can still reference content seen across earlier traffic. The id is the
+ * CRC32C of the contents and is what the handshake negotiates, 0 means no dictionary.
+ */
+class FLZ4Dictionary
+{
+public:
+    // Only the tail within reach of the 16 bit match offset is kept
+    static constexpr int32 MaxSize = 0xFFFF - 1;
+
+    bool Load(const uint8* InData, int32 Size);
+    bool LoadFromFile(const FString& Path);
+    void Reset();
+
+    FORCEINLINE bool IsValid() const { return Id != 0; }
+    FORCEINLINE uint32 GetId() const { return Id; }
+    FORCEINLINE const uint8* GetData() const { return Data.GetData(); }
+    FORCEINLINE int32 Num() const { return Data.Num(); }
+
+private:
+    friend class FLZ4;
+
+    TArray<uint8> Data;
+    TArray<uint32> HashTable; // Last position + 1 of each hashed sequence, 0 when empty
+    uint32 Id = 0;
+};
+
+/**
+ * How hard FLZ4::Compress looks for matches, picked per call so one sender can favour latency on small
+ * packets and ratio on bulk payloads. Fast probes a single hash slot per position and, with an
+ * Acceleration above 1, widens its step sooner over literal runs so incompressible input is skimmed
+ * instead of scanned. High walks a hash chain of up to SearchDepth earlier positions and looks one byte
+ * ahead before committing to a match: several times slower, noticeably smaller.
+ */
+struct FLZ4Level
+{
+    static constexpr int32 MaxAcceleration = 256;
+    static constexpr int32 DefaultSearchDepth = 64;
+
+    int32 Acceleration = 1;
+    int32 SearchDepth = 0; // 0 selects the fast match finder
+
+    static FLZ4Level Fast(int32 Acceleration = 1) { FLZ4Level Level; Level.Acceleration = Acceleration; return Level; }
+    static FLZ4Level High(int32 SearchDepth = DefaultSearchDepth) { FLZ4Level Level; Level.SearchDepth = FMath::Max(1, SearchDepth); return Level; }
+
+    FORCEINLINE bool IsHigh() const { return SearchDepth > 0; }
+};
+
+/**
+ * Match finder tables for FLZ4::Compress, owned by the caller and reused across blocks. Entries hold a
+ * running offset rather than positions within one block, so starting a block only moves the offset
+ * past the previous one and anything older reads as empty; the tables are cleared only when the offset
+ * is about to wrap. The hash chain the High level needs is allocated the first time it runs. Not thread-safe.
+ */
+class FLZ4CompressState
+{
+public:
+    void Reset();
+
+private:
+    friend class FLZ4;
+
+    static constexpr uint32 MaxOrigin = 1u << 30;
+
+    // Returns the offset of Src[0] for a block of Size bytes, allocating or clearing the tables as needed
+    uint32 Begin(int32 Size, bool bChain);
+
+    TArray<uint32> HashTable;  // Offset of the last position with each hash, below the current block's means empty
+    TArray<uint16> ChainTable; // High only: distance back to the previous position with the same hash, by offset & 0xFFFF
+    uint32 Origin = 1;         // Offset the next block starts at
+};
+
+class FLZ4Stream;
+
 class FLZ4
 {
 public:
-    static int32 Compress(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity);
+    // Without a state of its own, the calling thread's is used
+    static int32 Compress(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, FLZ4Level Level = FLZ4Level());
+    static int32 Compress(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, FLZ4CompressState& State, FLZ4Level Level = FLZ4Level());
     static int32 Decompress(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity);
 
+    // The dictionary is treated as the data immediately preceding Src / Dst, both peers must hold the same one
+    static int32 CompressWithDictionary(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, const FLZ4Dictionary& Dictionary,
+                                        FLZ4Level Level = FLZ4Level());
+    static int32 CompressWithDictionary(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, const FLZ4Dictionary& Dictionary,
+                                        FLZ4CompressState& State, FLZ4Level Level = FLZ4Level());
+    static int32 DecompressWithDictionary(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, const FLZ4Dictionary& Dictionary);
+
 private:
+    friend class FLZ4Dictionary;
+    friend class FLZ4CompressState;
+    friend class FLZ4Stream;
+
     static constexpr int MINMATCH = 4;
     static constexpr int HASH_LOG = 16;
     static constexpr int HASH_SIZE = 1 << HASH_LOG;
+
+    static FORCEINLINE uint32 Hash(uint32 V) { return (V * 2654435761u) >> ((MINMATCH * 8) - HASH_LOG); }
+
+    static int32 CompressBlock(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, const FLZ4Dictionary* Dictionary,
+                               FLZ4CompressState& State, FLZ4Level Level);
+    static int32 CompressFast(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, const FLZ4Dictionary* Dictionary,
+                              FLZ4CompressState& State, int32 Acceleration);
+    static int32 CompressHigh(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, const FLZ4Dictionary* Dictionary,
+                              FLZ4CompressState& State, int32 SearchDepth);
+    static int32 DecompressBlock(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity, const uint8* DictEnd, int32 DictSize);
+};
+
+/**
+ * LZ4 over an ordered channel: every message joins a sliding 64 KB history the following messages
+ * can match against, so payloads repeated across packets shrink to a few bytes. The encoder keeps
+ * its hash table between calls instead of rebuilding it per message. Both ends must process the
+ * same messages in the same order, but since offsets are relative an encoder holding only a suffix
+ * of the decoder's history (fresh, or Reset on its own) still decodes correctly. Not thread-safe.
+ */
+class FLZ4Stream
+{
+public:
+    static constexpr int32 HistorySize = 64 * 1024;
+    static constexpr int32 MaxMessageSize = 64 * 1024;
+
+    void Reset();
+
+    // Allocates the history, and the hash table of an encoder, ahead of the first message. Reset keeps both.
+    void Allocate(bool bEncoder);
+
+    // Encoder. Src always joins the history; returns 0 when the result does not fit DstCapacity
+    int32 Compress(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity);
+
+    // Decoder. The message written to Dst joins the history; returns 0 on malformed input
+    int32 Decompress(const uint8* Src, int32 SrcSize, uint8* Dst, int32 DstCapacity);
+
+    // Decoder, decoding straight into the history. The view is valid until the next call; nullptr on malformed input
+    const uint8* Decompress(const uint8* Src, int32 SrcSize, int32& OutLength);
+
+    // Decoder, for messages of the stream that travelled uncompressed
+    void Append(const uint8* Data, int32 Size);
+
+    FORCEINLINE int32 GetHistoryLength() const { return FMath::Min(Position, HistorySize); }
+    FORCEINLINE uint32 GetAllocationCount() const { return Allocations; }
+
+private:
+    static constexpr int HASH_LOG = 12;
+    static constexpr int HASH_SIZE = 1 << HASH_LOG;
+
+    static FORCEINLINE uint32 Hash(uint32 V) { return (V * 2654435761u) >> ((FLZ4::MINMATCH * 8) - HASH_LOG); }
+
+    // Slides the history to the front of the buffer when Size more bytes would not fit behind it
+    uint8* Reserve(int32 Size);
+
+    TArray<uint8> Buffer;     // [history][message being processed], allocated by Allocate or on first use
+    TArray<uint32> HashTable; // Encoder only, buffer position + 1 of each hashed sequence
+    int32 Position = 0;       // End of the history within Buffer
+    uint32 Allocations = 0;   // Heap allocations made for Buffer and HashTable
 };